@@ -0,0 +1,158 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <corn/core/scene.h>
+#include <corn/ecs/component.h>
+#include <corn/ecs/entity_manager.h>
+#include <corn/ecs/integration.h>
+#include <corn/ecs/system.h>
+#include <corn/geometry/deg.h>
+#include <corn/geometry/operations.h>
+#include <corn/geometry/vec2.h>
+#include <corn/util/stopwatch.h>
+
+using namespace corn;
+
+/**
+ * @brief A body stored as an object, integrated one at a time like the per-entity systems used to.
+ *
+ * The world rotation of the parent is cached, like in the nodes of the entity manager.
+ */
+struct Body {
+    Vec2 location;
+    Deg rotation;
+    Vec2 velocity;
+    float angularVelocity;
+    float gravityScale;
+    float parentSin;
+    float parentCos;
+};
+
+/// @brief Fills the bodies and the batch with the same random values.
+void generate(size_t size, std::vector<Body>& bodies, MotionBatch& batch) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+    bodies.resize(size);
+    batch.resize(size);
+    for (size_t i = 0; i < size; i++) {
+        Body& body = bodies[i];
+        Deg parentRotation = angle(rng);
+        body = { Vec2(dist(rng), dist(rng)), angle(rng), Vec2(dist(rng), dist(rng)), dist(rng), 1.0f,
+                 parentRotation.sin(), parentRotation.cos() };
+        batch.x[i] = body.location.x;
+        batch.y[i] = body.location.y;
+        batch.rotation[i] = body.rotation.get();
+        batch.vx[i] = body.velocity.x;
+        batch.vy[i] = body.velocity.y;
+        batch.angularVelocity[i] = body.angularVelocity;
+        batch.gravityScale[i] = body.gravityScale;
+        batch.parentSin[i] = body.parentSin;
+        batch.parentCos[i] = body.parentCos;
+    }
+}
+
+/// @brief A scene without any logic of its own.
+class BenchmarkScene : public Scene {};
+
+/// @brief The per-entity movement and gravity systems, as they were before the batch kernels.
+void updatePerEntity(EntityManager& entityManager, float g, float millis) {
+    entityManager.forEachParallel<CMovement2D, const CGravity2D>(
+            [g, millis](Entity&, CMovement2D& movement, const CGravity2D& gravity2D) {
+                if (!movement.active || !gravity2D.active) return;
+                movement.addWorldVelocityOffset(Vec2(0, g * gravity2D.scale * (millis / 1000.0f)));
+            });
+    entityManager.forEachParallel<CTransform2D, const CMovement2D>(
+            [millis](Entity&, CTransform2D& transform, const CMovement2D& movement) {
+                if (!transform.active || !movement.active) return;
+                transform.addWorldLocationOffset(movement.getVelocity() * (millis / 1000.0f));
+                transform.setRotation(transform.getRotation() + movement.getAngularVelocity() * (millis / 1000.0f));
+            });
+}
+
+/// @brief Fills the scene with the same random bodies as the batch.
+void populate(EntityManager& entityManager, const std::vector<Body>& bodies) {
+    for (const Body& body : bodies) {
+        Entity& entity = entityManager.createEntity("body");
+        entity.addComponent<CTransform2D>(body.location, body.rotation);
+        entity.addComponent<CMovement2D>(body.velocity, body.angularVelocity);
+        entity.addComponent<CGravity2D>(body.gravityScale);
+    }
+}
+
+/// @return Nanoseconds per body per step, averaged over the steps.
+template <typename Func>
+double measure(size_t size, size_t steps, Func func) {
+    Stopwatch stopwatch;
+    stopwatch.play();
+    for (size_t step = 0; step < steps; step++) {
+        func();
+    }
+    stopwatch.pause();
+    return stopwatch.millis() * 1e6 / (double)(size * steps);
+}
+
+int main() {
+    constexpr float g = 2000.0f;
+    constexpr float millis = 16.0f;
+    std::printf("%10s %12s %12s %12s %12s %10s\n", "bodies", "objects", "scalar", "sse2", "avx2", "speedup");
+
+    for (size_t size : { 10000, 100000, 1000000 }) {
+        size_t steps = 20000000 / size;
+        std::vector<Body> bodies;
+        MotionBatch batch;
+        generate(size, bodies, batch);
+
+        double objects = measure(size, steps, [&]() {
+            for (Body& body : bodies) {
+                Vec2 offset = Vec2(0, g * body.gravityScale * (millis / 1000.0f));
+                body.velocity += rotate(offset, -body.parentSin, body.parentCos);
+                offset = body.velocity * (millis / 1000.0f);
+                body.location += rotate(offset, -body.parentSin, body.parentCos);
+                body.rotation = body.rotation + body.angularVelocity * (millis / 1000.0f);
+            }
+        });
+        double results[3];
+        for (SimdLevel level : { SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2 }) {
+            results[(size_t)level] = measure(size, steps, [&]() {
+                integrateGravity(batch, g, millis / 1000.0f, level);
+                integrateMovement(batch, millis / 1000.0f, level);
+            });
+        }
+
+        double best = results[(size_t)getSimdLevel()];
+        std::printf("%10zu %9.2f ns %9.2f ns %9.2f ns %9.2f ns %9.1fx\n",
+                    size, objects, results[0], results[1], results[2], objects / best);
+    }
+
+    // End to end through the entity manager, including the queries, the gather and scatter, and the cache refresh
+    std::printf("\n%10s %12s %12s %10s\n", "entities", "per-entity", "systems", "speedup");
+    for (size_t size : { 10000, 100000, 1000000 }) {
+        size_t steps = 2000000 / size;
+        std::vector<Body> bodies;
+        MotionBatch batch;
+        generate(size, bodies, batch);
+
+        BenchmarkScene baselineScene;
+        EntityManager& baselineManager = baselineScene.getEntityManager();
+        populate(baselineManager, bodies);
+        double perEntity = measure(size, steps, [&]() {
+            updatePerEntity(baselineManager, g, millis);
+            baselineManager.tidy();
+        });
+
+        BenchmarkScene systemScene;
+        EntityManager& systemManager = systemScene.getEntityManager();
+        populate(systemManager, bodies);
+        SGravity gravity(systemScene, g);
+        SMovement2D movement(systemScene);
+        double systems = measure(size, steps, [&]() {
+            gravity.update(millis);
+            movement.update(millis);
+            systemManager.tidy();
+        });
+
+        std::printf("%10zu %9.2f ns %9.2f ns %9.1fx\n", size, perEntity, systems, perEntity / systems);
+    }
+    return 0;
+}
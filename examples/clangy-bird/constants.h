@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <corn/util.h>
 
 constexpr size_t WIDTH = 1280;
@@ -17,5 +18,9 @@ constexpr float WALL_SPEED = 200.0f;
 constexpr float WALL_INTERVAL = 300.0f;
 const corn::Color WALL_COLOR = corn::Color::rgb(50, 205, 50);
 
+// Collision layers. The bird only collides with obstacles, and obstacles only collide with the bird.
+constexpr uint32_t BIRD_LAYER = 1 << 0;
+constexpr uint32_t OBSTACLE_LAYER = 1 << 1;
+
 constexpr size_t HOLE_MIN_PADDING = 120;
 constexpr size_t HOLE_SIZE = 260;
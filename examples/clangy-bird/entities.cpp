@@ -1,4 +1,5 @@
 #include <random>
+#include <utility>
 #include <corn/media.h>
 #include "components.h"
 #include "constants.h"
@@ -26,7 +27,7 @@ corn::Entity* createBird(corn::EntityManager& entityManager) {
     bird->addComponent<corn::CGravity2D>();
     corn::Vec2 bottomRight = corn::Vec2(BIRD_WIDTH * 0.5, BIRD_HEIGHT * 0.5);
     corn::Vec2 topLeft = -bottomRight;
-    bird->addComponent<corn::CBBox>(topLeft, bottomRight);
+    bird->addComponent<corn::CBBox>(topLeft, bottomRight, BIRD_LAYER, OBSTACLE_LAYER);
     bird->addComponent<corn::CSprite>(
             new corn::Image(BIRD_WIDTH, BIRD_HEIGHT, BIRD_COLOR), topLeft);
 
@@ -36,7 +37,36 @@ corn::Entity* createBird(corn::EntityManager& entityManager) {
     return bird;
 }
 
-corn::Entity* createWall(corn::EntityManager& entityManager, float x) {
+corn::Prefab createWallPrefab() {
+    corn::Prefab wall("wall");
+    size_t top = wall.addChild("top");
+    size_t bottom = wall.addChild("bottom");
+
+    // Components of base node
+    wall.addComponent<corn::CTransform2D>(corn::Prefab::ROOT, corn::Vec2::ZERO());
+    wall.addComponent<corn::CMovement2D>(corn::Prefab::ROOT, corn::Vec2(-WALL_SPEED, 0));
+    wall.addComponent<Wall>(corn::Prefab::ROOT);
+
+    // Components of top and bottom walls (sizes are set when the wall is placed)
+    wall.addComponent<corn::CTransform2D>(top, corn::Vec2::ZERO());
+    wall.addComponent<corn::CBBox>(top, corn::Vec2::ZERO(), corn::Vec2::ZERO(), OBSTACLE_LAYER, BIRD_LAYER);
+    wall.addComponent<corn::CTransform2D>(bottom, corn::Vec2::ZERO());
+    wall.addComponent<corn::CBBox>(bottom, corn::Vec2::ZERO(), corn::Vec2::ZERO(), OBSTACLE_LAYER, BIRD_LAYER);
+    return wall;
+}
+
+/// Resizes the wall's bounding box and sprite. The sprite is kept when the wall is recycled.
+static void resizeWall(corn::Entity& entity, float height) {
+    entity.getComponent<corn::CBBox>()->br = corn::Vec2(WALL_THICKNESS, height);
+    corn::Image image((unsigned int)WALL_THICKNESS, (unsigned int)height, WALL_COLOR);
+    if (auto* sprite = entity.getComponent<corn::CSprite>()) {
+        *sprite->image = std::move(image);
+    } else {
+        entity.addComponent<corn::CSprite>(new corn::Image(std::move(image)));
+    }
+}
+
+corn::Entity* createWall(corn::PrefabPool& wallPool, float x) {
     // Randomize hole location
     static std::random_device rd;
     static std::mt19937 gen(rd());
@@ -45,26 +75,15 @@ corn::Entity* createWall(corn::EntityManager& entityManager, float x) {
     float bottomWallSize = HEIGHT - topWallSize - HOLE_SIZE;
 
     // Entities
-    corn::Entity* wall = &entityManager.createEntity("wall");
-    corn::Entity* top = &entityManager.createEntity("top", wall);
-    corn::Entity* bottom = &entityManager.createEntity("bottom", wall);
-
-    // Components of base node
-    wall->addComponent<corn::CTransform2D>(corn::Vec2(x, 0));
-    wall->addComponent<corn::CMovement2D>(corn::Vec2(-WALL_SPEED, 0));
-    wall->addComponent<Wall>();
-
-    // Components of top wall
-    top->addComponent<corn::CTransform2D>(corn::Vec2::ZERO());
-    top->addComponent<corn::CBBox>(corn::Vec2::ZERO(), corn::Vec2(WALL_THICKNESS, topWallSize));
-    top->addComponent<corn::CSprite>(new corn::Image(
-            (unsigned int)WALL_THICKNESS, (unsigned int)topWallSize, WALL_COLOR));
+    corn::Entity* wall = &wallPool.acquire();
+    corn::EntityManager& entityManager = wall->getEntityManager();
+    corn::Entity* top = entityManager.getEntityByName("top", wall, false);
+    corn::Entity* bottom = entityManager.getEntityByName("bottom", wall, false);
 
-    // Components of bottom wall
-    bottom->addComponent<corn::CTransform2D>(corn::Vec2(0, topWallSize + HOLE_SIZE));
-    bottom->addComponent<corn::CBBox>(corn::Vec2::ZERO(), corn::Vec2(WALL_THICKNESS, bottomWallSize));
-    bottom->addComponent<corn::CSprite>(new corn::Image(
-            (unsigned int)WALL_THICKNESS, (unsigned int)bottomWallSize, WALL_COLOR));
+    wall->getComponent<corn::CTransform2D>()->setLocation(corn::Vec2(x, 0));
+    resizeWall(*top, topWallSize);
+    bottom->getComponent<corn::CTransform2D>()->setLocation(corn::Vec2(0, topWallSize + HOLE_SIZE));
+    resizeWall(*bottom, bottomWallSize);
 
     return wall;
 }
@@ -76,13 +95,13 @@ void createCeilAndFloor(corn::EntityManager& entityManager) {
     // Components of ceil
     auto ceilTransform = ceil->addComponent<corn::CTransform2D>(corn::Vec2::ZERO());
     ceilTransform->setZOrder(1);
-    ceil->addComponent<corn::CBBox>(corn::Vec2::ZERO(), corn::Vec2(WIDTH, CEIL_THICKNESS));
+    ceil->addComponent<corn::CBBox>(corn::Vec2::ZERO(), corn::Vec2(WIDTH, CEIL_THICKNESS), OBSTACLE_LAYER, BIRD_LAYER);
     ceil->addComponent<corn::CSprite>(new corn::Image(WIDTH, CEIL_THICKNESS, CEIL_COLOR));
 
     // Components of floor
     auto floorTransform = floor->addComponent<corn::CTransform2D>(
             corn::Vec2(0, HEIGHT - CEIL_THICKNESS));
     floorTransform->setZOrder(1);
-    floor->addComponent<corn::CBBox>(corn::Vec2::ZERO(), corn::Vec2(WIDTH, CEIL_THICKNESS));
+    floor->addComponent<corn::CBBox>(corn::Vec2::ZERO(), corn::Vec2(WIDTH, CEIL_THICKNESS), OBSTACLE_LAYER, BIRD_LAYER);
     floor->addComponent<corn::CSprite>(new corn::Image(WIDTH, CEIL_THICKNESS, CEIL_COLOR));
 }
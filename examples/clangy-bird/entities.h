@@ -4,5 +4,6 @@
 
 corn::Entity* createCamera(corn::EntityManager& entityManager);
 corn::Entity* createBird(corn::EntityManager& entityManager);
-corn::Entity* createWall(corn::EntityManager& entityManager, float x);
+corn::Prefab createWallPrefab();
+corn::Entity* createWall(corn::PrefabPool& wallPool, float x);
 void createCeilAndFloor(corn::EntityManager& entityManager);
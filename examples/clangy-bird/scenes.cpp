@@ -343,7 +343,7 @@ void GameScene::onKeyboardEvent(const corn::EventArgsKeyboard& args) {
         case corn::Key::UP:
         case corn::Key::SPACE:
             if (!this->paused_) {
-                this->birdMovement_->velocity.y = -700;
+                this->birdMovement_->setVelocity(corn::Vec2(this->birdMovement_->getVelocity().x, -700));
             }
             break;
         case corn::Key::ESC:
@@ -355,6 +355,6 @@ void GameScene::onKeyboardEvent(const corn::EventArgsKeyboard& args) {
 
 void GameScene::onMouseEvent(const corn::EventArgsMouseButton& args) {
     if (!this->paused_ && args.mouse == corn::Mouse::LEFT && args.status == corn::ButtonEvent::DOWN) {
-        this->birdMovement_->velocity.y = -700;
+        this->birdMovement_->setVelocity(corn::Vec2(this->birdMovement_->getVelocity().x, -700));
     }
 }
@@ -1,18 +1,23 @@
+#include <ranges>
 #include "components.h"
 #include "constants.h"
 #include "scenes.h"
 #include "systems.h"
 
-WallManager::WallManager(corn::Scene& scene) : corn::System(scene) {}
+WallManager::WallManager(corn::Scene& scene)
+        : corn::System(scene), wallPool_(createWallPrefab(), scene.getEntityManager()) {}
 
 void WallManager::update(float) {
     bool needNewWall = true;
     // Iterate over existing walls
-    for (corn::Entity* entity : this->getScene().getEntityManager().getEntitiesWith<Wall>()) {
+    auto walls = this->getScene().getEntityManager().activeView() | std::views::filter([](const corn::Entity* entity) {
+        return entity->hasComponents<Wall>();
+    });
+    for (corn::Entity* entity : walls) {
         auto* transform = entity->getComponent<corn::CTransform2D>();
         float locationX = transform->getWorldTransform().first.x;
         if ((locationX + WALL_THICKNESS) < 0) {
-            entity->destroy();
+            this->wallPool_.release(*entity);
         }
         if (WIDTH - (locationX + WALL_THICKNESS) < WALL_INTERVAL) {
             needNewWall = false;
@@ -20,7 +25,7 @@ void WallManager::update(float) {
     }
     // Create new wall
     if (needNewWall) {
-        createWall(this->getScene().getEntityManager(), WIDTH);
+        createWall(this->wallPool_, WIDTH);
     }
 }
 
@@ -37,9 +42,9 @@ BirdCollisionResolve::BirdCollisionResolve(corn::Scene& scene) : corn::System(sc
 
 BirdCollisionResolve::~BirdCollisionResolve() = default;
 
-void BirdCollisionResolve::resolve(const corn::EventArgsCollision& args) {
+void BirdCollisionResolve::resolve(const corn::EventArgsCollision&) {
+    // Only the bird and the obstacles interact (see the collision layers), so every collision ends the game
     if (this->hasCollided_) return;
-    if (args.collider1->getEntity().getName() != "bird" && args.collider2->getEntity().getName() != "bird") return;
     this->hasCollided_ = true;
     corn::EventManager::instance().emit(corn::EventArgsScene(
             corn::SceneOperation::REPLACE, new GameScene()));
@@ -10,6 +10,10 @@ class WallManager : public corn::System {
 public:
     explicit WallManager(corn::Scene& scene);
     void update(float millis) override;
+
+private:
+    /// Walls are recycled instead of destroyed once they leave the screen
+    corn::PrefabPool wallPool_;
 };
 
 /// A custom collision resolve system for bird
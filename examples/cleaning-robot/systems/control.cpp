@@ -2,6 +2,7 @@
 #include <corn/ecs/component.h>
 #include <corn/ecs/entity_manager.h>
 #include <corn/event/event_args.h>
+#include <corn/event/event_manager.h>
 #include "control.h"
 
 SControl::SControl(corn::Scene& scene, corn::Entity::EntityID robotID)
@@ -56,5 +57,5 @@ void SControl::updateMovement() {
     this->getScene()
             .getEntityManager()
             .getEntityByID(this->robotID_)
-            ->getComponent<corn::CMovement2D>()->velocity = velocity * this->speed_;
+            ->getComponent<corn::CMovement2D>()->setVelocity(velocity * this->speed_);
 }
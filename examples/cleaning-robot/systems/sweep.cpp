@@ -24,16 +24,16 @@ void SSweep::update(float millis) {
         }
 
         // Skip if the object is not moving
-        if (movement->velocity.norm() == 0) {
+        if (movement->getVelocity().norm() == 0) {
             continue;
         }
 
         // Sweep the object
-        corn::Vec2 displacement = movement->velocity * (millis * 0.001f);
+        corn::Vec2 displacement = movement->getVelocity() * (millis * 0.001f);
         corn::Polygon newSweepRegion = polygonSweep(object->polygon, displacement);
 
         // Merge the swept region with the sweep object
-        newSweepRegion.translate(transform->location);
+        newSweepRegion.translate(transform->getLocation());
         std::vector<corn::Polygon> temp = polygonUnion(sweepRegion->polygon, newSweepRegion);
         if (temp.empty()) {
             continue;
@@ -41,6 +41,6 @@ void SSweep::update(float millis) {
         sweepRegion->polygon = std::move(temp[0]);
 
         // Move the object
-        transform->location += displacement;
+        transform->setLocation(transform->getLocation() + displacement);
     }
 }
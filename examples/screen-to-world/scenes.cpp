@@ -86,14 +86,14 @@ MainScene::MainScene() : corn::Scene() {
 }
 
 void MainScene::move(const corn::Vec2& displacement) {
-    this->getEntityManager().getEntityByID(this->cameraID_)
-            ->getComponent<corn::CTransform2D>()->location += displacement;
+    auto* transform = this->getEntityManager().getEntityByID(this->cameraID_)->getComponent<corn::CTransform2D>();
+    transform->setLocation(transform->getLocation() + displacement);
 }
 
 void MainScene::rotate(corn::Deg angle) {
     // To rotate the world in positive direction, rotate camera in opposite direction
-    this->getEntityManager().getEntityByID(this->cameraID_)
-            ->getComponent<corn::CTransform2D>()->rotation -= angle;
+    auto* transform = this->getEntityManager().getEntityByID(this->cameraID_)->getComponent<corn::CTransform2D>();
+    transform->setRotation(transform->getRotation() - angle);
 }
 
 void MainScene::scale(float factor) {
@@ -2,6 +2,7 @@
 
 #include <corn/core/scene.h>
 #include <corn/ecs/entity.h>
+#include <corn/event/event_scope.h>
 #include <corn/geometry/vec2.h>
 
 class MainScene : public corn::Scene {
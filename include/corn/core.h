@@ -1,4 +1,5 @@
 #pragma once
 
 #include <corn/core/game.h>
+#include <corn/core/input_log.h>
 #include <corn/core/scene.h>
@@ -1,19 +1,25 @@
 #pragma once
 
+#include <cstdint>
 #include <queue>
 #include <stack>
 #include <unordered_map>
 #include <corn/event/event_args.h>
 #include <corn/event/event_scope.h>
 #include <corn/util/config.h>
+#include <corn/util/frame_limiter.h>
 #include <corn/util/stopwatch.h>
 
 namespace corn {
     enum class Key;
     enum class SceneOperation;
 
+    struct InputEvent;
+
     class Scene;
     class Interface;
+    class InputRecorder;
+    class InputReplayer;
 
     /**
      * @class Game
@@ -26,6 +32,20 @@ namespace corn {
      * architecture. The top scene is the only active scene, i.e. its data will be updated and displayed in the
      * window. When the scene stack is empty the game ends.
      *
+     * By default, the top scene is updated once per frame with the elapsed time. If `Config::fixedTimestep` is set,
+     * it is updated in ticks of fixed length instead, and the rendered transforms are interpolated between ticks.
+     *
+     * Frames are limited to `Config::targetFps` if set. If `Config::idleFps` is also set, the frame rate drops to it
+     * once no input is received and the top scene does not change for `Config::idleDelay` milliseconds. See
+     * `Scene::requestFrame`.
+     *
+     * If `Config::headless` is set, the game runs without a window. Combined with `Config::virtualFrameTime`, the
+     * scenes are simulated as fast as possible, and `simulateInput` stands in for the user.
+     *
+     * The input and frame times of a session can be recorded with `Config::recordInput`, and replayed with
+     * `Config::replayInput`. Replaying feeds the scenes the same input at the same points of the game clock, so that a
+     * session can be reproduced, e.g. as a benchmark.
+     *
      * @see Scene
      * @see Interface
      * @see Config
@@ -75,11 +95,22 @@ namespace corn {
          */
         [[nodiscard]] bool isPressed(Key key) const noexcept;
 
+        /**
+         * @brief Simulates a user input, as if it was received from the window.
+         * @param input The input to simulate.
+         *
+         * The input is handled with the user input of the next frame, and emits the same events as real input.
+         */
+        void simulateInput(const InputEvent& input);
+
         /**
          * @brief Launch the game.
          *
          * Once this method is called, the game will enter the main loop until a exit event is received or the scene
          * stack is empty.
+         *
+         * @throw std::runtime_error if the input cannot be recorded to `Config::recordInput`.
+         * @throw ResourceLoadFailed if the input cannot be replayed from `Config::replayInput`.
          */
         void run();
 
@@ -117,6 +148,26 @@ namespace corn {
         /// @brief Resolves all pending scene events at the end of a game loop.
         void resolveSceneEvents() noexcept;
 
+        /**
+         * @brief Updates the top scene for one frame.
+         * @param millis Number of milliseconds elapsed since the previous frame.
+         *
+         * With a fixed timestep, the elapsed time is accumulated and the scene is updated in fixed ticks, after which
+         * the remaining fraction of a tick becomes the render interpolation factor.
+         */
+        void updateScene(float millis);
+
+        /**
+         * @brief Waits until the end of the frame according to the frame limits.
+         * @param millis Number of milliseconds elapsed since the previous frame.
+         * @param inputReceived Whether any input was received in this frame.
+         *
+         * The game counts as idle while no input is received, the top scene's entities do not change, and the top scene
+         * does not request a frame. Frames are not limited while replaying in real time, since the replay waits for the
+         * recorded frame times instead.
+         */
+        void limitFrame(float millis, bool inputReceived);
+
         /// @brief Indicates if the game is currently running.
         bool active_;
 
@@ -135,12 +186,30 @@ namespace corn {
         /// @brief Module for rendering and capturing user input.
         Interface* interface_;
 
+        /// @brief Records the input and frame times while running, if enabled.
+        InputRecorder* recorder_;
+
+        /// @brief Replays the input and frame times while running, if enabled.
+        InputReplayer* replayer_;
+
         /// @brief Stores which keys are currently pressed down.
         std::unordered_map<Key, bool> keyPressed_;
 
         /// @brief Stopwatch for timing between each frame.
         Stopwatch sw_;
 
+        /// @brief Elapsed milliseconds not yet simulated by fixed ticks.
+        float accumulator_;
+
+        /// @brief Paces the frames to the target frame rate.
+        FrameLimiter frameLimiter_;
+
+        /// @brief Milliseconds since the last input or change of the top scene's entities.
+        float idleMillis_;
+
+        /// @brief Tick of the last change of the top scene's entities seen by the frame limiter.
+        std::uint64_t lastSeenChangeTick_;
+
         /// @brief Whether to display the debug overlay.
         bool debugOverlayEnabled_;
 
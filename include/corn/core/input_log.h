@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <corn/event/input.h>
+
+namespace corn {
+    /**
+     * @struct InputFrame
+     * @brief The elapsed time and the user input of a single frame.
+     */
+    struct InputFrame {
+        float millis = 0.0f;                                   ///< Elapsed time on the game clock (in milliseconds)
+        float realMillis = 0.0f;                               ///< Elapsed wall-clock time (in milliseconds)
+        std::vector<InputEvent> inputs;                        ///< Inputs handled in the frame, in order
+    };
+
+    /**
+     * @class InputRecorder
+     * @brief Writes the elapsed time and the user input of every frame to a compact binary log.
+     *
+     * Frames without input take 9 bytes, and each input takes at most 13 bytes. The log can be replayed by
+     * `InputReplayer` to reproduce a session.
+     *
+     * @see Config::recordInput
+     * @see InputReplayer
+     */
+    class InputRecorder {
+    public:
+        /**
+         * @brief Constructor. Creates or overwrites the log file.
+         * @param path Path to the log file.
+         * @throw std::runtime_error if the file cannot be opened for writing.
+         */
+        explicit InputRecorder(const std::filesystem::path& path);
+
+        /// @brief Destructor. Closes the file. Inputs of an unfinished frame are discarded.
+        ~InputRecorder();
+
+        InputRecorder(const InputRecorder& other) = delete;
+        InputRecorder& operator=(const InputRecorder& other) = delete;
+
+        /**
+         * @brief Adds an input to the current frame.
+         * @param input The input handled by the interface.
+         */
+        void record(const InputEvent& input);
+
+        /**
+         * @brief Writes the current frame to the log, and starts the next one.
+         * @param millis Elapsed time of the frame on the game clock (in milliseconds).
+         * @param realMillis Elapsed wall-clock time of the frame (in milliseconds). Differs from millis if the game
+         *                   clock is scaled or virtual. If negative, same as millis.
+         */
+        void endFrame(float millis, float realMillis = -1.0f);
+
+        /// @return Number of frames written.
+        [[nodiscard]] size_t getFrameCount() const noexcept;
+
+    private:
+        /// @brief The log file.
+        std::ofstream file_;
+
+        /// @brief Inputs of the current frame.
+        std::vector<InputEvent> inputs_;
+
+        /// @brief Reusable buffer for encoding a frame.
+        std::string buffer_;
+
+        /// @brief Number of frames written.
+        size_t frameCount_;
+    };
+
+    /**
+     * @class InputReplayer
+     * @brief Reads a log written by `InputRecorder` and returns its frames in order.
+     *
+     * @see Config::replayInput
+     * @see InputRecorder
+     */
+    class InputReplayer {
+    public:
+        /**
+         * @brief Constructor. Loads the whole log.
+         * @param path Path to the log file.
+         * @throw ResourceLoadFailed if the file cannot be opened or is not a valid input log.
+         */
+        explicit InputReplayer(const std::filesystem::path& path);
+
+        /// @return The next frame, or null if all frames have been replayed.
+        const InputFrame* next() noexcept;
+
+        /// @return Whether all frames have been replayed.
+        [[nodiscard]] bool isFinished() const noexcept;
+
+        /// @return Number of frames in the log.
+        [[nodiscard]] size_t getFrameCount() const noexcept;
+
+    private:
+        /// @brief All frames of the log.
+        std::vector<InputFrame> frames_;
+
+        /// @brief Index of the next frame.
+        size_t current_;
+    };
+}
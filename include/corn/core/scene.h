@@ -1,9 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <vector>
 
 namespace corn {
+    class EntityCommandBuffer;
     class EntityManager;
     class EventManager;
     class Game;
@@ -44,6 +46,8 @@ namespace corn {
         using SceneID = unsigned long long int;
 
         friend class Game;
+        // Systems invalidate the stages when their activity or accesses change
+        friend class System;
 
         /// @brief Constructor.
         Scene() noexcept;
@@ -65,6 +69,14 @@ namespace corn {
         /// @return The EntityManager owned by this scene.
         [[nodiscard]] EntityManager& getEntityManager() const noexcept;
 
+        /**
+         * @return The command buffer of this scene.
+         *
+         * Commands recorded in the buffer are applied at the sync points of `Scene::update`, i.e. after each system
+         * when updated sequentially, or after each stage of systems when updated in parallel.
+         */
+        [[nodiscard]] EntityCommandBuffer& getCommandBuffer() const noexcept;
+
         /// @return The UIManager owned by this scene.
         [[nodiscard]] UIManager& getUIManager() const noexcept;
 
@@ -74,6 +86,14 @@ namespace corn {
         /// @return The game that owns this scene.
         [[nodiscard]] const Game* getGame() const noexcept;
 
+        /**
+         * @brief Keeps the game out of idle for the next frame. See `Config::idleFps`.
+         *
+         * Changes through component setters, `Component::markChanged`, and UI widgets are detected automatically. Call
+         * it after changes that the game cannot see, such as edits to public component fields or to images and text.
+         */
+        void requestFrame() noexcept;
+
         /**
          * @brief Creates a system and attach it to the scene.
          * @tparam T Type of the system. Must derive from System class.
@@ -110,15 +130,38 @@ namespace corn {
         template <SystemType T>
         bool removeSystem(T* system);
 
+        /// @return Whether systems with non-conflicting accesses are updated in parallel.
+        [[nodiscard]] bool isParallel() const noexcept;
+
+        /**
+         * @brief Sets whether systems with non-conflicting accesses are updated in parallel.
+         *
+         * If set to false, all systems are updated sequentially on the calling thread. Default is true.
+         */
+        void setParallel(bool parallel) noexcept;
+
         /**
          * @brief Calls the update methods of all ACTIVE systems added to the scene.
          * @param millis Number of milliseconds elapsed.
          *
-         * Systems' update methods will be called in the order they are added. This order cannot be changed.
+         * Systems are grouped into stages. A system is placed in the stage right after the last stage containing a
+         * system that was added before it and conflicts with it (see `System::conflictsWith`). Stages are run in
+         * order, and systems in the same stage are run in parallel on the global thread pool. Therefore, conflicting
+         * systems are always updated in the order they are added, which cannot be changed, and the result is the
+         * same as running all systems sequentially.
+         *
+         * The command buffer is played back after each system when updated sequentially, or after each stage when
+         * updated in parallel.
+         *
+         * The stages are cached, and only rebuilt after systems are added, removed, activated, deactivated, or declare
+         * their accesses.
          */
         void update(float millis);
 
     private:
+        /// @brief Groups the active systems into stages of systems that do not conflict with each other.
+        void buildStages();
+
         /// @brief The unique ID of the scene.
         SceneID id_;
 
@@ -131,9 +174,24 @@ namespace corn {
         /// @brief List of all Systems in this scene.
         std::vector<System*> systems_;
 
+        /// @brief Whether systems with non-conflicting accesses are updated in parallel.
+        bool parallel_;
+
+        /// @brief Cached stages of the active systems. See `Scene::update`.
+        std::vector<std::vector<System*>> stages_;
+
+        /// @brief Whether the stages need to be rebuilt.
+        bool stagesDirty_;
+
+        /// @brief Whether a frame is requested since the game last checked for idleness.
+        std::atomic<bool> frameRequested_;
+
         /// @brief Manages the lifetime of all entities in this scene.
         EntityManager* entityManager_;
 
+        /// @brief Records structural changes to the entities, applied at the sync points of `Scene::update`.
+        EntityCommandBuffer* commandBuffer_;
+
         /// @brief Manages the lifetime of all UI widgets in this scene.
         UIManager* uiManager_;
     };
@@ -142,6 +200,7 @@ namespace corn {
     T* Scene::addSystem(Args&&... args) {
         T* system = new T(*this, std::forward<Args>(args)...);
         this->systems_.push_back(system);
+        this->stagesDirty_ = true;
         return system;
     }
 
@@ -171,6 +230,7 @@ namespace corn {
         for (auto it = this->systems_.begin(); it != this->systems_.end(); ++it) {
             if (*it == system) {
                 this->systems_.erase(it);
+                this->stagesDirty_ = true;
                 delete system;
                 return true;
             }
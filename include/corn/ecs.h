@@ -1,6 +1,11 @@
 #pragma once
 
 #include <corn/ecs/component.h>
+#include <corn/ecs/component_registry.h>
 #include <corn/ecs/entity.h>
+#include <corn/ecs/entity_command_buffer.h>
 #include <corn/ecs/entity_manager.h>
+#include <corn/ecs/integration.h>
+#include <corn/ecs/prefab.h>
+#include <corn/ecs/query.h>
 #include <corn/ecs/system.h>
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <corn/ecs/entity.h>
 #include <corn/geometry/deg.h>
 #include <corn/geometry/polygon.h>
@@ -51,12 +52,29 @@ namespace corn {
         /// @return The game that contains this component.
         [[nodiscard]] const Game* getGame() const noexcept;
 
+        /// @return The change tick at which the component was last changed or added. See `EntityManager::getTick`.
+        [[nodiscard]] std::uint64_t getChangeTick() const noexcept;
+
+        /// @return Whether the component was changed or added at or after the given change tick.
+        [[nodiscard]] bool isChangedSince(std::uint64_t tick) const noexcept;
+
+        /**
+         * @brief Stamps the component with the current change tick.
+         *
+         * Setters of the built-in components call it automatically. Call it after modifying public fields directly,
+         * or obtain the component through `Entity::getComponentMut`.
+         */
+        void markChanged() noexcept;
+
     private:
         /// @brief The entity manager that contains the owner of this component.
         EntityManager& entityManager_;
 
         /// @brief The ID of the entity that owns this component.
         Entity::EntityID entityID_;
+
+        /// @brief The change tick at which the component was last changed or added.
+        std::uint64_t changeTick_;
     };
 
     /**
@@ -67,18 +85,44 @@ namespace corn {
      * @see SMovement2D
      */
     struct CTransform2D : public Component {
-        /// @brief Location of the entity in its parent's reference frame.
-        Vec2 location;
-
-        /// @brief Rotation of the entity in its parent's reference frame.
-        Deg rotation;
-
         /// @brief Constructor.
         CTransform2D(Entity& entity, Vec2 location, Deg rotation = Deg()) noexcept;
 
-        /// @return The transform in the world's reference frame.
+        /// @brief Getter of the location of the entity in its parent's reference frame.
+        [[nodiscard]] Vec2 getLocation() const noexcept;
+
+        /// @brief Setter of the location of the entity in its parent's reference frame.
+        void setLocation(Vec2 location) noexcept;
+
+        /// @brief Getter of the rotation of the entity in its parent's reference frame.
+        [[nodiscard]] Deg getRotation() const noexcept;
+
+        /// @brief Setter of the rotation of the entity in its parent's reference frame.
+        void setRotation(Deg rotation) noexcept;
+
+        /**
+         * @brief Sets both the location and the rotation of the entity in its parent's reference frame.
+         *
+         * Same as calling both setters, but stamps, notifies and invalidates the world cache only once.
+         */
+        void setTransform(Vec2 location, Deg rotation) noexcept;
+
+        /**
+         * @return The transform in the world's reference frame.
+         *
+         * The world transform is cached by the entity manager and only recalculated after the transform of the entity
+         * or one of its ancestors changes.
+         */
         [[nodiscard]] std::pair<Vec2, Deg> getWorldTransform() const noexcept;
 
+        /**
+         * @return The world transform to render, interpolated between the previous and current fixed ticks.
+         *
+         * Same as `getWorldTransform` unless the game runs with a fixed timestep and interpolation. See
+         * `Config::fixedTimestep`.
+         */
+        [[nodiscard]] std::pair<Vec2, Deg> getRenderTransform() const noexcept;
+
         /// @brief Set the location of the entity in the world's reference frame.
         void setWorldLocation(Vec2 worldLocation) noexcept;
 
@@ -92,6 +136,12 @@ namespace corn {
         void setZOrder(int zOrder) noexcept;
 
     private:
+        /// @brief Location of the entity in its parent's reference frame.
+        Vec2 location_;
+
+        /// @brief Rotation of the entity in its parent's reference frame.
+        Deg rotation_;
+
         /**
          * @brief Defines the order of the entities in the z direction (in/out of the screen). A higher z-order means
          * closer to the top.
@@ -108,6 +158,10 @@ namespace corn {
      *
      * Note that the BBox is not affected by rotation.
      *
+     * Each BBox belongs to the collision layers in its layer bitmask, and only collides with BBoxes in the layers of its
+     * mask. Two BBoxes interact only if each of them belongs to a layer in the other's mask. Pairs that do not interact
+     * are rejected by the collision system before the overlap test, so no event is emitted for them.
+     *
      * @see Component
      * @see SCollisionDetection
      * @see CCollisionResolve
@@ -119,8 +173,24 @@ namespace corn {
         /// @brief Location of the bottom right corner.
         Vec2 br;
 
-        /// @brief Constructor.
-        CBBox(Entity& entity, Vec2 tl, Vec2 br) noexcept;
+        /// @brief Bitmask of the collision layers that the BBox belongs to.
+        std::uint32_t layer;
+
+        /// @brief Bitmask of the collision layers that the BBox collides with.
+        std::uint32_t mask;
+
+        /**
+         * @brief Constructor.
+         * @param entity The entity that owns the component.
+         * @param tl Location of the top left corner.
+         * @param br Location of the bottom right corner.
+         * @param layer Bitmask of the collision layers that the BBox belongs to. Default is the first layer.
+         * @param mask Bitmask of the collision layers that the BBox collides with. Default is all layers.
+         */
+        CBBox(Entity& entity, Vec2 tl, Vec2 br, std::uint32_t layer = 1, std::uint32_t mask = ~std::uint32_t(0)) noexcept;
+
+        /// @return Whether the two BBoxes interact according to their layers and masks.
+        [[nodiscard]] bool interactsWith(const CBBox& other) const noexcept;
 
         /// @return Whether the two AABBs overlap.
         [[nodiscard]] bool overlapWith(const CBBox& other) const noexcept;
@@ -212,24 +282,35 @@ namespace corn {
      * @see SMovement2D
      */
     struct CMovement2D : public Component {
+        /// @brief Constructor.
+        explicit CMovement2D(Entity& entity, Vec2 velocity = Vec2::ZERO(), float angularVelocity = 0.0f) noexcept;
+
         /**
-         * @brief Linear velocity of the entity in its parent's reference frame.
+         * @brief Getter of the linear velocity of the entity in its parent's reference frame.
          *
          * Unit: pixel/second
          */
-        Vec2 velocity;
+        [[nodiscard]] Vec2 getVelocity() const noexcept;
+
+        /// @brief Setter of the linear velocity of the entity in its parent's reference frame.
+        void setVelocity(Vec2 velocity) noexcept;
 
         /**
-         * @brief Angular velocity of the entity in its parent's reference frame.
+         * @brief Getter of the angular velocity of the entity in its parent's reference frame.
          *
          * Unit: degree/second
          */
-        float angularVelocity;
+        [[nodiscard]] float getAngularVelocity() const noexcept;
 
-        /// @brief Constructor.
-        explicit CMovement2D(Entity& entity, Vec2 velocity = Vec2::ZERO(), float angularVelocity = 0.0f) noexcept;
+        /// @brief Setter of the angular velocity of the entity in its parent's reference frame.
+        void setAngularVelocity(float angularVelocity) noexcept;
 
-        /// @return The velocities in the world's reference frame.
+        /**
+         * @return The velocities in the world's reference frame.
+         *
+         * The world movement is cached by the entity manager and only recalculated after the movement or the transform
+         * of the entity's ancestors changes.
+         */
         [[nodiscard]] std::pair<Vec2, float> getWorldMovement() const noexcept;
 
         /// @brief Set the linear velocity of the entity in the world's reference frame.
@@ -237,6 +318,13 @@ namespace corn {
 
         /// @brief Adds an offset to the linear velocity of the entity in the world's reference frame.
         void addWorldVelocityOffset(Vec2 offset) noexcept;
+
+    private:
+        /// @brief Linear velocity of the entity in its parent's reference frame.
+        Vec2 velocity_;
+
+        /// @brief Angular velocity of the entity in its parent's reference frame.
+        float angularVelocity_;
     };
 
     /**
@@ -305,9 +393,6 @@ namespace corn {
         /// @brief Constructor for 3D camera.
         CCamera(Entity& entity, Vec3 anchor, Color background = Color::rgb(0, 0, 0, 0)) noexcept;
 
-        /// @brief Destructor.
-        ~CCamera() override;
-
         /**
          * @brief Set the top-left corner, width, and height of the viewport.
          *
@@ -0,0 +1,388 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+#include <corn/ecs/component_registry.h>
+
+namespace corn {
+    struct Component;
+    class Entity;
+
+    /**
+     * @class ComponentPoolBase
+     * @brief Type-erased base of all component pools.
+     *
+     * A component pool is a sparse set that maps entity indices to the components of a single type. The components
+     * themselves are listed in a packed (dense) array, so that iterating over all components of one type touches
+     * contiguous memory instead of chasing pointers across the heap.
+     *
+     * @see ComponentPool
+     * @see ComponentStorage
+     */
+    class ComponentPoolBase {
+    public:
+        /// @brief Marks an entity index that does not own a component in this pool.
+        static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+        /// @brief Constructor.
+        ComponentPoolBase() noexcept;
+
+        /// @brief Destructor.
+        virtual ~ComponentPoolBase();
+
+        ComponentPoolBase(const ComponentPoolBase& other) = delete;
+        ComponentPoolBase& operator=(const ComponentPoolBase& other) = delete;
+
+        /// @return Number of components in the pool.
+        [[nodiscard]] size_t size() const noexcept;
+
+        /// @return Whether the entity with the given index owns a component in this pool.
+        [[nodiscard]] bool contains(size_t index) const noexcept;
+
+        /// @return The component owned by the entity with the given index, or null pointer if it doesn't exist.
+        [[nodiscard]] Component* getBase(size_t index) const noexcept;
+
+        /// @return The owners of the components, in the same order as the packed component array.
+        [[nodiscard]] const std::vector<Entity*>& getOwners() const noexcept;
+
+        /**
+         * @brief Destroys the component owned by the entity with the given index.
+         * @return Whether the component originally exists.
+         */
+        virtual bool remove(size_t index) noexcept = 0;
+
+        /**
+         * @brief Destroys all components at once.
+         *
+         * Unlike calling `remove` on every component, the packed arrays are reset in bulk. The memory is kept for
+         * new components.
+         */
+        virtual void clear() noexcept = 0;
+
+    protected:
+        /**
+         * @brief Registers a new component at the end of the packed array.
+         * @param index Index of the owner entity.
+         * @param owner The owner entity.
+         * @param component The newly constructed component.
+         */
+        void link(size_t index, Entity* owner, Component* component);
+
+        /**
+         * @brief Unregisters the component owned by the entity with the given index.
+         * @return Position of the component in the packed array before removal.
+         *
+         * The last component of the packed array is moved into the vacated position.
+         */
+        size_t unlink(size_t index) noexcept;
+
+        /// @brief Maps the entity index to the position of its component in the packed arrays.
+        std::vector<size_t> sparse_;
+
+        /// @brief Packed array of the components.
+        std::vector<Component*> dense_;
+
+        /// @brief Packed array of the owner entities.
+        std::vector<Entity*> owners_;
+
+        /// @brief Packed array of the indices of the owner entities.
+        std::vector<size_t> indices_;
+    };
+
+    /**
+     * @class ComponentPool
+     * @brief Stores all components of type T in a scene.
+     * @tparam T Type of the component.
+     *
+     * Components are constructed in place inside fixed-size pages of contiguous memory. A component never moves once
+     * it is created, so pointers to components stay valid until the component is removed. Slots freed by removed
+     * components are reused by new components of the same type.
+     *
+     * Pages are allocated from the given memory resource, which is the scene's memory resource for pools owned by an
+     * entity manager.
+     */
+    template <typename T>
+    class ComponentPool : public ComponentPoolBase {
+    public:
+        /// @brief Number of components stored in each page.
+        static constexpr size_t PAGE_SIZE = std::max<size_t>(1, 16384 / sizeof(T));
+
+        /**
+         * @brief Constructor.
+         * @param resource Memory resource for allocating the pages.
+         */
+        explicit ComponentPool(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) noexcept;
+
+        /// @brief Destructor. Destroys all remaining components and releases the pages.
+        ~ComponentPool() override;
+
+        /**
+         * @brief Constructs a component for the entity with the given index.
+         * @param index Index of the owner entity.
+         * @param owner The owner entity. Passed as the first argument to the component's constructor.
+         * @param args Remaining arguments for constructing the component.
+         * @return Pointer to the component if successfully added, else null pointer.
+         */
+        template <typename... Args>
+        T* add(size_t index, Entity& owner, Args&&... args);
+
+        /// @return The component owned by the entity with the given index, or null pointer if it doesn't exist.
+        [[nodiscard]] T* get(size_t index) const noexcept;
+
+        /**
+         * @brief Destroys the component of the entity with the given index, and constructs a new one in its slot.
+         * @param index Index of the owner entity.
+         * @param owner The owner entity. Passed as the first argument to the component's constructor.
+         * @param args Remaining arguments for constructing the component.
+         * @return Pointer to the new component, at the address of the old one, or null pointer if the entity owns no
+         *         component in this pool.
+         *
+         * The position in the packed arrays is kept. If the constructor throws, the component is removed from the
+         * pool before the exception is rethrown.
+         */
+        template <typename... Args>
+        T* reconstruct(size_t index, Entity& owner, Args&&... args);
+
+        bool remove(size_t index) noexcept override;
+
+        void clear() noexcept override;
+
+        /**
+         * @brief Reserves storage for at least the given number of components in total.
+         * @param count Number of components.
+         *
+         * Allocates the pages and grows the packed arrays up front, so that adding that many components does not
+         * allocate.
+         */
+        void reserve(size_t count);
+
+        /// @return The component at the given position of the packed array.
+        [[nodiscard]] T* at(size_t position) const noexcept;
+
+    private:
+        /// @brief Raw storage for a single component.
+        struct alignas(T) Slot {
+            std::byte data[sizeof(T)];
+        };
+
+        /// @return Pointer to an unused slot.
+        Slot* acquireSlot();
+
+        /// @brief Calls the destructors of all components in the packed array.
+        void destroyAll() noexcept;
+
+        /// @brief Memory resource for allocating the pages.
+        std::pmr::memory_resource* resource_;
+
+        /// @brief Pages of contiguous component storage.
+        std::vector<Slot*> pages_;
+
+        /// @brief Number of pages in use. Pages after them are kept for reuse after `clear`.
+        size_t usedPages_;
+
+        /// @brief Number of slots used in the last page in use.
+        size_t pageCursor_;
+
+        /// @brief Slots freed by removed components.
+        std::vector<Slot*> freeSlots_;
+    };
+
+    /**
+     * @class ComponentStorage
+     * @brief Owns one component pool for each type of component in a scene.
+     *
+     * Pools are indexed by the dense component type IDs, so looking up a pool is a single array access.
+     *
+     * @see ComponentRegistry
+     * @see ComponentPool
+     * @see EntityManager
+     */
+    class ComponentStorage {
+    public:
+        /**
+         * @brief Constructor.
+         * @param resource Memory resource for allocating the components.
+         */
+        explicit ComponentStorage(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) noexcept;
+
+        /// @brief Destructor.
+        ~ComponentStorage();
+
+        ComponentStorage(const ComponentStorage& other) = delete;
+        ComponentStorage& operator=(const ComponentStorage& other) = delete;
+
+        /// @return The pool storing components of type T, or null pointer if it hasn't been created.
+        template <typename T>
+        [[nodiscard]] ComponentPool<T>* findPool() const noexcept;
+
+        /// @return The pool storing components of the given type ID, or null pointer if it hasn't been created.
+        [[nodiscard]] ComponentPoolBase* findPool(size_t typeID) const noexcept;
+
+        /// @return The pool storing components of type T. Creates the pool if it doesn't exist.
+        template <typename T>
+        ComponentPool<T>& getPool();
+
+        /**
+         * @brief Destroys all components owned by the entity with the given index.
+         * @param index Index of the owner entity.
+         * @param signature Component types owned by the entity. Only their pools are visited.
+         */
+        void removeAll(size_t index, const ComponentSignature& signature) noexcept;
+
+        /// @brief Destroys all components in all pools at once. The pools are kept.
+        void clear() noexcept;
+
+    private:
+        /// @brief Memory resource for allocating the components.
+        std::pmr::memory_resource* resource_;
+
+        /// @brief The pools, indexed by component type ID. Null if not created yet.
+        std::vector<std::unique_ptr<ComponentPoolBase>> pools_;
+    };
+
+    template <typename T>
+    ComponentPool<T>::ComponentPool(std::pmr::memory_resource* resource) noexcept
+            : resource_(resource), pages_(), usedPages_(0), pageCursor_(PAGE_SIZE), freeSlots_() {}
+
+    template <typename T>
+    ComponentPool<T>::~ComponentPool() {
+        this->destroyAll();
+        for (Slot* page : this->pages_) {
+            this->resource_->deallocate(page, sizeof(Slot) * PAGE_SIZE, alignof(Slot));
+        }
+    }
+
+    template <typename T>
+    template <typename... Args>
+    T* ComponentPool<T>::add(size_t index, Entity& owner, Args&&... args) {
+        if (this->contains(index)) return nullptr;
+        Slot* slot = this->acquireSlot();
+        T* component;
+        try {
+            component = new(slot->data) T(owner, std::forward<Args>(args)...);
+        } catch (...) {
+            this->freeSlots_.push_back(slot);
+            throw;
+        }
+        this->link(index, &owner, component);
+        return component;
+    }
+
+    template <typename T>
+    T* ComponentPool<T>::get(size_t index) const noexcept {
+        return static_cast<T*>(this->getBase(index));
+    }
+
+    template <typename T>
+    template <typename... Args>
+    T* ComponentPool<T>::reconstruct(size_t index, Entity& owner, Args&&... args) {
+        if (!this->contains(index)) return nullptr;
+        T* component = static_cast<T*>(this->dense_[this->sparse_[index]]);
+        Slot* slot = reinterpret_cast<Slot*>(component);
+        component->~T();
+        try {
+            return new(slot->data) T(owner, std::forward<Args>(args)...);
+        } catch (...) {
+            this->unlink(index);
+            this->freeSlots_.push_back(slot);
+            throw;
+        }
+    }
+
+    template <typename T>
+    bool ComponentPool<T>::remove(size_t index) noexcept {
+        if (!this->contains(index)) return false;
+        T* component = static_cast<T*>(this->dense_[this->sparse_[index]]);
+        this->unlink(index);
+        component->~T();
+        this->freeSlots_.push_back(reinterpret_cast<Slot*>(component));
+        return true;
+    }
+
+    template <typename T>
+    void ComponentPool<T>::clear() noexcept {
+        this->destroyAll();
+        this->sparse_.clear();
+        this->dense_.clear();
+        this->owners_.clear();
+        this->indices_.clear();
+        this->freeSlots_.clear();
+        this->usedPages_ = 0;
+        this->pageCursor_ = PAGE_SIZE;
+    }
+
+    template <typename T>
+    void ComponentPool<T>::reserve(size_t count) {
+        this->dense_.reserve(count);
+        this->owners_.reserve(count);
+        this->indices_.reserve(count);
+        if (count <= this->size()) return;
+        size_t available = this->freeSlots_.size() + (PAGE_SIZE - this->pageCursor_) +
+                (this->pages_.size() - this->usedPages_) * PAGE_SIZE;
+        size_t needed = count - this->size();
+        if (needed <= available) return;
+        size_t pages = (needed - available + PAGE_SIZE - 1) / PAGE_SIZE;
+        this->pages_.reserve(this->pages_.size() + pages);
+        for (size_t i = 0; i < pages; i++) {
+            this->pages_.push_back(static_cast<Slot*>(
+                    this->resource_->allocate(sizeof(Slot) * PAGE_SIZE, alignof(Slot))));
+        }
+    }
+
+    template <typename T>
+    void ComponentPool<T>::destroyAll() noexcept {
+        for (Component* component : this->dense_) {
+            static_cast<T*>(component)->~T();
+        }
+    }
+
+    template <typename T>
+    T* ComponentPool<T>::at(size_t position) const noexcept {
+        return static_cast<T*>(this->dense_[position]);
+    }
+
+    template <typename T>
+    typename ComponentPool<T>::Slot* ComponentPool<T>::acquireSlot() {
+        if (!this->freeSlots_.empty()) {
+            Slot* slot = this->freeSlots_.back();
+            this->freeSlots_.pop_back();
+            return slot;
+        }
+        if (this->pageCursor_ == PAGE_SIZE) {
+            if (this->usedPages_ == this->pages_.size()) {
+                // Grow geometrically before allocating, so that the push cannot throw and leak the page
+                this->pages_.reserve(std::max(this->pages_.size() + 1, 2 * this->pages_.size()));
+                this->pages_.push_back(static_cast<Slot*>(
+                        this->resource_->allocate(sizeof(Slot) * PAGE_SIZE, alignof(Slot))));
+            }
+            this->usedPages_++;
+            this->pageCursor_ = 0;
+        }
+        return &this->pages_[this->usedPages_ - 1][this->pageCursor_++];
+    }
+
+    template <typename T>
+    ComponentPool<T>* ComponentStorage::findPool() const noexcept {
+        size_t id = ComponentRegistry::find<T>();
+        if (id >= this->pools_.size()) return nullptr;
+        return static_cast<ComponentPool<T>*>(this->pools_[id].get());
+    }
+
+    template <typename T>
+    ComponentPool<T>& ComponentStorage::getPool() {
+        size_t id = ComponentRegistry::id<T>();
+        if (id >= this->pools_.size()) {
+            this->pools_.resize(id + 1);
+        }
+        std::unique_ptr<ComponentPoolBase>& pool = this->pools_[id];
+        if (!pool) {
+            pool = std::make_unique<ComponentPool<T>>(this->resource_);
+        }
+        return *static_cast<ComponentPool<T>*>(pool.get());
+    }
+}
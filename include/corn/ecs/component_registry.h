@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <typeindex>
+#include <typeinfo>
+
+namespace corn {
+    /// @brief Maximum number of component types in a program.
+    constexpr size_t MAX_COMPONENT_TYPES = 128;
+
+    /**
+     * @brief Set of component types, indexed by their component type IDs.
+     * @see ComponentRegistry
+     */
+    using ComponentSignature = std::bitset<MAX_COMPONENT_TYPES>;
+
+    /**
+     * @class ComponentRegistry
+     * @brief Assigns dense integer IDs to component types.
+     *
+     * Each component type is assigned an ID on first use, starting from 0. IDs are shared by all scenes and stay the
+     * same until the program exits. They are used to index the component pools and the component signatures of the
+     * entities, so that checking and accessing components needs neither hashing nor RTTI.
+     *
+     * @see ComponentSignature
+     * @see ComponentStorage
+     */
+    class ComponentRegistry {
+    public:
+        /// @brief Returned by `find` for component types without an ID.
+        static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+        /**
+         * @tparam T Type of the component.
+         * @return The ID of the component type.
+         * @throw std::length_error if more than `MAX_COMPONENT_TYPES` component types are used.
+         */
+        template <typename T>
+        [[nodiscard]] static size_t id();
+
+        /**
+         * @tparam T Type of the component.
+         * @return The ID of the component type, or `NPOS` if no ID has been assigned to it yet.
+         *
+         * Unlike `id`, never assigns an ID, so looking up a type that was never added uses up none of the IDs.
+         */
+        template <typename T>
+        [[nodiscard]] static size_t find() noexcept;
+
+        /**
+         * @tparam T Types of the components.
+         * @return The signature containing all given component types.
+         * @throw std::length_error if more than `MAX_COMPONENT_TYPES` component types are used.
+         */
+        template <typename... T>
+        [[nodiscard]] static const ComponentSignature& signature();
+
+        /// @return Number of component types registered so far.
+        [[nodiscard]] static size_t size() noexcept;
+
+    private:
+        /**
+         * @brief Assigns an ID to the component type, or returns its existing ID.
+         * @param type The component type.
+         * @return The ID of the component type.
+         *
+         * Registration goes through a single table in the library, so that all modules agree on the IDs.
+         */
+        static size_t registerType(std::type_index type);
+
+        /**
+         * @param type The component type.
+         * @return The ID of the component type, or `NPOS` if it has not been registered.
+         */
+        static size_t findType(std::type_index type) noexcept;
+    };
+
+    template <typename T>
+    size_t ComponentRegistry::id() {
+        static const size_t id = registerType(std::type_index(typeid(T)));
+        return id;
+    }
+
+    template <typename T>
+    size_t ComponentRegistry::find() noexcept {
+        // IDs never change once assigned, so only the lookups before registration go through the table
+        static std::atomic<size_t> cached = NPOS;
+        size_t id = cached.load(std::memory_order_acquire);
+        if (id == NPOS) {
+            id = findType(std::type_index(typeid(T)));
+            if (id != NPOS) {
+                cached.store(id, std::memory_order_release);
+            }
+        }
+        return id;
+    }
+
+    template <typename... T>
+    const ComponentSignature& ComponentRegistry::signature() {
+        static const ComponentSignature signature = [] {
+            ComponentSignature result;
+            (result.set(id<T>()), ...);
+            return result;
+        }();
+        return signature;
+    }
+}
@@ -1,11 +1,12 @@
 #pragma once
 
 #include <concepts>
+#include <cstdint>
 #include <string>
-#include <typeindex>
-#include <typeinfo>
-#include <unordered_map>
+#include <utility>
 #include <vector>
+#include <corn/ecs/component_pool.h>
+#include <corn/ecs/component_registry.h>
 
 namespace corn {
     struct Component;
@@ -33,6 +34,8 @@ namespace corn {
 
         // EntityManager need access to ctor/dtor
         friend class EntityManager;
+        // QueryBase needs access to the index
+        friend class QueryBase;
 
         /**
          * @brief Getter for the entity's ID.
@@ -41,23 +44,70 @@ namespace corn {
          */
         [[nodiscard]] EntityID getID() const noexcept;
 
+        /**
+         * @param index Index of the entity's slot in the entity manager.
+         * @param generation Number of times the slot has been reused.
+         * @return The entity ID composed of the index and the generation.
+         */
+        [[nodiscard]] static constexpr EntityID makeID(std::uint32_t index, std::uint32_t generation) noexcept {
+            return (static_cast<EntityID>(generation) << 32) | index;
+        }
+
+        /// @return The index of the entity's slot encoded in the ID.
+        [[nodiscard]] static constexpr std::uint32_t indexOf(EntityID id) noexcept {
+            return static_cast<std::uint32_t>(id);
+        }
+
+        /// @return The generation of the entity's slot encoded in the ID.
+        [[nodiscard]] static constexpr std::uint32_t generationOf(EntityID id) noexcept {
+            return static_cast<std::uint32_t>(id >> 32);
+        }
+
         /// @brief Getter for the entity's name.
         [[nodiscard]] const std::string& getName() const noexcept;
 
-        /// @brief Setter for the entity's name.
-        void setName(std::string name) noexcept;
+        /**
+         * @brief Setter for the entity's name.
+         * @throw std::logic_error if called during a parallel pass. See `EntityManager::forEachParallel`.
+         */
+        void setName(const std::string& name);
+
+        /**
+         * @brief Adds a tag to the entity.
+         * @param tag The tag. Entities can have any number of tags, and multiple entities can have the same tag.
+         * @return Whether the tag is newly added.
+         * @throw std::logic_error if called during a parallel pass. See `EntityManager::forEachParallel`.
+         */
+        bool addTag(const std::string& tag);
+
+        /**
+         * @brief Removes a tag from the entity.
+         * @param tag The tag.
+         * @return Whether the tag originally exists.
+         * @throw std::logic_error if called during a parallel pass. See `EntityManager::forEachParallel`.
+         */
+        bool removeTag(const std::string& tag);
+
+        /// @return Whether the entity has the given tag.
+        [[nodiscard]] bool hasTag(const std::string& tag) const noexcept;
+
+        /// @return All tags of the entity, in the order they are added.
+        [[nodiscard]] std::vector<std::string> getTags() const;
 
         /// @return Getter for the entity's active property.
         [[nodiscard]] bool isActive() const noexcept;
 
-        /// @brief Setter for the entity's active property.
-        void setActive(bool active) noexcept;
+        /**
+         * @brief Setter for the entity's active property.
+         * @throw std::logic_error if called during a parallel pass. See `EntityManager::forEachParallel`.
+         */
+        void setActive(bool active);
 
         /**
          * @return Whether the entity is active in the world.
          *
          * An entity is active in the world if and only if itself and all its ancestors have property active set to
-         * true.
+         * true. The value is cached by the entity manager and updated when the active properties change.
          */
         [[nodiscard]] bool isActiveInWorld() const noexcept;
 
@@ -70,8 +120,11 @@ namespace corn {
         /// @return The game that contains this entity.
         [[nodiscard]] const Game* getGame() const noexcept;
 
-        /// @brief Destroys the entity itself.
-        void destroy() noexcept;
+        /**
+         * @brief Destroys the entity itself.
+         * @throw std::logic_error if called during a parallel pass. See `EntityManager::forEachParallel`.
+         */
+        void destroy();
 
         /**
          * @brief Create a component and attach it to the entity.
@@ -81,6 +134,8 @@ namespace corn {
          *
          * If a component of the same type already exist, it will NOT be replaced. Instead null pointer will be
          * returned.
+         *
+         * @throw std::logic_error if called during a parallel pass. See `EntityManager::forEachParallel`.
          */
         template <ComponentType T, typename... Args>
         T* addComponent(Args&&... args);
@@ -89,27 +144,84 @@ namespace corn {
          * @brief Obtain the corresponding component.
          * @tparam T Type of the component, must derive from Component class.
          * @return Pointer to the component if exists, else null pointer.
+         *
+         * Looking up a type that no entity has ever had assigns it no component type ID.
          */
         template <ComponentType T>
         T* getComponent() const noexcept;
 
+        /**
+         * @brief Obtain the corresponding component for writing, and stamp it as changed.
+         * @tparam T Type of the component, must derive from Component class.
+         * @return Pointer to the component if exists, else null pointer.
+         * @see Component::markChanged
+         */
+        template <ComponentType T>
+        T* getComponentMut() const noexcept;
+
+        /**
+         * @brief Modifies the corresponding component in place, stamps it as changed, and notifies the onSet
+         *        observers.
+         * @tparam T Type of the component, must derive from Component class.
+         * @param func Function modifying the component. It may assign fields directly or call setters.
+         * @return Whether the component exists.
+         * @see EntityManager::onSet
+         *
+         * The observers are notified once after the function returns, even if it calls setters that notify on their
+         * own. They are not notified if the function throws.
+         */
+        template <ComponentType T, std::invocable<T&> Func>
+        bool patchComponent(Func&& func);
+
+        /**
+         * @brief Replaces the corresponding component with a newly constructed one, in place.
+         * @tparam T Type of the component, must derive from Component class.
+         * @param args Arguments for constructing the component (excluding the first argument Entity& entity).
+         * @return Pointer to the new component, which has the address of the old one, or null pointer if the entity
+         *         has no such component.
+         * @throw std::logic_error if called during a parallel pass. See `EntityManager::forEachParallel`.
+         *
+         * Unlike removing and adding the component, the queries are not updated, and the onSet observers are notified
+         * instead of the onRemove and onAdd observers. If the constructor throws, the component is removed without
+         * notifying the onRemove observers, since the old component is already destroyed.
+         */
+        template <ComponentType T, typename... Args>
+        T* resetComponent(Args&&... args);
+
+        /**
+         * @tparam T Types of the components, must derive from Component class.
+         * @return Whether the entity has all the given components.
+         *
+         * The check tests one bit of the entity's component signature per type, and assigns no component type IDs.
+         */
+        template <ComponentType... T>
+        [[nodiscard]] bool hasComponents() const noexcept;
+
+        /// @return The set of component types attached to the entity, indexed by component type ID.
+        [[nodiscard]] const ComponentSignature& getSignature() const noexcept;
+
         /**
          * @brief Removing a component from the entity.
          * @tparam T Type of the component, must derive from Component class.
          * @return Whether the component originally exists.
+         * @throw std::logic_error if called during a parallel pass. See `EntityManager::forEachParallel`.
          */
         template <ComponentType T>
-        bool removeComponent() noexcept;
+        bool removeComponent();
 
         /// @return Get the parent entity.
         [[nodiscard]] Entity* getParent() const noexcept;
 
-        /// @return Get the list of child entities.
+        /// @return Get the list of child entities. See `EntityManager::view` for iterating without allocation.
         [[nodiscard]] std::vector<Entity*> getChildren() const noexcept;
 
     private:
-        /// @brief Constructor.
-        explicit Entity(EntityID id, std::string name, EntityManager& entityManager) noexcept;
+        /**
+         * @brief Constructor.
+         *
+         * The name is assigned by the entity manager afterwards, so that it is interned in the name index.
+         */
+        Entity(EntityID id, EntityManager& entityManager) noexcept;
 
         /// @brief Destructor.
         ~Entity();
@@ -117,53 +229,171 @@ namespace corn {
         Entity(const Entity& other) = delete;
         Entity& operator=(const Entity& other) = delete;
 
+        /**
+         * @brief Throws if the structure of the entities cannot be changed at the moment.
+         * @throw std::logic_error if called during a parallel pass.
+         */
+        void checkStructureUnlocked() const;
+
+        /**
+         * @brief Notifies the entity manager that a component is added or removed.
+         * @param typeID ID of the component type.
+         */
+        void onComponentChange(size_t typeID);
+
+        /**
+         * @brief Notifies the entity manager and the onAdd and onSet observers that a component is added.
+         * @param typeID ID of the component type.
+         * @param component The new component.
+         */
+        void onComponentAdd(size_t typeID, Component& component);
+
+        /**
+         * @brief Notifies the onRemove observers that a component is about to be removed.
+         * @param typeID ID of the component type.
+         * @param component The component.
+         */
+        void onComponentRemove(size_t typeID, Component& component);
+
+        /**
+         * @brief Notifies the onSet observers that a component is assigned a value.
+         * @param typeID ID of the component type.
+         * @param component The component.
+         */
+        void onComponentSet(size_t typeID, Component& component);
+
+        /**
+         * @brief Notifies the entity manager and the onSet observers that a component is constructed again in place.
+         * @param typeID ID of the component type.
+         * @param component The new component.
+         */
+        void onComponentReset(size_t typeID, Component& component);
+
         /**
          * @brief The unique ID of the entity.
          *
-         * The unique ID starts from 0 and adds one for each new entity created within the same scene. After it reaches
-         * the max value of EntityID, it goes back to 0.
+         * The lower 32 bits are the index of the entity's slot in the entity manager, and the upper 32 bits are the
+         * generation of the slot. Slots are reused after their entities are destroyed, but each reuse increments the
+         * generation (which starts from 1), so IDs of destroyed entities never refer to a new entity.
          */
         const EntityID id_;
 
         /**
-         * @brief The name of the entity.
+         * @brief Index of the entity's slot, used by the entity manager and the component pools.
+         *
+         * Indices are dense and reused after the entity is destroyed, so they are only unique among living entities.
+         */
+        const size_t index_;
+
+        /**
+         * @brief The name of the entity, interned in the entity manager's name index.
          *
          * Unlike ID, the name is a mutable property assigned during creation. Multiple Entities are allowed to have
-         * the same name.
+         * the same name, in which case they point to the same string.
          */
-        std::string name_;
+        const std::string* name_;
+
+        /// @brief The tags of the entity, interned in the entity manager's tag index.
+        std::vector<const std::string*> tags_;
 
         /// @brief Indicates whether the entity is active.
         bool active_;
 
+        /// @brief The set of component types attached to the entity.
+        ComponentSignature signature_;
+
         /// @brief The entity manager that owns this entity.
         EntityManager& entityManager_;
 
-        /// @brief List of all attached components.
-        std::unordered_map<std::type_index, Component*> components_;
+        /// @brief Component being patched by `patchComponent` on the current thread, or null pointer.
+        static thread_local const Component* patchedComponent_;
+
+        /// @brief Storage of all components in the scene, owned by the entity manager.
+        ComponentStorage& componentStorage_;
     };
 
     template<ComponentType T, typename... Args>
     T* Entity::addComponent(Args&&... args) {
-        auto key = std::type_index(typeid(T));
-        if (this->components_.find(key) != this->components_.end()) return nullptr;
-        T* component = new T(*this, std::forward<Args>(args)...);
-        this->components_[key] = component;
+        this->checkStructureUnlocked();
+        T* component = this->componentStorage_.getPool<T>().add(this->index_, *this, std::forward<Args>(args)...);
+        if (component) {
+            size_t typeID = ComponentRegistry::id<T>();
+            this->signature_.set(typeID);
+            this->onComponentAdd(typeID, *component);
+        }
         return component;
     }
 
     template<ComponentType T>
     T* Entity::getComponent() const noexcept {
-        auto key = std::type_index(typeid(T));
-        if (this->components_.find(key) == this->components_.end()) return nullptr;
-        return dynamic_cast<T*>(this->components_.at(key));
+        size_t typeID = ComponentRegistry::find<T>();
+        if (typeID == ComponentRegistry::NPOS || !this->signature_.test(typeID)) return nullptr;
+        return this->componentStorage_.findPool<T>()->get(this->index_);
+    }
+
+    template<ComponentType T>
+    T* Entity::getComponentMut() const noexcept {
+        T* component = this->getComponent<T>();
+        if (component) {
+            component->markChanged();
+        }
+        return component;
+    }
+
+    template<ComponentType T, std::invocable<T&> Func>
+    bool Entity::patchComponent(Func&& func) {
+        T* component = this->getComponent<T>();
+        if (!component) return false;
+        const Component* outer = std::exchange(this->patchedComponent_, component);
+        try {
+            std::forward<Func>(func)(*component);
+        } catch (...) {
+            this->patchedComponent_ = outer;
+            throw;
+        }
+        this->patchedComponent_ = outer;
+        component->markChanged();
+        this->onComponentSet(ComponentRegistry::id<T>(), *component);
+        return true;
+    }
+
+    template<ComponentType T, typename... Args>
+    T* Entity::resetComponent(Args&&... args) {
+        this->checkStructureUnlocked();
+        size_t typeID = ComponentRegistry::find<T>();
+        if (typeID == ComponentRegistry::NPOS || !this->signature_.test(typeID)) return nullptr;
+        T* component;
+        try {
+            component = this->componentStorage_.findPool<T>()->reconstruct(
+                    this->index_, *this, std::forward<Args>(args)...);
+        } catch (...) {
+            this->signature_.reset(typeID);
+            this->onComponentChange(typeID);
+            throw;
+        }
+        component->markChanged();
+        this->onComponentReset(typeID, *component);
+        return component;
+    }
+
+    template<ComponentType... T>
+    bool Entity::hasComponents() const noexcept {
+        [[maybe_unused]] auto has = [this](size_t typeID) {
+            return typeID != ComponentRegistry::NPOS && this->signature_.test(typeID);
+        };
+        return (has(ComponentRegistry::find<T>()) && ...);
     }
 
     template<ComponentType T>
-    bool Entity::removeComponent() noexcept {
-        auto key = std::type_index(typeid(T));
-        if (this->components_.find(key) == this->components_.end()) return false;
-        this->components_.erase(key);
+    bool Entity::removeComponent() {
+        this->checkStructureUnlocked();
+        size_t typeID = ComponentRegistry::find<T>();
+        if (typeID == ComponentRegistry::NPOS || !this->signature_.test(typeID)) return false;
+        ComponentPool<T>* pool = this->componentStorage_.findPool<T>();
+        this->onComponentRemove(typeID, *pool->get(this->index_));
+        pool->remove(this->index_);
+        this->signature_.reset(typeID);
+        this->onComponentChange(typeID);
         return true;
     }
 }
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <corn/ecs/entity.h>
+
+namespace corn {
+    class EntityManager;
+
+    /**
+     * @class EntityCommandBuffer
+     * @brief Records structural changes to the entities and applies them later in one batch.
+     *
+     * Structural changes (creating or destroying entities, adding or removing components, and changing the active
+     * property of entities) invalidate the queries being iterated, and are not allowed during parallel passes. Systems
+     * can record these changes in the command buffer instead, which is thread-safe. The scene applies the recorded
+     * commands at its sync points, i.e. after each system when updated sequentially, or after each stage of systems
+     * when updated in parallel.
+     *
+     * Commands are applied in the order they are recorded. Entities are referred to by their IDs, so commands on
+     * entities destroyed before playback are skipped. Consecutive destructions are applied in one batch, in which
+     * entities destroyed along with their ancestors are skipped. Other commands are applied one at a time: each one
+     * updates only the queries of the component types it changes, and z-order changes only mark the siblings for
+     * sorting, which happens once in `EntityManager::tidy`.
+     *
+     * @see Scene::getCommandBuffer
+     * @see EntityManager
+     */
+    class EntityCommandBuffer {
+    public:
+        /// @brief Callback initializing a newly created entity, e.g. by adding its components.
+        using Initializer = std::function<void(Entity&)>;
+
+        /**
+         * @brief Constructor.
+         * @param entityManager The entity manager to apply the commands to.
+         */
+        explicit EntityCommandBuffer(EntityManager& entityManager) noexcept;
+
+        EntityCommandBuffer(const EntityCommandBuffer& other) = delete;
+        EntityCommandBuffer& operator=(const EntityCommandBuffer& other) = delete;
+
+        /**
+         * @brief Records the creation of an entity.
+         * @param name Name of the entity.
+         * @param parent Parent entity to attach the new entity. If value is null, will attach to the root. If the
+         *               parent is destroyed before playback, the entity is not created.
+         * @param init Callback called with the new entity right after it is created.
+         */
+        void createEntity(std::string name, const Entity* parent = nullptr, Initializer init = nullptr);
+
+        /**
+         * @brief Records the destruction of an entity.
+         * @param entity The target entity.
+         */
+        void destroy(const Entity& entity);
+
+        /**
+         * @brief Records adding a component to an entity.
+         * @tparam T Type of the component, must derive from Component class.
+         * @param entity The target entity.
+         * @param args Arguments for constructing the component (excluding the first argument Entity& entity). They
+         *             are copied (or moved) into the buffer, and must be copyable.
+         *
+         * Same as `Entity::addComponent`, the component is not replaced if one of the same type already exists.
+         */
+        template <ComponentType T, typename... Args>
+        void addComponent(const Entity& entity, Args&&... args);
+
+        /**
+         * @brief Records removing a component from an entity.
+         * @tparam T Type of the component, must derive from Component class.
+         * @param entity The target entity.
+         */
+        template <ComponentType T>
+        void removeComponent(const Entity& entity);
+
+        /**
+         * @brief Records changing the active property of an entity.
+         * @param entity The target entity.
+         * @param active The new value of the property.
+         */
+        void setActive(const Entity& entity, bool active);
+
+        /// @return Number of commands waiting to be applied.
+        [[nodiscard]] size_t size() const noexcept;
+
+        /// @return Whether there is no command waiting to be applied.
+        [[nodiscard]] bool empty() const noexcept;
+
+        /**
+         * @brief Applies all recorded commands in order, and clears the buffer.
+         *
+         * Commands recorded during playback (e.g. by initializers) are also applied before returning.
+         *
+         * @throw std::logic_error if called during a parallel pass. See `EntityManager::forEachParallel`.
+         * @throw Rethrows any exception thrown by the commands. The command that threw is discarded (along with its
+         *        batch, for destructions), and the commands after it stay in the buffer for the next playback.
+         */
+        void playback();
+
+        /// @brief Discards all recorded commands.
+        void clear() noexcept;
+
+    private:
+        /// @brief Types of the recorded commands.
+        enum class CommandType {
+            CREATE,                                // Creates an entity under the target, and calls the action on it
+            DESTROY,                               // Destroys the target
+            MODIFY,                                // Calls the action on the target
+        };
+
+        /// @brief A recorded command.
+        struct Command {
+            CommandType type;                      ///< Type of the command
+            Entity::EntityID target;               ///< ID of the target entity (parent for CREATE, 0 for root)
+            std::string name;                      ///< Name of the new entity (CREATE only)
+            std::function<void(Entity&)> action;   ///< Action on the target or the new entity
+        };
+
+        /// @brief Adds a command to the buffer. Thread-safe.
+        void record(Command command);
+
+        /// @brief The entity manager to apply the commands to.
+        EntityManager& entityManager_;
+
+        /// @brief The recorded commands.
+        std::vector<Command> commands_;
+
+        /// @brief Mutex for commands_.
+        mutable std::mutex mutex_;
+    };
+
+    template <ComponentType T, typename... Args>
+    void EntityCommandBuffer::addComponent(const Entity& entity, Args&&... args) {
+        this->record({
+                CommandType::MODIFY, entity.getID(), {},
+                [values = std::make_tuple(std::forward<Args>(args)...)](Entity& target) {
+                    std::apply([&target](const auto&... unpacked) {
+                        target.addComponent<T>(unpacked...);
+                    }, values);
+                } });
+    }
+
+    template <ComponentType T>
+    void EntityCommandBuffer::removeComponent(const Entity& entity) {
+        this->record({ CommandType::MODIFY, entity.getID(), {}, [](Entity& target) {
+            target.removeComponent<T>();
+        } });
+    }
+}
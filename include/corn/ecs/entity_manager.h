@@ -1,15 +1,36 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <ranges>
+#include <span>
 #include <string>
+#include <tuple>
+#include <typeindex>
+#include <typeinfo>
 #include <unordered_map>
 #include <vector>
 #include <corn/ecs/entity.h>
-#include <corn/event/event_scope.h>
+#include <corn/ecs/query.h>
+#include <corn/geometry/deg.h>
 #include <corn/geometry/vec2.h>
+#include <corn/util/thread_pool.h>
 
 namespace corn {
     struct CCamera;
+    struct CMovement2D;
+    struct CTransform2D;
+    class EntityView;
 
     /**
      * @class EntityManager
@@ -18,31 +39,106 @@ namespace corn {
      * The Entity Manager follows a factory pattern for managing the lifetime of Entities. It stores the Entities in
      * a tree structure. However, the root of the tree does not exist and cannot be accessed or destroyed.
      *
+     * Entities and components are allocated from a memory resource owned by the entity manager, which pools blocks
+     * of the same size and obtains its memory from an arena. When the entity manager is destroyed with its scene, the
+     * components are destroyed pool by pool and the arena is released in bulk, instead of freeing every entity and
+     * component one at a time.
+     *
      * @see Entity
      * @see Scene
      */
     class EntityManager {
     public:
-        // Entity needs access to the destroyEntity function
+        // Entity needs access to the destroyEntity function and the queries
         friend class Entity;
+        // Components record their changes
+        friend struct Component;
+        // EntityCommandBuffer needs access to the destroyEntities function
+        friend class EntityCommandBuffer;
+        // EntityView needs access to the tree traversal
+        friend class EntityView;
+        // Transforms and movements need access to the cached world transforms
+        friend struct CTransform2D;
+        friend struct CMovement2D;
+        // Movement and gravity systems read the cached world rotations in bulk
+        friend class SMovement2D;
+        friend class SGravity;
+
+        /// @brief Identifier of a component observer.
+        using ObserverID = size_t;
 
         /**
          * @struct Node
          * @brief Tree node containing each Entity.
+         *
+         * Nodes live in the entity manager's slot array and never move. The children of a node form an intrusive
+         * doubly linked list, so the tree needs no allocation per node, and attaching or detaching a subtree only
+         * relinks its root.
          */
         struct Node {
             Entity* ent;                           ///< Entity stored in the node
             Node* parent;                          ///< Parent node
-            std::vector<Node*> children;           ///< Child nodes
+            Node* firstChild;                      ///< First child node
+            Node* lastChild;                       ///< Last child node
+            Node* prevSibling;                     ///< Previous sibling node
+            Node* nextSibling;                     ///< Next sibling node
+            size_t childCount;                     ///< Number of child nodes
+            /**
+             * @brief Key ordering the node among its siblings, increasing from the first child to the last.
+             *
+             * Keys are spaced apart, so that linking a child usually only assigns its own key.
+             */
+            std::uint64_t siblingOrder;
             /**
-             * @brief Whether the node's children are sorted by their z-order (small to large)
+             * @brief Whether the node's children might not be sorted by their z-order (small to large).
              *
-             * False means it must be sorted, and true means it might not be.
+             * Dirty nodes are also listed in the entity manager, so that `tidy` only visits them.
              */
             bool dirty;
+            /**
+             * @brief Cached z-order of the entity, used as the sort key among its siblings.
+             *
+             * Entities without a transform have z-order 0.
+             */
+            int zOrder;
+            /**
+             * @brief Whether the cached world transform and movement of the node might be outdated.
+             *
+             * If a node is dirty, all its descendants are also dirty.
+             */
+            bool worldDirty;
+            /// @brief Whether the node or one of its descendants needs to be visited by the next world cache refresh.
+            bool worldPending;
+            /**
+             * @defgroup Cached world transform and movement.
+             *
+             * If the entity does not have a transform (or movement) component, they are inherited from the parent, so
+             * that they always describe the reference frame of the node's children.
+             */
+            /// @{
+            Vec2 worldLocation;                    ///< Location in the world's reference frame
+            Deg worldRotation;                     ///< Rotation in the world's reference frame
+            float worldSin;                        ///< Sine of the world rotation
+            float worldCos;                        ///< Cosine of the world rotation
+            Vec2 worldVelocity;                    ///< Linear velocity in the world's reference frame
+            float worldAngularVelocity;            ///< Angular velocity in the world's reference frame
+            /// @}
+            /**
+             * @defgroup World transform at the previous fixed tick, for render interpolation.
+             *
+             * Only valid if `hasPrevious` is true, i.e. the node existed when the last snapshot was taken.
+             */
+            /// @{
+            Vec2 prevWorldLocation;                ///< Previous location in the world's reference frame
+            Deg prevWorldRotation;                 ///< Previous rotation in the world's reference frame
+            bool hasPrevious;                      ///< Whether the previous world transform is recorded
+            /// @}
             Node(Entity* ent, Node* parent) noexcept;
         };
 
+        /// @brief Approximate number of bytes of components processed by each chunk of a parallel pass.
+        static constexpr size_t PARALLEL_CHUNK_BYTES = 32768;
+
         /// @brief Constructor.
         explicit EntityManager(Scene& scene) noexcept;
 
@@ -61,23 +157,46 @@ namespace corn {
         /// @return The root node of the Entity tree.
         [[nodiscard]] const Node* getRoot() const noexcept;
 
+        /**
+         * @return The memory resource of the scene, from which the entities and components are allocated.
+         *
+         * Other per-scene data can also be allocated from it, and is released in bulk with the scene. The resource is
+         * not thread-safe.
+         */
+        [[nodiscard]] std::pmr::memory_resource* getMemoryResource() noexcept;
+
         /**
          * @brief Creates a new entity with no components attached.
          * @param name Name of the entity. Entities can have the same name.
          * @param parent Parent entity to attach the new entity. If value is null, will attach to the root.
          * @return Pointer to the entity created.
          * @throw std::invalid_argument if parent is not a valid entity created by the entity manager.
-         *
-         * If reaches the maximum entity existing simultaneously, will result in undefined behavior.
+         * @throw std::length_error if the maximum number of entities existing simultaneously (2^32) is reached.
+         * @throw std::logic_error if called during a parallel pass. See `EntityManager::forEachParallel`.
          */
         Entity& createEntity(const std::string& name, const Entity* parent = nullptr);
 
+        /**
+         * @brief Reserves storage for the given number of new entities, so that creating them does not reallocate the
+         * internal arrays.
+         * @param count Number of new entities.
+         */
+        void reserve(size_t count);
+
+        /**
+         * @brief Reserves storage for the given number of new components of type T.
+         * @tparam T Type of the component, must derive from Component class.
+         * @param count Number of new components.
+         */
+        template <ComponentType T>
+        void reserveComponents(size_t count);
+
         /**
          * @param id ID of the entity.
          * @return Entity with the given ID, or null pointer if it doesn't exist.
          *
-         * Acquiring the entity by ID is the only method to access an entity in O(1) time complexity. All other methods
-         * require traversing the entity tree, which takes O(n) time.
+         * Acquiring the entity by ID takes O(1) time. IDs of destroyed entities are detected and result in a null
+         * pointer, even if their slots have been reused.
          */
         [[nodiscard]] Entity* getEntityByID(Entity::EntityID id) const noexcept;
 
@@ -85,7 +204,9 @@ namespace corn {
          * @param name Name of the entity.
          * @param parent Parent to start searching from.
          * @param recurse Also searches indirect descendants of parent if set to true.
-         * @return The first entity with the given name, or null pointer if it doesn't exist.
+         * @return The first entity with the given name in tree order, or null pointer if it doesn't exist.
+         *
+         * Names are indexed, so the lookup only visits the entities with the given name instead of the whole tree.
          */
         [[nodiscard]] Entity* getEntityByName(const std::string& name, const Entity* parent = nullptr, bool recurse = true) const noexcept;
 
@@ -93,11 +214,34 @@ namespace corn {
          * @param name Name of the entity.
          * @param parent Parent to start searching from.
          * @param recurse Also searches indirect descendants of parent if set to true.
-         * @return All entities with the given name.
+         * @return All entities with the given name, in tree order.
+         *
+         * Names are indexed, so the lookup only visits the entities with the given name instead of the whole tree.
          */
         [[nodiscard]] std::vector<Entity*> getEntitiesByName(
                 const std::string& name, const Entity* parent = nullptr, bool recurse = true) const noexcept;
 
+        /**
+         * @param tag Tag of the entity.
+         * @param parent Parent to start searching from.
+         * @param recurse Also searches indirect descendants of parent if set to true.
+         * @return The first entity with the given tag in tree order, or null pointer if it doesn't exist.
+         *
+         * Tags are indexed, so the lookup only visits the entities with the given tag instead of the whole tree.
+         */
+        [[nodiscard]] Entity* getEntityByTag(const std::string& tag, const Entity* parent = nullptr, bool recurse = true) const noexcept;
+
+        /**
+         * @param tag Tag of the entity.
+         * @param parent Parent to start searching from.
+         * @param recurse Also searches indirect descendants of parent if set to true.
+         * @return All entities with the given tag, in tree order.
+         *
+         * Tags are indexed, so the lookup only visits the entities with the given tag instead of the whole tree.
+         */
+        [[nodiscard]] std::vector<Entity*> getEntitiesByTag(
+                const std::string& tag, const Entity* parent = nullptr, bool recurse = true) const noexcept;
+
         /**
          * @param pred A predicate function that takes an entity pointer and returns whether it satisfy the conditions.
          * @param parent Parent to start searching from.
@@ -117,6 +261,35 @@ namespace corn {
         [[nodiscard]] std::vector<Entity*> getEntitiesThat(
                 const std::function<bool(const Entity*)>& pred, const Entity* parent = nullptr, bool recurse = true) const;
 
+        /**
+         * @param parent Parent to start searching from.
+         * @param recurse Also searches indirect descendants of parent if set to true.
+         * @return A lazy view of all entities, in tree order.
+         * @throw std::invalid_argument if parent is not a valid entity created by the entity manager.
+         *
+         * Unlike the functions returning vectors, the view does not allocate, and stops traversing the tree as soon as
+         * the iteration stops. The entities must not be created or destroyed while the view is being iterated.
+         *
+         * @example
+         * ```
+         * auto walls = entityManager.view() | std::views::filter([](const Entity* entity) {
+         *     return entity->hasComponents<Wall>();
+         * });
+         * for (Entity* entity : walls) {
+         *     ...
+         * }
+         * ```
+         */
+        [[nodiscard]] EntityView view(const Entity* parent = nullptr, bool recurse = true) const;
+
+        /**
+         * @param parent Parent to start searching from.
+         * @param recurse Also searches indirect descendants of parent if set to true.
+         * @return A lazy view of all active entities, in tree order. Inactive subtrees are skipped. See `view`.
+         * @throw std::invalid_argument if parent is not a valid entity created by the entity manager.
+         */
+        [[nodiscard]] EntityView activeView(const Entity* parent = nullptr, bool recurse = true) const;
+
         /**
          * @param parent Parent to start searching from.
          * @param recurse Also searches indirect descendants of parent if set to true.
@@ -149,6 +322,151 @@ namespace corn {
         template <ComponentType... T>
         [[nodiscard]] std::vector<Entity*> getActiveEntitiesWith(const Entity* parent = nullptr, bool recurse = true) const noexcept;
 
+        /**
+         * @brief Obtains a persistent query of active entities by their components.
+         * @tparam W Component types the entities must have, wrapped in `With<...>`.
+         * @tparam WO Component types the entities must not have, wrapped in `Without<...>`.
+         * @return The query. Created on first use and kept up to date until the entity manager is destroyed.
+         *
+         * Unlike `getActiveEntitiesWith`, which traverses the whole entity tree, the query is updated incrementally
+         * and iterating over it costs O(matches). However, the entities are not sorted by their z-order.
+         *
+         * Thread-safe, so that systems running in parallel can obtain their queries.
+         */
+        template <typename W, typename WO = Without<>>
+        Query<W, WO>& getQuery();
+
+        /**
+         * @brief Calls the function on all active entities with the list of components, in parallel.
+         * @tparam T List of type of the components, must derive from Component class. Components that are only read
+         * should be const-qualified.
+         * @param func Function taking the entity and references to its components.
+         * @throw Rethrows the first exception thrown by the function, after all entities are processed.
+         *
+         * The matching entities are split into chunks of roughly `PARALLEL_CHUNK_BYTES` bytes of components, which
+         * are processed by the global thread pool. The function must only modify the given non-const components of
+         * the given entity.
+         *
+         * The structure of the entities is locked during the pass: creating or destroying entities, adding or
+         * removing components, and changing the active property of entities will throw `std::logic_error`. Cached
+         * world transforms and movements are not updated during the pass, so `getWorldTransform` and
+         * `getWorldMovement` return the values from before the pass.
+         *
+         * @example
+         * ```
+         * entityManager.forEachParallel<CTransform2D, const CMovement2D>(
+         *         [](Entity& entity, CTransform2D& transform, const CMovement2D& movement) {
+         *     ...
+         * });
+         * ```
+         */
+        template <ComponentType... T, typename Func>
+        requires std::invocable<Func&, Entity&, T&...>
+        void forEachParallel(Func func);
+
+        /**
+         * @brief Calls the function on chunks of the active entities with the list of components, in parallel.
+         * @tparam T List of type of the components, must derive from Component class.
+         * @param func Function taking a contiguous chunk of the matching entities.
+         * @throw Rethrows the first exception thrown by the function, after all chunks are processed.
+         *
+         * Same as `forEachParallel`, except that each chunk is handed over at once, so that its components can be
+         * gathered into arrays and processed in batches (e.g. by the kernels in `corn/ecs/integration.h`). The same
+         * restrictions apply.
+         */
+        template <ComponentType... T, typename Func>
+        requires std::invocable<Func&, std::span<Entity* const>>
+        void forEachChunkParallel(Func func);
+
+        /**
+         * @brief Registers an observer called after a component of type T is added to an entity.
+         * @tparam T Type of the component, must derive from Component class.
+         * @param callback The observer, called with the owner entity and the new component.
+         * @return ID of the observer, for removing it with `removeObserver`.
+         * @throw std::logic_error if called during a parallel pass. See `EntityManager::forEachParallel`.
+         *
+         * Observers are typed hooks for keeping caches (e.g. spatial indices or render batches) in sync with the
+         * components incrementally. They are dispatched directly, without going through the event manager. Observers
+         * must not throw, and must not add or remove observers from within their callbacks.
+         *
+         * @see onRemove
+         * @see onSet
+         */
+        template <ComponentType T>
+        ObserverID onAdd(std::function<void(Entity&, T&)> callback);
+
+        /**
+         * @brief Registers an observer called before a component of type T is removed from an entity.
+         * @tparam T Type of the component, must derive from Component class.
+         * @param callback The observer, called with the owner entity and the component about to be destroyed.
+         * @return ID of the observer, for removing it with `removeObserver`.
+         * @throw std::logic_error if called during a parallel pass. See `EntityManager::forEachParallel`.
+         *
+         * Also called for the components of destroyed entities and when the entity manager is cleared, but not when
+         * the entity manager itself is destroyed.
+         */
+        template <ComponentType T>
+        ObserverID onRemove(std::function<void(Entity&, T&)> callback);
+
+        /**
+         * @brief Registers an observer called after a component of type T is assigned a value.
+         * @tparam T Type of the component, must derive from Component class.
+         * @param callback The observer, called with the owner entity and the component.
+         * @return ID of the observer, for removing it with `removeObserver`.
+         * @throw std::logic_error if called during a parallel pass. See `EntityManager::forEachParallel`.
+         *
+         * Called after the component is added (following the onAdd observers), after the setters of the built-in
+         * components, and after `Entity::patchComponent`. Setters may run in a parallel pass, in which case the
+         * observer is called from worker threads.
+         */
+        template <ComponentType T>
+        ObserverID onSet(std::function<void(Entity&, T&)> callback);
+
+        /**
+         * @brief Removes an observer.
+         * @param id ID of the observer.
+         * @return Whether the observer originally exists.
+         * @throw std::logic_error if called during a parallel pass. See `EntityManager::forEachParallel`.
+         */
+        bool removeObserver(ObserverID id);
+
+        /**
+         * @brief Calls the onSet observers of the component's type.
+         * @param component The component that has been assigned a value.
+         *
+         * Setters of custom components can call it to support onSet observers. Costs a single lookup if the type has
+         * no observers. Does nothing while the component is being patched, since `Entity::patchComponent` notifies
+         * once at the end.
+         */
+        template <ComponentType T>
+        void notifySet(T& component);
+
+        /**
+         * @return The current change tick.
+         *
+         * Components are stamped with the current tick when they are added or changed. The scene advances the tick
+         * after each system (or each stage of systems), so comparing the stamps with a previously obtained tick tells
+         * which components changed since then. See `System::getLastRunTick`.
+         */
+        [[nodiscard]] std::uint64_t getTick() const noexcept;
+
+        /**
+         * @return The change tick of the latest change to the entities or components, or 0 if nothing has changed.
+         *
+         * Covers creating and destroying entities, activating and deactivating them, adding and removing components,
+         * and components marked as changed. The game compares it between frames to detect idle scenes.
+         */
+        [[nodiscard]] std::uint64_t getLastChangeTick() const noexcept;
+
+        /**
+         * @brief Advances the change tick. Called by the scene at its sync points.
+         * @return The new tick.
+         */
+        std::uint64_t advanceTick() noexcept;
+
+        /// @return Whether the structure of the entities is locked by a parallel pass.
+        [[nodiscard]] bool isStructureLocked() const noexcept;
+
         /// @return A list of cameras components registered in this scene.
         [[nodiscard]] const std::vector<const CCamera*>& getCameras() const noexcept;
 
@@ -163,10 +481,139 @@ namespace corn {
         /// @brief Clears all entities.
         void clear() noexcept;
 
-        /// @brief Cleans up all dirty nodes. Auto-called before rendering.
+        /**
+         * @brief Records the current world transforms as the previous state for render interpolation.
+         *
+         * Called by the game before each fixed simulation tick. See `Config::fixedTimestep`.
+         */
+        void snapshotTransforms() noexcept;
+
+        /**
+         * @brief Renders an entity and its descendants at their current world transforms until the next snapshot,
+         *        instead of interpolating from the previous one.
+         * @param entity The target entity.
+         *
+         * Call it after teleporting an entity, so that it is not drawn sweeping across the screen. Activating an
+         * entity and acquiring an instance from a `PrefabPool` call it automatically.
+         */
+        void resetInterpolation(const Entity& entity) noexcept;
+
+        /// @return The interpolation factor between the previous and current world transforms used for rendering.
+        [[nodiscard]] float getInterpolationAlpha() const noexcept;
+
+        /**
+         * @brief Sets the interpolation factor used for rendering. Called by the game after the fixed ticks of a frame.
+         * @param alpha 0 renders the transforms recorded by the last snapshot, and 1 renders the current transforms.
+         *              Clamped to [0, 1].
+         */
+        void setInterpolationAlpha(float alpha) noexcept;
+
+        /**
+         * @brief Cleans up all dirty nodes. Auto-called before rendering.
+         *
+         * Sorts the children of nodes whose z-order changed, and refreshes the cached world transforms and movements
+         * top-down in a single pass. Only the nodes that changed since the last call are visited.
+         */
         void tidy() noexcept;
 
     private:
+        /// @brief Maps interned strings to the entities using them.
+        using StringIndex = std::unordered_map<std::string, std::vector<Entity*>>;
+
+        /// @brief Kinds of component observers.
+        enum class ObserverEvent { ADD, REMOVE, SET };
+
+        /// @brief A type-erased component observer.
+        struct Observer {
+            ObserverID id;                                     ///< ID of the observer
+            std::function<void(Entity&, Component&)> callback; ///< The observer, with the component cast to its type
+        };
+
+        /// @brief Observers of a component type, indexed by `ObserverEvent`.
+        using ObserverLists = std::array<std::vector<Observer>, 3>;
+
+        /**
+         * @brief Registers a type-erased observer.
+         * @param typeID ID of the component type.
+         * @param event Kind of the observer.
+         * @param callback The observer.
+         * @return ID of the observer.
+         * @throw std::logic_error if called during a parallel pass.
+         */
+        ObserverID addObserver(size_t typeID, ObserverEvent event, std::function<void(Entity&, Component&)> callback);
+
+        /// @return Whether the component type has observers of the given kind.
+        [[nodiscard]] bool hasObservers(size_t typeID, ObserverEvent event) const noexcept;
+
+        /**
+         * @brief Calls the observers of a component type.
+         * @param typeID ID of the component type.
+         * @param event Kind of the observers.
+         * @param entity The owner entity.
+         * @param component The component.
+         */
+        void notifyObservers(size_t typeID, ObserverEvent event, Entity& entity, Component& component);
+
+        /// @brief Calls the onRemove observers of all components of the entity, before the entity is destroyed.
+        void notifyRemoveAll(Entity& entity);
+
+        /**
+         * @brief Adds the entity to the name index, and points its name to the interned string.
+         * @param entity The target entity. Must not be in the name index.
+         * @param name The new name of the entity.
+         */
+        void indexName(Entity& entity, const std::string& name);
+
+        /// @brief Removes the entity from the name index.
+        void unindexName(Entity& entity) noexcept;
+
+        /**
+         * @brief Adds the tag to the entity and the entity to the tag index.
+         * @param entity The target entity. Must not have the tag.
+         * @param tag The tag.
+         */
+        void indexTag(Entity& entity, const std::string& tag);
+
+        /**
+         * @brief Removes the tag from the entity and the entity from the tag index.
+         * @param entity The target entity. Must have the tag.
+         * @param tag The tag.
+         */
+        void unindexTag(Entity& entity, const std::string& tag) noexcept;
+
+        /// @return Whether node is a child of parentNode, or also an indirect descendant if recurse is true.
+        [[nodiscard]] static bool isUnder(const Node* node, const Node* parentNode, bool recurse) noexcept;
+
+        /**
+         * @brief Helper to getEntity functions by name or tag. Scans the index without allocating.
+         * @param index The name or tag index.
+         * @param key The name or tag.
+         * @param parent Parent to start searching from.
+         * @param recurse Also searches indirect descendants of parent if set to true.
+         * @return The first matching entity in tree order, or null if there is none.
+         */
+        [[nodiscard]] Entity* getIndexedEntity(
+                const StringIndex& index, const std::string& key, const Entity* parent, bool recurse) const;
+
+        /**
+         * @brief Helper to getEntities functions by name or tag.
+         * @param index The name or tag index.
+         * @param key The name or tag.
+         * @param parent Parent to start searching from.
+         * @param recurse Also searches indirect descendants of parent if set to true.
+         * @return All matching entities in tree order.
+         */
+        [[nodiscard]] std::vector<Entity*> getIndexedEntities(
+                const StringIndex& index, const std::string& key, const Entity* parent, bool recurse) const;
+
+        /**
+         * @return Whether node a is visited before node b by a depth-first traversal of the tree, i.e. whether a is
+         *         an ancestor of b, or a comes before b among the children of their lowest common ancestor.
+         *
+         * Takes time linear in the depth of the nodes, and compares siblings by their `siblingOrder`.
+         */
+        [[nodiscard]] static bool precedesInTree(const Node* a, const Node* b) noexcept;
+
         /**
          * @brief Helper to `EntityManager::destroyEntity`
          *
@@ -174,6 +621,9 @@ namespace corn {
          */
         void destroyNode(Node* node) noexcept;
 
+        /// @brief Destroys the entity object and returns its memory to the memory resource.
+        void deleteEntity(Entity* entity) noexcept;
+
         /**
          * @brief Destroys an entity. First destroys all children before destroying itself.
          * @param entity The entity to be destroyed.
@@ -182,6 +632,22 @@ namespace corn {
          */
         void destroyEntity(Entity& entity) noexcept;
 
+        /**
+         * @brief Destroys a batch of entities.
+         * @param ids IDs of the entities. IDs of entities that no longer exist are ignored.
+         *
+         * Targets whose ancestors are also targets are destroyed along with their ancestors.
+         */
+        void destroyEntities(const std::vector<Entity::EntityID>& ids);
+
+        /**
+         * @brief Resets the node in the slot and increments the slot's generation.
+         * @param index Index of the slot.
+         *
+         * Does not delete the entity or add the slot to the free list.
+         */
+        void releaseSlot(std::uint32_t index) noexcept;
+
         /**
          * @defgroup Given a pointer to entity, return the node containing it.
          * @throw std::invalid_argument if parent is not a valid entity created by the entity manager.
@@ -198,7 +664,7 @@ namespace corn {
          * @param pred A predicate function that takes an entity pointer and returns whether it satisfy the conditions.
          *             Set it to null pointer to disable it.
          * @param onlyActive Whether to only consider active entities. See `Entity::isActiveInWorld()` for definition
-         *                   of active.
+         *                   of active. Inactive subtrees are skipped entirely.
          * @param limit Maximum number of entities to match. If set to 0, will match as much as possible.
          * @param parent Parent to start searching from.
          * @param recurse Also searches indirect descendants of parent if set to true.
@@ -208,32 +674,463 @@ namespace corn {
                 const std::function<bool(Entity*)>& pred, bool onlyActive, size_t limit,
                 const Entity* parent, bool recurse) const;
 
+        /**
+         * @brief Updates the cached z-order of the entity from its transform, and marks its parent as unsorted if the
+         * z-order changed.
+         * @param entity The target entity.
+         *
+         * Called when the z-order changes, or when a transform is added or removed.
+         */
+        void updateZOrder(const Entity& entity) noexcept;
+
+        /**
+         * @brief Marks the children of the node as unsorted, and adds the node to the list of dirty nodes.
+         * @param node The target node.
+         *
+         * Thread-safe during parallel passes.
+         */
+        void markUnsorted(Node* node) noexcept;
+
+        /**
+         * @brief Sorts the children of the node by their cached z-orders.
+         * @param node The target node.
+         *
+         * Uses insertion sort on the sibling list, which takes linear time when only a few children are out of
+         * place, and falls back to a stable sort when too many are.
+         */
+        static void sortChildren(Node& node) noexcept;
+
+        /**
+         * @brief Links the child into the children of the parent, and assigns its sibling order.
+         * @param parent The parent node.
+         * @param before The sibling to insert the child before. If null, the child is appended.
+         * @param child The child node. Must not be linked.
+         *
+         * If there is no room between the keys of the new neighbors, all children of the parent are renumbered.
+         */
+        static void linkChild(Node* parent, Node* before, Node* child) noexcept;
+
+        /// @brief Unlinks the node from the children of its parent. The parent pointer is kept.
+        static void unlinkChild(Node* child) noexcept;
+
+        /**
+         * @param node The current node.
+         * @param top Root of the subtree being traversed. Not visited.
+         * @param descend Whether to visit the descendants of the current node.
+         * @return The next node in depth-first order within the subtree, or null pointer if the traversal is done.
+         *
+         * Follows the parent and sibling links, so traversals need no stack.
+         */
+        [[nodiscard]] static Node* nextInTree(const Node* node, const Node* top, bool descend) noexcept;
+
+        /**
+         * @brief Marks the cached world transform and movement of the entity and all its descendants as outdated.
+         * @param entity The target entity.
+         *
+         * Called when the transform or movement of the entity changes. Stops at descendants that are already dirty.
+         */
+        void invalidateWorldCache(const Entity& entity) noexcept;
+
+        /**
+         * @brief Prepares for a parallel pass and locks the structure of the entities.
+         * @param accessed Whether the pass accesses the transforms or movements of the entities.
+         * @param transformed Whether the pass writes the transforms or movements of the entities.
+         *
+         * If accessed, refreshes all cached world transforms and movements so that they can be read concurrently. If
+         * transformed, also defers their invalidation until all transforming passes have ended.
+         */
+        void beginParallelPass(bool accessed, bool transformed) noexcept;
+
+        /**
+         * @brief Unlocks the structure of the entities after a parallel pass.
+         * @param entities Entities processed by the parallel pass.
+         * @param transformed Whether the pass writes the transforms or movements of the entities.
+         *
+         * If transformed, the entities are added to the pending invalidations, which are applied once no transforming
+         * pass is running anymore.
+         */
+        void endParallelPass(const std::vector<Entity*>& entities, bool transformed) noexcept;
+
+        /**
+         * @brief Helper to `EntityManager::invalidateWorldCache`.
+         *
+         * Marks the node and all its descendants as dirty, skipping subtrees that are already dirty.
+         */
+        static void markWorldDirty(Node* node) noexcept;
+
+        /**
+         * @param entity The target entity.
+         * @return The node containing the entity, with the cached world transform and movement up to date.
+         */
+        const Node& getUpdatedNode(const Entity& entity) noexcept;
+
+        /**
+         * @brief Recalculates the cached world transform and movement of a dirty node.
+         * @param node The target node.
+         *
+         * Dirty ancestors are refreshed first.
+         */
+        void refreshWorldCache(Node& node) noexcept;
+
+        /**
+         * @brief Refreshes all dirty nodes in the subtree top-down, only visiting the pending nodes.
+         * @param node Root of the subtree. Must not be dirty.
+         */
+        void refreshWorldCaches(Node& node) noexcept;
+
+        /**
+         * @brief Registers a newly created query and fills it with all matching entities.
+         * @param key Type of the query.
+         * @param query The query.
+         */
+        void addQuery(std::type_index key, std::unique_ptr<QueryBase> query);
+
+        /**
+         * @brief Updates the membership of the entity in all queries that depend on the given component type.
+         * @param entity The target entity.
+         * @param typeID ID of the type of the component added or removed.
+         */
+        void updateQueries(Entity& entity, size_t typeID);
+
+        /**
+         * @brief Updates the cached active-in-world flags of the entity and its descendants, as well as their
+         * membership in all queries.
+         * @param entity The target entity.
+         *
+         * Called when the active property of the entity changes. Only the entities whose flags actually flip are
+         * visited, so subtrees that are inactive for another reason are skipped.
+         */
+        void updateActiveInWorld(Entity& entity);
+
+        /// @brief Records that the entities or components changed at the current tick.
+        void recordChange() noexcept;
+
         /// @brief The scene that owns this entity manager.
         Scene& scene_;
 
         /// @brief The root node (does not contain a entity).
         Node root_;
 
-        /// @brief Quick access for finding nodes by entity ID (does not contain root).
-        std::unordered_map<Entity::EntityID, Node> nodes_;
+        /// @brief Arena owning all memory of the scene's entities and components. Released in bulk on destruction.
+        std::pmr::monotonic_buffer_resource arena_;
+
+        /// @brief Pools blocks of the same size on top of the arena, so that freed memory is reused.
+        std::pmr::unsynchronized_pool_resource memoryPool_;
+
+        /// @brief Storage of all components attached to the entities.
+        ComponentStorage componentStorage_;
+
+        /// @brief Entities by their names. The keys are the interned names referred to by the entities.
+        StringIndex nameIndex_;
+
+        /// @brief Entities by their tags. The keys are the interned tags referred to by the entities.
+        StringIndex tagIndex_;
+
+
+        /**
+         * @brief Slot array of all nodes, indexed by the entity index (does not contain root).
+         *
+         * Slots of destroyed entities contain no entity and are reused by new entities. A deque is used so that nodes
+         * never move in memory.
+         */
+        std::deque<Node> nodes_;
+
+        /// @brief Generation of each slot. Incremented every time the slot is freed.
+        std::vector<std::uint32_t> generations_;
+
+        /**
+         * @brief Whether the entity in each slot is active in the world. See `Entity::isActiveInWorld()`.
+         *
+         * Packed into a bitset parallel to the slots, and updated whenever an active property changes, so that
+         * inactive entities and subtrees are filtered with a single bit test.
+         */
+        std::vector<bool> activeInWorld_;
+
+        /// @brief Indices of free slots, to be reused by new entities.
+        std::vector<std::uint32_t> freeIndices_;
+
+        /// @brief Nodes whose children might not be sorted. May contain duplicates and nodes that are no longer dirty.
+        std::vector<Node*> unsortedNodes_;
+
+        /// @brief Mutex for marking nodes as unsorted during parallel passes.
+        std::mutex unsortedMutex_;
+
+        /// @brief All queries, by their type.
+        std::unordered_map<std::type_index, std::unique_ptr<QueryBase>> queries_;
 
-        /// @brief List of camera entities for quick access.
+        /// @brief All queries, indexed by the IDs of the component types they depend on.
+        std::vector<std::vector<QueryBase*>> queriesByComponent_;
+
+        /// @brief Mutex for creating queries.
+        std::mutex queryMutex_;
+
+        /// @brief Component observers, indexed by component type ID.
+        std::vector<ObserverLists> observers_;
+
+        /// @brief ID of the next observer.
+        ObserverID nextObserverID_;
+
+        /// @brief The interpolation factor between the previous and current world transforms used for rendering.
+        float interpolationAlpha_;
+
+        /// @brief The current change tick. Starts from 1, so that tick 0 precedes all changes.
+        std::uint64_t tick_;
+
+        /// @brief The change tick of the latest change. Atomic, since components may change during parallel passes.
+        std::atomic<std::uint64_t> lastChangeTick_;
+
+        /// @brief Number of parallel passes in progress. The structure of the entities is locked if positive.
+        std::atomic<size_t> parallelPasses_;
+
+        /**
+         * @brief Number of parallel passes in progress that may change transforms or movements. Invalidation of the
+         * cached world transforms and movements is deferred if positive.
+         */
+        std::atomic<size_t> transformPasses_;
+
+        /// @brief Entities processed by ended transforming passes, invalidated once all of them have ended.
+        std::vector<Entity*> pendingInvalidations_;
+
+        /// @brief Mutex lock for beginning and ending parallel passes.
+        std::mutex passMutex_;
+
+        /// @brief List of camera entities for quick access. Maintained by observers of `CCamera`.
         std::vector<const CCamera*> cameras_;
+    };
+
+    /**
+     * @class EntityView
+     * @brief Lazy, allocation-free range over the entities in a subtree, in tree order.
+     *
+     * The view walks the tree through the parent and sibling links of the nodes, and can be composed with the
+     * standard range adaptors. Obtain one with `EntityManager::view` or `EntityManager::activeView`.
+     *
+     * @see EntityManager
+     */
+    class EntityView : public std::ranges::view_interface<EntityView> {
+    public:
+        /// @brief Forward iterator over the entities.
+        class Iterator {
+        public:
+            using value_type = Entity*;
+            using difference_type = std::ptrdiff_t;
+            using iterator_concept = std::forward_iterator_tag;
+
+            /// @brief Constructs a past-the-end iterator.
+            Iterator() noexcept;
+
+            /// @return The current entity.
+            [[nodiscard]] Entity* operator*() const noexcept;
+
+            /// @brief Advances to the next entity.
+            Iterator& operator++() noexcept;
+
+            /// @brief Advances to the next entity.
+            Iterator operator++(int) noexcept;
+
+            /// @return Whether the iterators point to the same entity.
+            [[nodiscard]] bool operator==(const Iterator& other) const noexcept;
+
+        private:
+            friend class EntityView;
+
+            /// @brief Constructor.
+            Iterator(const EntityView& view, const EntityManager::Node* node) noexcept;
+
+            /// @brief Skips inactive nodes and their subtrees if the view only contains active entities.
+            void skipInactive() noexcept;
+
+            /// @brief The current node. Null if past the end.
+            const EntityManager::Node* node_;
+
+            /// @brief Root of the subtree.
+            const EntityManager::Node* top_;
+
+            /// @brief Whether to include indirect descendants of the root.
+            bool recurse_;
+
+            /// @brief Whether to only include active entities.
+            bool onlyActive_;
+        };
+
+        /// @brief Constructs an empty view.
+        EntityView() noexcept;
+
+        /**
+         * @brief Constructor.
+         * @param top Root of the subtree. Not included in the view.
+         * @param recurse Whether to include indirect descendants of the root.
+         * @param onlyActive Whether to only include active entities.
+         */
+        EntityView(const EntityManager::Node* top, bool recurse, bool onlyActive) noexcept;
+
+        /// @return Iterator to the first entity.
+        [[nodiscard]] Iterator begin() const noexcept;
+
+        /// @return Iterator past the last entity.
+        [[nodiscard]] Iterator end() const noexcept;
+
+    private:
+        /// @brief Root of the subtree.
+        const EntityManager::Node* top_;
 
-        EventScope eventScope_;
+        /// @brief Whether to include indirect descendants of the root.
+        bool recurse_;
+
+        /// @brief Whether to only include active entities.
+        bool onlyActive_;
     };
 
+    inline EntityView::Iterator::Iterator() noexcept
+            : node_(nullptr), top_(nullptr), recurse_(false), onlyActive_(false) {}
+
+    inline EntityView::Iterator::Iterator(const EntityView& view, const EntityManager::Node* node) noexcept
+            : node_(node), top_(view.top_), recurse_(view.recurse_), onlyActive_(view.onlyActive_) {
+
+        this->skipInactive();
+    }
+
+    inline Entity* EntityView::Iterator::operator*() const noexcept {
+        return this->node_->ent;
+    }
+
+    inline EntityView::Iterator& EntityView::Iterator::operator++() noexcept {
+        this->node_ = EntityManager::nextInTree(this->node_, this->top_, this->recurse_);
+        this->skipInactive();
+        return *this;
+    }
+
+    inline EntityView::Iterator EntityView::Iterator::operator++(int) noexcept {
+        Iterator result = *this;
+        ++*this;
+        return result;
+    }
+
+    inline bool EntityView::Iterator::operator==(const Iterator& other) const noexcept {
+        return this->node_ == other.node_;
+    }
+
+    inline void EntityView::Iterator::skipInactive() noexcept {
+        if (!this->onlyActive_) return;
+        while (this->node_ && !this->node_->ent->isActiveInWorld()) {
+            this->node_ = EntityManager::nextInTree(this->node_, this->top_, false);
+        }
+    }
+
+    inline EntityView::EntityView() noexcept : top_(nullptr), recurse_(false), onlyActive_(false) {}
+
+    inline EntityView::EntityView(const EntityManager::Node* top, bool recurse, bool onlyActive) noexcept
+            : top_(top), recurse_(recurse), onlyActive_(onlyActive) {}
+
+    inline EntityView::Iterator EntityView::begin() const noexcept {
+        return this->top_ ? Iterator(*this, this->top_->firstChild) : Iterator();
+    }
+
+    inline EntityView::Iterator EntityView::end() const noexcept {
+        return {};
+    }
+
+    template<typename W, typename WO>
+    Query<W, WO>& EntityManager::getQuery() {
+        auto key = std::type_index(typeid(Query<W, WO>));
+        std::lock_guard<std::mutex> lock(this->queryMutex_);
+        auto it = this->queries_.find(key);
+        if (it != this->queries_.end()) {
+            return static_cast<Query<W, WO>&>(*it->second);
+        }
+        auto* query = new Query<W, WO>();
+        this->addQuery(key, std::unique_ptr<QueryBase>(query));
+        return *query;
+    }
+
+    template <ComponentType... T, typename Func>
+    requires std::invocable<Func&, Entity&, T&...>
+    void EntityManager::forEachParallel(Func func) {
+        std::tuple<ComponentPool<std::remove_const_t<T>>*...> pools = {
+                this->componentStorage_.findPool<std::remove_const_t<T>>()... };
+        this->forEachChunkParallel<T...>([&](std::span<Entity* const> chunk) {
+            for (Entity* entity : chunk) {
+                func(*entity, *std::get<ComponentPool<std::remove_const_t<T>>*>(pools)->get(entity->index_)...);
+            }
+        });
+    }
+
+    template <ComponentType... T, typename Func>
+    requires std::invocable<Func&, std::span<Entity* const>>
+    void EntityManager::forEachChunkParallel(Func func) {
+        // Only non-const transforms and movements may be written
+        constexpr bool accessed = (... || (std::same_as<std::remove_const_t<T>, CTransform2D> ||
+                                           std::same_as<std::remove_const_t<T>, CMovement2D>));
+        constexpr bool transformed = (... || (std::same_as<T, CTransform2D> || std::same_as<T, CMovement2D>));
+        constexpr size_t chunkSize = std::max<size_t>(1, PARALLEL_CHUNK_BYTES / (sizeof(Entity*) + ... + sizeof(T)));
+
+        const std::vector<Entity*>& entities = this->getQuery<With<std::remove_const_t<T>...>>().getEntities();
+        if (entities.empty()) return;
+
+        this->beginParallelPass(accessed, transformed);
+        try {
+            ThreadPool::instance().parallelFor(entities.size(), chunkSize, [&](size_t begin, size_t end) {
+                func(std::span<Entity* const>(entities.data() + begin, end - begin));
+            });
+        } catch (...) {
+            this->endParallelPass(entities, transformed);
+            throw;
+        }
+        this->endParallelPass(entities, transformed);
+    }
+
+    template <ComponentType T>
+    EntityManager::ObserverID EntityManager::onAdd(std::function<void(Entity&, T&)> callback) {
+        return this->addObserver(ComponentRegistry::id<T>(), ObserverEvent::ADD,
+                                 [callback = std::move(callback)](Entity& entity, Component& component) {
+            callback(entity, static_cast<T&>(component));
+        });
+    }
+
+    template <ComponentType T>
+    EntityManager::ObserverID EntityManager::onRemove(std::function<void(Entity&, T&)> callback) {
+        return this->addObserver(ComponentRegistry::id<T>(), ObserverEvent::REMOVE,
+                                 [callback = std::move(callback)](Entity& entity, Component& component) {
+            callback(entity, static_cast<T&>(component));
+        });
+    }
+
+    template <ComponentType T>
+    EntityManager::ObserverID EntityManager::onSet(std::function<void(Entity&, T&)> callback) {
+        return this->addObserver(ComponentRegistry::id<T>(), ObserverEvent::SET,
+                                 [callback = std::move(callback)](Entity& entity, Component& component) {
+            callback(entity, static_cast<T&>(component));
+        });
+    }
+
+    template <ComponentType T>
+    void EntityManager::notifySet(T& component) {
+        size_t typeID = ComponentRegistry::id<T>();
+        if (!this->hasObservers(typeID, ObserverEvent::SET) || Entity::patchedComponent_ == &component) return;
+        this->notifyObservers(typeID, ObserverEvent::SET, component.getEntity(), component);
+    }
+
+    template <ComponentType T>
+    void EntityManager::reserveComponents(size_t count) {
+        ComponentPool<T>& pool = this->componentStorage_.getPool<T>();
+        pool.reserve(pool.size() + count);
+    }
+
     template<ComponentType... T>
     std::vector<Entity*> EntityManager::getEntitiesWith(const Entity* parent, bool recurse) const noexcept {
         return getEntitiesHelper([](Entity* entity) {
-            return (... && entity->getComponent<T>());
+            return entity->hasComponents<T...>();
         }, false, 0, parent, recurse);
     }
 
     template<ComponentType... T>
     std::vector<Entity*> EntityManager::getActiveEntitiesWith(const Entity* parent, bool recurse) const noexcept {
         return getEntitiesHelper([](Entity* entity) {
-            return (... && entity->getComponent<T>());
+            return entity->hasComponents<T...>();
         }, true, 0, parent, recurse);
     }
 }
+
+/// @brief Iterators of entity views do not refer to the view, so they stay valid after the view is destroyed.
+template <>
+inline constexpr bool std::ranges::enable_borrowed_range<corn::EntityView> = true;
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace corn {
+    /**
+     * @enum SimdLevel
+     * @brief Instruction sets used by the batch integration kernels.
+     */
+    enum class SimdLevel {
+        SCALAR,            ///< Portable scalar loop.
+        SSE2,              ///< 4 floats per instruction. Baseline on x86-64.
+        AVX2               ///< 8 floats per instruction. Detected at runtime.
+    };
+
+    /// @return The widest instruction set supported by both the build and the CPU.
+    [[nodiscard]] SimdLevel getSimdLevel() noexcept;
+
+    /**
+     * @struct MotionBatch
+     * @brief Structure-of-arrays batch of bodies, integrated by the batch kernels.
+     *
+     * Each array holds one property of every body, so that the kernels process several bodies per instruction.
+     * Locations, rotations, and velocities are local to the parents, while the parents' world rotations convert
+     * world-space offsets into the local space (see `CTransform2D::addWorldLocationOffset`).
+     *
+     * @see integrateMovement
+     * @see integrateGravity
+     */
+    struct MotionBatch {
+        std::vector<float> x;                                  ///< Local x coordinates
+        std::vector<float> y;                                  ///< Local y coordinates
+        std::vector<float> rotation;                           ///< Local rotations in degrees, not normalized
+        std::vector<float> vx;                                 ///< Local x velocities
+        std::vector<float> vy;                                 ///< Local y velocities
+        std::vector<float> angularVelocity;                    ///< Angular velocities in degrees per second
+        std::vector<float> gravityScale;                       ///< Scales of the gravity
+        std::vector<float> parentSin;                          ///< Sine of the parents' world rotations
+        std::vector<float> parentCos;                          ///< Cosine of the parents' world rotations
+
+        /// @brief Resizes all arrays to the given number of bodies.
+        void resize(size_t size);
+
+        /// @return Number of bodies in the batch.
+        [[nodiscard]] size_t size() const noexcept;
+    };
+
+    /**
+     * @brief Moves the bodies by their velocities, and rotates them by their angular velocities.
+     * @param batch The bodies. Uses the locations, rotations, velocities, angular velocities, and parent rotations.
+     * @param seconds Length of the time step in seconds.
+     * @param level Instruction set to use. Falls back to a narrower one if unsupported.
+     *
+     * Equivalent to calling `CTransform2D::addWorldLocationOffset(velocity * seconds)` and adding the angular velocity
+     * times the seconds to the rotation on every body, within floating-point tolerance.
+     */
+    void integrateMovement(MotionBatch& batch, float seconds, SimdLevel level = getSimdLevel()) noexcept;
+
+    /**
+     * @brief Accelerates the bodies by the gravity, which points to the positive y direction of the world.
+     * @param batch The bodies. Uses the velocities, gravity scales, and parent rotations.
+     * @param g The gravitational acceleration.
+     * @param seconds Length of the time step in seconds.
+     * @param level Instruction set to use. Falls back to a narrower one if unsupported.
+     *
+     * Equivalent to calling `CMovement2D::addWorldVelocityOffset(Vec2(0, g * scale * seconds))` on every body,
+     * within floating-point tolerance.
+     */
+    void integrateGravity(MotionBatch& batch, float g, float seconds, SimdLevel level = getSimdLevel()) noexcept;
+}
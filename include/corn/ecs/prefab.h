@@ -0,0 +1,259 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <corn/ecs/entity.h>
+#include <corn/ecs/entity_manager.h>
+
+namespace corn {
+    /**
+     * @class Prefab
+     * @brief Template of an entity subtree, with the initial values of its components.
+     *
+     * A prefab describes a root entity and its descendants, each with a list of components and the arguments for
+     * constructing them. It can be instantiated any number of times, in bulk with storage reserved up front. Use a
+     * `PrefabPool` to recycle the instances instead of destroying them.
+     *
+     * The constructor arguments of the components are copied into every instance, so they must not transfer the
+     * ownership of resources (e.g. the image pointer of `CSprite`, which is deleted by the component). Add such
+     * components to the instances instead.
+     *
+     * @example
+     * ```
+     * Prefab bullet("bullet");
+     * bullet.addComponent<CTransform2D>(Prefab::ROOT, Vec2::ZERO());
+     * bullet.addComponent<CMovement2D>(Prefab::ROOT, Vec2(0, -500));
+     * size_t trail = bullet.addChild("trail");
+     * bullet.addComponent<CTransform2D>(trail, Vec2(0, 10));
+     * std::vector<Entity*> bullets = bullet.instantiate(entityManager, 1000);
+     * ```
+     *
+     * @see PrefabPool
+     */
+    class Prefab {
+    public:
+        /// @brief Index of the root node of the prefab.
+        static constexpr size_t ROOT = 0;
+
+        /**
+         * @brief Constructor.
+         * @param name Name of the root entity.
+         */
+        explicit Prefab(std::string name);
+
+        /**
+         * @brief Adds a child entity to the template.
+         * @param name Name of the child entity.
+         * @param parent Index of the parent node.
+         * @return Index of the new node.
+         * @throw std::out_of_range if the parent node does not exist.
+         */
+        size_t addChild(std::string name, size_t parent = ROOT);
+
+        /**
+         * @brief Adds a component to a node of the template.
+         * @tparam T Type of the component, must derive from Component class.
+         * @param node Index of the node.
+         * @param args Arguments for constructing the component (excluding the first argument Entity& entity). They
+         *             are copied into the prefab, and must be copyable.
+         * @return The prefab itself.
+         * @throw std::out_of_range if the node does not exist.
+         */
+        template <ComponentType T, typename... Args>
+        Prefab& addComponent(size_t node, Args&&... args);
+
+        /// @return Number of entities in each instance.
+        [[nodiscard]] size_t size() const noexcept;
+
+        /**
+         * @brief Creates an instance of the prefab.
+         * @param entityManager The entity manager to create the entities in.
+         * @param parent Parent entity to attach the instance. If value is null, will attach to the root.
+         * @return The root entity of the instance.
+         * @throw std::logic_error if called during a parallel pass. See `EntityManager::forEachParallel`.
+         */
+        Entity& instantiate(EntityManager& entityManager, const Entity* parent = nullptr) const;
+
+        /**
+         * @brief Creates instances of the prefab in bulk.
+         * @param entityManager The entity manager to create the entities in.
+         * @param count Number of instances.
+         * @param parent Parent entity to attach the instances. If value is null, will attach to the root.
+         * @return The root entities of the instances.
+         * @throw std::logic_error if called during a parallel pass. See `EntityManager::forEachParallel`.
+         *
+         * Storage for all entities and components is reserved before creating the first instance.
+         */
+        std::vector<Entity*> instantiate(EntityManager& entityManager, size_t count, const Entity* parent = nullptr) const;
+
+        /**
+         * @brief Reserves storage for the entities and components of the given number of new instances.
+         * @param entityManager The entity manager to create the entities in.
+         * @param count Number of instances.
+         */
+        void reserve(EntityManager& entityManager, size_t count) const;
+
+    private:
+        // PrefabPool needs to track and reset the entities of the instances
+        friend class PrefabPool;
+
+        /// @brief A component of a node.
+        struct ComponentTemplate {
+            std::function<void(Entity&)> add;                  ///< Adds the component with its initial values
+            std::function<void(Entity&)> reset;                ///< Restores the initial values in place, or adds
+                                                               // the component if it has been removed
+            std::function<void(EntityManager&, size_t)> reserve; ///< Reserves storage for new components
+        };
+
+        /// @brief A node of the template.
+        struct NodeTemplate {
+            std::string name;                                  ///< Name of the entity
+            size_t parent;                                     ///< Index of the parent node (unused for root)
+            std::vector<ComponentTemplate> components;         ///< Components of the entity
+        };
+
+        /**
+         * @brief Creates an instance of the prefab.
+         * @param entityManager The entity manager to create the entities in.
+         * @param parent Parent entity to attach the instance.
+         * @param entities Output list of the entities, in the same order as the nodes.
+         */
+        void create(EntityManager& entityManager, const Entity* parent, std::vector<Entity*>& entities) const;
+
+        /**
+         * @brief Restores the components and active properties of an instance to their initial values.
+         * @param entities The entities of the instance, in the same order as the nodes. Null if destroyed.
+         *
+         * Components are constructed again in their slots, so the queries are not updated, and the observers see
+         * onSet instead of onRemove and onAdd. Components not in the prefab are kept.
+         */
+        void reset(const std::vector<Entity*>& entities) const;
+
+        /// @brief Nodes of the template. Parents are listed before their children.
+        std::vector<NodeTemplate> nodes_;
+    };
+
+    /**
+     * @class PrefabPool
+     * @brief Recycles the instances of a prefab.
+     *
+     * Released instances are deactivated instead of destroyed, and acquiring an instance reactivates a released one
+     * after resetting its components to their initial values. New instances are only created if no released instance
+     * is available. Reserving instances up front avoids creating entities during spawn bursts.
+     *
+     * The pool must not outlive the entity manager. Instances destroyed by other means are detected and dropped.
+     *
+     * @see Prefab
+     */
+    class PrefabPool {
+    public:
+        /**
+         * @brief Constructor.
+         * @param prefab The prefab.
+         * @param entityManager The entity manager to create the instances in.
+         * @param parent Parent entity to attach the instances. If value is null, will attach to the root.
+         */
+        PrefabPool(Prefab prefab, EntityManager& entityManager, const Entity* parent = nullptr);
+
+        PrefabPool(const PrefabPool& other) = delete;
+        PrefabPool& operator=(const PrefabPool& other) = delete;
+
+        /// @return The prefab.
+        [[nodiscard]] const Prefab& getPrefab() const noexcept;
+
+        /**
+         * @brief Obtains an active instance, reusing a released one if possible.
+         * @return The root entity of the instance.
+         * @throw std::logic_error if called during a parallel pass, or if the parent entity is destroyed.
+         */
+        Entity& acquire();
+
+        /**
+         * @brief Returns an instance to the pool, and deactivates it.
+         * @param root The root entity of the instance.
+         * @return Whether the instance is successfully released. False if the entity is not the root of an active
+         *         instance of this pool.
+         * @throw std::logic_error if called during a parallel pass. See `EntityManager::forEachParallel`.
+         */
+        bool release(Entity& root);
+
+        /**
+         * @brief Creates released instances until the given number of them are available.
+         * @param count Number of available instances.
+         * @throw std::logic_error if called during a parallel pass, or if the parent entity is destroyed.
+         */
+        void reserve(size_t count);
+
+        /// @return Number of released instances available for reuse.
+        [[nodiscard]] size_t available() const noexcept;
+
+    private:
+        /// @brief Bookkeeping of an instance.
+        struct Instance {
+            std::vector<Entity::EntityID> ids;                 ///< IDs of the entities, in the same order as the nodes
+            bool released;                                     ///< Whether the instance is in the pool
+        };
+
+        /**
+         * @return The parent entity of the instances, or null pointer for the root.
+         * @throw std::logic_error if the parent entity is destroyed.
+         */
+        [[nodiscard]] const Entity* getParent() const;
+
+        /**
+         * @brief Creates an instance and records it in the given slot.
+         * @param slot Index of the instance slot.
+         * @return The root entity of the instance.
+         */
+        Entity& create(size_t slot);
+
+        /// @brief The prefab.
+        Prefab prefab_;
+
+        /// @brief The entity manager to create the instances in.
+        EntityManager& entityManager_;
+
+        /// @brief ID of the parent entity, or 0 for the root.
+        Entity::EntityID parentID_;
+
+        /// @brief All instances created by the pool.
+        std::vector<Instance> instances_;
+
+        /// @brief Indices of the released instances.
+        std::vector<size_t> released_;
+
+        /// @brief Maps the index of each root entity to its instance, so that releasing needs no hashing.
+        std::vector<size_t> slotOfRoot_;
+
+        /// @brief Reusable buffer for the entities of an instance.
+        std::vector<Entity*> buffer_;
+    };
+
+    template <ComponentType T, typename... Args>
+    Prefab& Prefab::addComponent(size_t node, Args&&... args) {
+        NodeTemplate& target = this->nodes_.at(node);
+        auto values = std::make_shared<const std::tuple<std::decay_t<Args>...>>(std::forward<Args>(args)...);
+        target.components.push_back({
+                [values](Entity& entity) {
+                    std::apply([&entity](const auto&... unpacked) {
+                        entity.addComponent<T>(unpacked...);
+                    }, *values);
+                },
+                [values](Entity& entity) {
+                    std::apply([&entity](const auto&... unpacked) {
+                        if (!entity.resetComponent<T>(unpacked...)) {
+                            entity.addComponent<T>(unpacked...);
+                        }
+                    }, *values);
+                },
+                [](EntityManager& entityManager, size_t count) {
+                    entityManager.reserveComponents<T>(count);
+                } });
+        return *this;
+    }
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <ranges>
+#include <vector>
+#include <corn/ecs/component_registry.h>
+#include <corn/ecs/entity.h>
+
+namespace corn {
+    /**
+     * @brief List of component types that an entity must have to match a query.
+     * @see Query
+     */
+    template <ComponentType... T>
+    struct With {};
+
+    /**
+     * @brief List of component types that an entity must not have to match a query.
+     * @see Query
+     */
+    template <ComponentType... T>
+    struct Without {};
+
+    /**
+     * @class QueryBase
+     * @brief Type-erased base of all queries.
+     *
+     * A query keeps a list of all active entities matching its conditions. The list is maintained incrementally by the
+     * entity manager as components are added or removed and entities are created, destroyed, activated, or
+     * deactivated. Iterating over a query therefore costs O(matches) and does not allocate.
+     *
+     * The order of the entities is unspecified. The list must not be modified structurally (creating or destroying
+     * entities, adding or removing components, changing the active property) while being iterated.
+     *
+     * @see Query
+     * @see EntityManager
+     */
+    class QueryBase {
+    public:
+        using Iterator = std::vector<Entity*>::const_iterator;
+
+        /// @brief Destructor.
+        virtual ~QueryBase();
+
+        QueryBase(const QueryBase& other) = delete;
+        QueryBase& operator=(const QueryBase& other) = delete;
+
+        /// @return All entities matching the query.
+        [[nodiscard]] const std::vector<Entity*>& getEntities() const noexcept;
+
+        /// @return Number of entities matching the query.
+        [[nodiscard]] size_t size() const noexcept;
+
+        /// @return Whether no entity matches the query.
+        [[nodiscard]] bool empty() const noexcept;
+
+        /// @return Iterator to the first matching entity.
+        [[nodiscard]] Iterator begin() const noexcept;
+
+        /// @return Iterator past the last matching entity.
+        [[nodiscard]] Iterator end() const noexcept;
+
+        /// @return Whether the components of the entity satisfy the conditions of the query.
+        [[nodiscard]] bool matches(const Entity& entity) const noexcept;
+
+    protected:
+        /**
+         * @brief Constructor.
+         * @param with Component types the entities must have.
+         * @param without Component types the entities must not have.
+         */
+        QueryBase(const ComponentSignature& with, const ComponentSignature& without) noexcept;
+
+    private:
+        // EntityManager maintains the list of entities
+        friend class EntityManager;
+
+        /**
+         * @brief Adds or removes the entity from the list according to the conditions.
+         * @param entity The target entity.
+         * @param activeInWorld Whether the entity is active in the world.
+         */
+        void update(Entity& entity, bool activeInWorld);
+
+        /// @brief Removes the entity from the list.
+        void erase(const Entity& entity) noexcept;
+
+        /// @brief Removes all entities from the list.
+        void clear() noexcept;
+
+        /// @brief Component types the entities must have.
+        const ComponentSignature with_;
+
+        /// @brief Component types the entities must not have.
+        const ComponentSignature without_;
+
+        /// @brief List of matching entities.
+        std::vector<Entity*> entities_;
+
+        /// @brief Maps the index of the entity to its position in the list.
+        std::vector<size_t> positions_;
+    };
+
+    template <typename W, typename WO = Without<>>
+    class Query;
+
+    /**
+     * @class Query
+     * @brief Persistent list of active entities that have all components in W and none of the components in WO.
+     * @tparam W Component types the entities must have.
+     * @tparam WO Component types the entities must not have.
+     *
+     * Queries are created and owned by the entity manager. Use `EntityManager::getQuery` to obtain one.
+     *
+     * @example
+     * ```
+     * auto& query = entityManager.getQuery<With<CTransform2D, CMovement2D>, Without<CGravity2D>>();
+     * for (Entity* entity : query) {
+     *     ...
+     * }
+     * ```
+     */
+    template <ComponentType... W, ComponentType... WO>
+    class Query<With<W...>, Without<WO...>> : public QueryBase {
+    public:
+        /// @brief Constructor.
+        Query() : QueryBase(ComponentRegistry::signature<W...>(), ComponentRegistry::signature<WO...>()) {}
+
+        /**
+         * @tparam T Type of the component, must be one of the types in W.
+         * @param tick The change tick to compare against, usually `System::getLastRunTick`.
+         * @return Lazy view of the matching entities whose component T was changed or added at or after the tick.
+         */
+        template <ComponentType T> requires (std::same_as<T, W> || ...)
+        [[nodiscard]] auto changedSince(std::uint64_t tick) const {
+            return this->getEntities() | std::views::filter([tick](const Entity* entity) {
+                return entity->getComponent<T>()->isChangedSince(tick);
+            });
+        }
+    };
+}
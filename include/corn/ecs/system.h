@@ -1,6 +1,18 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+#include <corn/ecs/entity.h>
+
 namespace corn {
+    struct AABB;
+    class Broadphase;
+    struct CBBox;
+    struct CollisionFilter;
     class Game;
     class Scene;
 
@@ -10,6 +22,13 @@ namespace corn {
      *
      * All systems must implement the update function, which will be called once every game loop.
      *
+     * Systems may declare the component types they read and write by calling `reads` and `writes` in the constructor.
+     * The scene runs systems whose declared accesses do not conflict in parallel. A system that declares its accesses
+     * must not access other components, create or destroy entities, add or remove components, change the active
+     * property of entities or systems, or emit events during its update. Structural changes to the entities can still
+     * be recorded in the scene's command buffer (see `Scene::getCommandBuffer`), which applies them after the stage.
+     * Systems that do not declare any access are exclusive, meaning they always run alone and can do all of the above.
+     *
      * @see Entity
      * @see EntityManager
      * @see Component
@@ -40,24 +59,90 @@ namespace corn {
         /// @return The game that contains this system.
         [[nodiscard]] const Game* getGame() const noexcept;
 
+        /// @return Whether the system runs alone, i.e. has not declared its accesses.
+        [[nodiscard]] bool isExclusive() const noexcept;
+
+        /// @return Component types read by the system.
+        [[nodiscard]] const std::vector<std::type_index>& getReads() const noexcept;
+
+        /// @return Component types written by the system.
+        [[nodiscard]] const std::vector<std::type_index>& getWrites() const noexcept;
+
+        /**
+         * @return Whether the two systems cannot run in parallel.
+         *
+         * Two systems conflict if either is exclusive, or if one writes a component type that the other reads or
+         * writes.
+         */
+        [[nodiscard]] bool conflictsWith(const System& other) const noexcept;
+
+        /**
+         * @return The change tick right after the previous update of the system, or 0 if the system has not run.
+         *
+         * Components changed at or after this tick were changed after the previous update, by other systems or by
+         * code running between frames. Changes made by the system itself during its update are excluded.
+         *
+         * @see Query::changedSince
+         */
+        [[nodiscard]] std::uint64_t getLastRunTick() const noexcept;
+
         /**
          * @brief If active, will be called repeatedly during game loop.
          * @param millis Number of milliseconds elapsed.
          */
         virtual void update(float millis) = 0;
 
+    protected:
+        /**
+         * @brief Declares the component types that the system reads.
+         * @tparam T Types of the components.
+         */
+        template <ComponentType... T>
+        void reads();
+
+        /**
+         * @brief Declares the component types that the system writes. Writing implies reading.
+         * @tparam T Types of the components.
+         */
+        template <ComponentType... T>
+        void writes();
+
     private:
+        // Scene records the change tick after each update
+        friend class Scene;
+
+        /**
+         * @brief Helper to `System::reads` and `System::writes`.
+         * @param types Types of the components.
+         * @param write Whether the components are written.
+         */
+        void declareAccess(const std::vector<std::type_index>& types, bool write);
+
         /// @brief The Scene that owns this system.
         Scene& scene_;
 
         /// @brief The update function will only be called if the system is active.
         bool active_;
+
+        /// @brief Whether the system has not declared its accesses.
+        bool exclusive_;
+
+        /// @brief Component types read by the system.
+        std::vector<std::type_index> reads_;
+
+        /// @brief Component types written by the system.
+        std::vector<std::type_index> writes_;
+
+        /// @brief The change tick right after the previous update of the system.
+        std::uint64_t lastRunTick_;
     };
 
     /**
      * @class SMovement2D
      * @brief Moves Entities in the 2D world.
      *
+     * Each chunk of entities is gathered into a `MotionBatch` and integrated by the SIMD kernels.
+     *
      * @see System
      * @see CMovement2D
      * @see CTransform2D
@@ -81,6 +166,8 @@ namespace corn {
      * @class SGravity
      * @brief Applies gravity to the Entities in both 2D and 3D world.
      *
+     * Each chunk of entities is gathered into a `MotionBatch` and integrated by the SIMD kernels.
+     *
      * @see System
      * @see CMovement2D
      * @see CGravity2D
@@ -108,6 +195,44 @@ namespace corn {
         void update(float millis) override;
     };
 
+    /**
+     * @brief Algorithms for finding the candidate pairs of colliders.
+     *
+     * SWEEP_AND_PRUNE: Sorts the colliders along the x-axis. Works well in most cases.
+     * SPATIAL_HASH: Hashes the colliders into a uniform grid. Works well when the colliders have similar sizes.
+     * AABB_TREE: Keeps the colliders in a dynamic bounding volume hierarchy. Works well when most colliders are
+     * static or move slowly, or when their sizes vary a lot.
+     */
+    enum class BroadphaseType {
+        SWEEP_AND_PRUNE, SPATIAL_HASH, AABB_TREE
+    };
+
+    /**
+     * @brief Phase of a contact between two colliders.
+     *
+     * BEGIN: The colliders start to overlap in this frame.
+     * PERSIST: The colliders overlapped in the previous frame and still overlap.
+     * END: The colliders overlapped in the previous frame but no longer do, or one of them was removed or deactivated.
+     */
+    enum class ContactPhase {
+        BEGIN, PERSIST, END
+    };
+
+    /**
+     * @struct CollisionContact
+     * @brief A contact between two colliders in one frame.
+     *
+     * The collider pointers are valid until the colliders are removed. For contacts in the END phase, they are null
+     * pointers if the collider no longer exists at the time of detection.
+     */
+    struct CollisionContact {
+        Entity::EntityID entity1;                  ///< ID of the owner of the first collider, smaller than entity2
+        Entity::EntityID entity2;                  ///< ID of the owner of the second collider
+        CBBox* collider1;                          ///< First collider
+        CBBox* collider2;                          ///< Second collider
+        ContactPhase phase;                        ///< Phase of the contact
+    };
+
     /**
      * @class SCollisionDetection
      * @brief Detects and resolves collision.
@@ -115,22 +240,107 @@ namespace corn {
      * The system retrieves all Entities with a position and collision detection component and detects any collision
      * between them. If detected, it will invoke any collision resolvers attached to either Entity.
      *
+     * The world AABB of each collider is computed once per frame. A broadphase then finds the candidate pairs, and only
+     * these pairs go through the exact overlap test. Pairs whose layers and masks do not interact (see `CBBox`) are
+     * rejected inside the broadphase, before the overlap test. Collisions are reported in a deterministic order regardless of the
+     * broadphase.
+     *
+     * Overlapping pairs are compared against those of the previous frame to build a contact buffer, in which every
+     * contact is classified as beginning, persisting, or ending. Consumers can either read the buffer directly with
+     * `getContacts`, or listen to the `EventArgsContacts` event emitted once per frame. Emitting one
+     * `EventArgsCollision` per overlapping pair is kept for compatibility, and can be turned off with
+     * `emitCollisionEvents` when there are many persistent contacts.
+     *
      * @see System
-     * @see CAABB
-     * @see CCollisionResolve
+     * @see CBBox
+     * @see BroadphaseType
      */
     class SCollisionDetection : public System {
     public:
+        /// @brief Amount by which the colliders are fattened in the AABB tree, so that small moves need no update.
+        static constexpr float AABB_TREE_MARGIN = 8.0f;
+
+        /// @brief Whether to emit an `EventArgsCollision` for every overlapping pair (BEGIN and PERSIST contacts).
+        bool emitCollisionEvents;
+
+        /// @brief Whether to emit an `EventArgsContacts` with all contacts once per frame, if there is any contact.
+        bool emitContactsEvent;
+
         /**
          * @brief Constructor.
          * @param scene Target scene to attach to.
+         * @param broadphase Algorithm for finding the candidate pairs.
+         * @param cellSize Width and height of the cells in the spatial hash. Should be about the size of a typical
+         * collider. Unused by the other broadphases, but must still be positive and finite.
+         * @throw std::invalid_argument if cellSize is not positive and finite.
+         */
+        explicit SCollisionDetection(
+                Scene& scene, BroadphaseType broadphase = BroadphaseType::SWEEP_AND_PRUNE, float cellSize = 128.0f);
+
+        /// @brief Destructor.
+        ~SCollisionDetection() override;
+
+        /// @return The algorithm for finding the candidate pairs.
+        [[nodiscard]] BroadphaseType getBroadphase() const noexcept;
+
+        /**
+         * @brief Changes the algorithm for finding the candidate pairs.
+         * @param broadphase The new algorithm. The spatial hash uses the cell size given to the constructor.
+         */
+        void setBroadphase(BroadphaseType broadphase);
+
+        /**
+         * @return All contacts found in the last update, sorted by the IDs of their owners.
+         *
+         * The buffer is overwritten by the next update.
          */
-        explicit SCollisionDetection(Scene& scene) noexcept;
+        [[nodiscard]] const std::vector<CollisionContact>& getContacts() const noexcept;
 
         /**
          * @brief Detects all collisions and emit events.
          * @param millis Number of milliseconds elapsed.
          */
         void update(float millis) override;
+
+    private:
+        /// @brief Type of the broadphase.
+        BroadphaseType broadphaseType_;
+
+        /// @brief Width and height of the cells in the spatial hash.
+        float cellSize_;
+
+        /// @brief The broadphase.
+        std::unique_ptr<Broadphase> broadphase_;
+
+        /// @brief Colliders found in the current frame, kept to avoid reallocating every frame.
+        std::vector<CBBox*> colliders_;
+
+        /// @brief IDs of the owners of the colliders.
+        std::vector<Entity::EntityID> colliderIDs_;
+
+        /// @brief World AABBs of the colliders.
+        std::vector<AABB> boxes_;
+
+        /// @brief Collision layers and masks of the colliders.
+        std::vector<CollisionFilter> filters_;
+
+        /// @brief Candidate pairs found by the broadphase.
+        std::vector<std::pair<size_t, size_t>> pairs_;
+
+        /// @brief Contacts found in the last update.
+        std::vector<CollisionContact> contacts_;
+
+        /// @brief Contacts being built in the current update, swapped with contacts_ afterward.
+        std::vector<CollisionContact> nextContacts_;
     };
+
+    template <ComponentType... T>
+    void System::reads() {
+        this->declareAccess({ std::type_index(typeid(T))... }, false);
+    }
+
+    template <ComponentType... T>
+    void System::writes() {
+        this->declareAccess({ std::type_index(typeid(T))... }, true);
+    }
 }
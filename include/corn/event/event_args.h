@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <corn/event/input.h>
 #include <corn/geometry/vec2.h>
 
@@ -275,6 +276,22 @@ namespace corn {
         EventArgsCollision(CBBox* collider1, CBBox* collider2) noexcept;
     };
 
+    struct CollisionContact;
+
+    /**
+     * @class EventArgsContacts
+     * @brief Emits once per frame with all collision contacts (beginning, persisting, and ending) of the frame.
+     */
+    struct EventArgsContacts : public EventArgs {
+        [[nodiscard]] std::string type() const noexcept override { return "corn::game::contacts"; }
+
+        /// @brief All contacts, sorted by the IDs of the owners of the colliders. Owned by the collision system.
+        const std::vector<CollisionContact>& contacts;
+
+        /// @brief Constructor.
+        explicit EventArgsContacts(const std::vector<CollisionContact>& contacts) noexcept;
+    };
+
     class UIWidget;
 
     /**
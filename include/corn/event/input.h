@@ -1,5 +1,7 @@
 #pragma once
 
+#include <corn/geometry/vec2.h>
+
 namespace corn {
     /**
      * @class Key
@@ -31,4 +33,57 @@ namespace corn {
     enum class ButtonEvent {
         DOWN, UP,
     };
+
+    /**
+     * @class InputType
+     * @brief Types of user input received by the interface.
+     */
+    enum class InputType : unsigned char {
+        EXIT,              ///< User closes the window.
+        KEYBOARD,          ///< User presses or releases a key.
+        MOUSE_BUTTON,      ///< User presses or releases a mouse button.
+        MOUSE_MOVE,        ///< User moves the cursor.
+        MOUSE_SCROLL,      ///< User scrolls the mouse wheel.
+        TEXT,              ///< User enters a character.
+    };
+
+    /**
+     * @class InputEvent
+     * @brief A single user input, independent of the window backend.
+     *
+     * The interface converts the window's events into input events, and emits them as the corresponding event
+     * arguments (see `EventArgsKeyboard`, `EventArgsMouseButton`, etc.). Input events can also be simulated, e.g. to
+     * drive a headless game. Fields not used by the type of the input are left as default.
+     *
+     * @see Game::simulateInput
+     */
+    struct InputEvent {
+        InputType type = InputType::EXIT;                      ///< Type of the input
+        Key key = Key::NONE;                                   ///< The key (keyboard)
+        Mouse mouse = Mouse::NONE;                             ///< The mouse button (mouse button)
+        ButtonEvent status = ButtonEvent::DOWN;                ///< Pressed or released (keyboard, mouse button)
+        unsigned char modifiers = 0;                           ///< Modifier keys, see `EventArgsKeyboard::modifiers`
+        Vec2 mousePos;                                         ///< Location of the mouse (keyboard, mouse)
+        float value = 0.0f;                                    ///< The amount scrolled (mouse scroll)
+        unsigned int unicode = 0;                              ///< Unicode of the entered character (text)
+
+        /// @return Input of the user closing the window.
+        [[nodiscard]] static InputEvent exit() noexcept;
+
+        /// @return Input of the user pressing or releasing a key.
+        [[nodiscard]] static InputEvent keyboard(
+                Key key, ButtonEvent status, unsigned char modifiers = 0, const Vec2& mousePos = Vec2::ZERO()) noexcept;
+
+        /// @return Input of the user pressing or releasing a mouse button.
+        [[nodiscard]] static InputEvent mouseButton(Mouse mouse, ButtonEvent status, const Vec2& mousePos) noexcept;
+
+        /// @return Input of the user moving the cursor.
+        [[nodiscard]] static InputEvent mouseMove(const Vec2& mousePos) noexcept;
+
+        /// @return Input of the user scrolling the mouse wheel.
+        [[nodiscard]] static InputEvent mouseScroll(float value, const Vec2& mousePos) noexcept;
+
+        /// @return Input of the user entering a character.
+        [[nodiscard]] static InputEvent text(unsigned int unicode) noexcept;
+    };
 }
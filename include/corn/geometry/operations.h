@@ -152,6 +152,8 @@ namespace corn {
 
     /// @brief Rotate a 2D point.
     [[nodiscard]] Vec2 rotate(const Vec2& point, const Deg& deg) noexcept;
+    /// @brief Rotate a 2D point given the precomputed sine and cosine of the angle.
+    [[nodiscard]] Vec2 rotate(const Vec2& point, float sin, float cos) noexcept;
     /// @brief Rotate a 3D point.
     [[nodiscard]] Vec3 rotate(const Vec3& point, const Quaternion& quaternion) noexcept;
 
@@ -1,12 +1,13 @@
 #pragma once
 
+#include <queue>
 #include <unordered_map>
+#include <corn/event/input.h>
 
 namespace corn {
-    enum class Key;
-
     struct CCamera;
     class Game;
+    class InputRecorder;
     class Scene;
     class UIManager;
 
@@ -14,6 +15,9 @@ namespace corn {
      * @class Interface
      * @brief Receives input from the user and renders entities and UI to the window.
      *
+     * If `Config::headless` is set, no window is created and nothing is rendered. Simulated input is still handled,
+     * so that the scenes can run on machines without a display.
+     *
      * @see Game
      */
     class Interface {
@@ -27,10 +31,10 @@ namespace corn {
         Interface(const Interface& other) = delete;
         Interface& operator=(const Interface& other) = delete;
 
-        /// @brief Creates the window and initializes resources.
+        /// @brief Creates the window and initializes resources. Closes the window instead if headless.
         void init();
 
-        /// @return The current size of the window in pixels.
+        /// @return The current size of the window in pixels. If headless, the size in the config.
         [[nodiscard]] Vec2 windowSize() const noexcept;
 
         /**
@@ -38,8 +42,25 @@ namespace corn {
          *
          * Keyboard and mouse input will only be emitted to the top scene's event room. Other events (such as close
          * event) will be emitted to the root without propagation.
+         *
+         * Simulated input is handled after the input from the window, in the order it was simulated. While replaying
+         * (see `Config::replayInput`), input from the window other than closing it is ignored.
+         *
+         * @return Whether any input was received.
+         */
+        bool handleUserInput();
+
+        /**
+         * @brief Queues an input to be handled with the user input of the next frame.
+         * @param input The simulated input.
+         */
+        void simulateInput(const InputEvent& input);
+
+        /**
+         * @brief Sets the recorder of the handled input.
+         * @param recorder The recorder, or null to stop recording. Not owned by the interface.
          */
-        void handleUserInput() const;
+        void setRecorder(InputRecorder* recorder) noexcept;
 
         /// @brief Clears the contents on the window.
         void clear();
@@ -60,6 +81,15 @@ namespace corn {
         void update();
 
     private:
+        /**
+         * @brief Emits the events of an input, and updates the state of the keys.
+         * @param input The input to handle.
+         */
+        void dispatchInput(const InputEvent& input) const;
+
+        /// @return Whether the interface runs without a window.
+        [[nodiscard]] bool isHeadless() const noexcept;
+
         /**
          * @param camera The target camera component.
          * @return The transformation (offset and scale) that defines how to transform coordinates from the world's
@@ -86,6 +116,12 @@ namespace corn {
         /// @brief Reference to the map that stores the state of all keys.
         std::unordered_map<Key, bool>& keyPressed_;
 
+        /// @brief Simulated input to be handled in the next frame.
+        std::queue<InputEvent> simulatedInput_;
+
+        /// @brief Records the handled input if not null.
+        InputRecorder* recorder_;
+
         /// @brief Pimpl idiom.
         class InterfaceImpl;
         InterfaceImpl* impl_;
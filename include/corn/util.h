@@ -5,6 +5,7 @@
 #include <corn/util/constants.h>
 #include <corn/util/exceptions.h>
 #include <corn/util/expression.h>
+#include <corn/util/frame_limiter.h>
 #include <corn/util/rich_text.h>
 #include <corn/util/stopwatch.h>
 #include <corn/util/string_utils.h>
@@ -31,5 +31,33 @@ namespace corn {
         Color background = Color::rgb(0, 0, 0);       ///< Background color of the game window
         DisplayMode mode = DisplayMode::WINDOWED;              ///< Display mode
         int antialiasing = 1;                                  ///< Antialiasing level (power of 2, depends on hardware)
+        float fixedTimestep = 0.0f;                            ///< Length of a fixed simulation tick (in milliseconds)
+                                                               // If 0, scenes are updated once per frame instead
+        size_t maxTicksPerFrame = 5;                           ///< Maximum number of fixed ticks per frame
+                                                               // Time beyond that is dropped instead of caught up
+        bool interpolation = true;                             ///< Whether to interpolate the rendered transforms
+                                                               // between the previous and current fixed ticks
+        size_t targetFps = 0;                                  ///< Maximum number of frames per second
+                                                               // If 0, frames are not limited
+        bool vsync = false;                                    ///< Whether to synchronize frames with the monitor
+        size_t idleFps = 0;                                    ///< Frames per second while the game is idle
+                                                               // Idle means no input and no scene changes. If 0, the
+                                                               // frame rate is never lowered. See Scene::requestFrame
+        float idleDelay = 1000.0f;                             ///< Time without activity before going idle (in ms)
+        float spinThreshold = 2.0f;                            ///< Time before a frame deadline spent spinning instead
+                                                               // of sleeping (in milliseconds), for accurate pacing
+        bool headless = false;                                 ///< Whether to run without a window
+                                                               // Nothing is rendered, and input can only be simulated
+        float timeScale = 1.0f;                                ///< Speed of the game clock relative to real time
+        float virtualFrameTime = 0.0f;                         ///< Length of every frame on the game clock (in ms)
+                                                               // If positive, replaces the real elapsed time and the
+                                                               // time scale, so that frames run as fast as allowed
+        std::string recordInput;                               ///< File to record the input and frame times to
+                                                               // If empty, nothing is recorded
+        std::string replayInput;                               ///< File to replay the input and frame times from
+                                                               // If set, input from the window other than closing it
+                                                               // is ignored, and the game ends with the replay
+        bool replayRealTime = true;                            ///< Whether to wait for the recorded wall-clock times
+                                                               // If false, the replay runs as fast as allowed
     };
 }
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+
+namespace corn {
+    /**
+     * @class FrameLimiter
+     * @brief Paces a loop to a target frame length without pinning a CPU core.
+     *
+     * Each call to `wait` blocks until the deadline of the current frame. Most of the wait is spent sleeping, and only
+     * the last few milliseconds are spent spinning, since sleeping alone overshoots by up to the scheduler's
+     * granularity. Deadlines advance by exactly one frame length, so that the small errors of each wait do not add up.
+     */
+    class FrameLimiter {
+    public:
+        /**
+         * @brief Constructor.
+         * @param spinThreshold Time before the deadline spent spinning instead of sleeping (in milliseconds).
+         */
+        explicit FrameLimiter(float spinThreshold = 2.0f) noexcept;
+
+        /**
+         * @brief Waits until the current frame has lasted for the given length.
+         * @param frameMillis Target length of a frame (in milliseconds). Returns immediately if not positive.
+         *
+         * If the loop falls behind by more than a frame, the deadlines restart from now instead of rushing through
+         * the frames that were missed.
+         */
+        void wait(float frameMillis);
+
+        /// @brief Starts the next frame from now, e.g. after a pause or a change of frame rate.
+        void reset() noexcept;
+
+        /// @return Time before the deadline spent spinning instead of sleeping (in milliseconds).
+        [[nodiscard]] float getSpinThreshold() const noexcept;
+
+        /// @param spinThreshold Time before the deadline spent spinning instead of sleeping (in milliseconds).
+        void setSpinThreshold(float spinThreshold) noexcept;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        /// @brief Time before the deadline spent spinning instead of sleeping.
+        Clock::duration spinThreshold_;
+
+        /// @brief Time when the current frame started.
+        Clock::time_point frameStart_;
+    };
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace corn {
+    /**
+     * @class ThreadPool
+     * @brief A work-stealing pool of worker threads.
+     *
+     * Each worker owns a queue of jobs. Workers take jobs from the back of their own queue, and steal jobs from the
+     * front of other queues when they run out of work. The thread submitting the jobs also takes part in executing
+     * them, so jobs submitted from inside a job (e.g. a parallel loop inside a parallel system) never deadlock.
+     *
+     * Submitting is synchronous: `run` and `parallelFor` only return after all submitted jobs are finished.
+     */
+    class ThreadPool {
+    public:
+        using Task = std::function<void()>;
+
+        /**
+         * @brief Constructor.
+         * @param threadCount Number of worker threads. If 0, all jobs run on the calling thread.
+         */
+        explicit ThreadPool(size_t threadCount);
+
+        /// @brief Destructor. Waits for the worker threads to exit.
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool& other) = delete;
+        ThreadPool& operator=(const ThreadPool& other) = delete;
+
+        /**
+         * @return The global thread pool.
+         *
+         * The global pool has one worker thread less than the number of hardware threads, as the calling thread also
+         * executes jobs.
+         */
+        [[nodiscard]] static ThreadPool& instance();
+
+        /// @return Number of worker threads (excluding the calling thread).
+        [[nodiscard]] size_t getThreadCount() const noexcept;
+
+        /**
+         * @brief Runs all tasks and waits for them to finish.
+         * @param tasks The tasks. The order of execution is unspecified.
+         * @throw Rethrows the first exception thrown by the tasks, after all tasks are finished.
+         */
+        void run(const std::vector<Task>& tasks);
+
+        /**
+         * @brief Splits the range [0, count) into chunks and processes them in parallel.
+         * @param count Number of elements.
+         * @param chunkSize Maximum number of elements in each chunk. Must be positive.
+         * @param func Function processing the elements in the range [begin, end).
+         * @throw Rethrows the first exception thrown by the function, after all chunks are finished.
+         */
+        void parallelFor(size_t count, size_t chunkSize, const std::function<void(size_t begin, size_t end)>& func);
+
+    private:
+        /// @brief Tracks the progress of the tasks submitted by one call to `run`.
+        struct Batch {
+            std::atomic<size_t> remaining;             ///< Number of unfinished tasks
+            std::exception_ptr error;                  ///< First exception thrown by the tasks
+            std::mutex errorMutex;                     ///< Mutex for error
+        };
+
+        /// @brief A task waiting to be executed.
+        struct Job {
+            const Task* task;                          ///< Task to execute
+            Batch* batch;                              ///< Batch that the task belongs to
+        };
+
+        /// @brief Queue of jobs owned by one thread.
+        struct Queue {
+            std::deque<Job> jobs;                      ///< The jobs
+            std::mutex mutex;                          ///< Mutex for jobs
+        };
+
+        /// @brief Main loop of the worker threads.
+        void work(size_t index);
+
+        /**
+         * @brief Takes a job from the given queue, or steals one from another queue, and executes it.
+         * @param index Index of the queue owned by the current thread.
+         * @return Whether a job is executed.
+         */
+        bool runOne(size_t index);
+
+        /// @brief Executes a job and records its completion.
+        void execute(const Job& job) noexcept;
+
+        /// @return Index of the queue owned by the calling thread.
+        [[nodiscard]] size_t getQueueIndex() const noexcept;
+
+        /**
+         * @brief Queues of jobs, one for each worker thread.
+         *
+         * The last queue is shared by all threads outside the pool.
+         */
+        std::vector<std::unique_ptr<Queue>> queues_;
+
+        /// @brief The worker threads.
+        std::vector<std::thread> threads_;
+
+        /// @brief Number of jobs waiting in all queues.
+        std::atomic<size_t> queued_;
+
+        /// @brief Whether the worker threads should exit.
+        bool stop_;
+
+        /// @brief Mutex for sleeping and waking up threads.
+        std::mutex mutex_;
+
+        /// @brief Notified when new jobs are queued.
+        std::condition_variable jobAvailable_;
+
+        /// @brief Notified when a batch finishes.
+        std::condition_variable batchFinished_;
+    };
+}
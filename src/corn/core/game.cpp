@@ -1,10 +1,17 @@
+#include <algorithm>
+#include <cmath>
 #include <corn/core/game.h>
+#include <corn/core/input_log.h>
 #include <corn/core/scene.h>
+#include <corn/ecs/entity_manager.h>
 #include <corn/media/interface.h>
 
 namespace corn {
     Game::Game(Scene* startScene, Config config)
-            : active_(false), config_(std::move(config)), scenes_(), keyPressed_(), sw_(), debugOverlayEnabled_(false) {
+            : active_(false), config_(std::move(config)), scenes_(), interface_(nullptr), recorder_(nullptr),
+            replayer_(nullptr), keyPressed_(), sw_(), accumulator_(0.0f),
+            frameLimiter_(config_.spinThreshold), idleMillis_(0.0f), lastSeenChangeTick_(0),
+            debugOverlayEnabled_(false) {
 
         startScene->game_ = this;
         this->scenes_.push(startScene);
@@ -28,6 +35,8 @@ namespace corn {
 
     Game::~Game() {
         // Deallocation
+        delete this->recorder_;
+        delete this->replayer_;
         delete this->interface_;
         this->removeAllScenes();
         while (!this->sceneEvents_.empty()) {
@@ -42,6 +51,7 @@ namespace corn {
 
     void Game::setConfig(Config config) {
         this->config_ = std::move(config);
+        this->frameLimiter_.setSpinThreshold(this->config_.spinThreshold);
         this->interface_->init();
     }
 
@@ -61,6 +71,10 @@ namespace corn {
         return this->keyPressed_.contains(key) && this->keyPressed_.at(key);
     }
 
+    void Game::simulateInput(const InputEvent& input) {
+        this->interface_->simulateInput(input);
+    }
+
     void Game::changeScene(corn::SceneOperation op, corn::Scene* scene) noexcept {
         switch (op) {
             case SceneOperation::PUSH:  // Add new scene to top
@@ -113,8 +127,86 @@ namespace corn {
         }
     }
 
+    void Game::updateScene(float millis) {
+        Scene* scene = this->scenes_.top();
+        float timestep = this->config_.fixedTimestep;
+        if (timestep <= 0.0f) {
+            scene->update(millis);
+            return;
+        }
+
+        EntityManager& entityManager = scene->getEntityManager();
+        size_t maxTicks = std::max<size_t>(1, this->config_.maxTicksPerFrame);
+        this->accumulator_ += millis;
+        for (size_t ticks = 0; this->accumulator_ >= timestep && ticks < maxTicks && this->active_; ticks++) {
+            if (this->config_.interpolation) {
+                entityManager.snapshotTransforms();
+            }
+            scene->update(timestep);
+            this->accumulator_ -= timestep;
+        }
+        // Drop the whole ticks that cannot be caught up with, so that a slow frame does not slow down the next ones
+        if (this->accumulator_ >= timestep) {
+            this->accumulator_ = std::fmod(this->accumulator_, timestep);
+        }
+        entityManager.setInterpolationAlpha(this->config_.interpolation ? this->accumulator_ / timestep : 1.0f);
+    }
+
+    void Game::limitFrame(float millis, bool inputReceived) {
+        // Idle while there is neither input, nor changes to the entities, nor requested frames
+        std::uint64_t changeTick = 0;
+        bool frameRequested = false;
+        if (!this->scenes_.empty()) {
+            Scene& scene = *this->scenes_.top();
+            EntityManager& entityManager = scene.getEntityManager();
+            changeTick = entityManager.getLastChangeTick();
+            // Start a new tick, so that changes in the next frame are told apart even if no system runs
+            entityManager.advanceTick();
+            frameRequested = scene.frameRequested_.exchange(false);
+        }
+        bool idle = false;
+        if (inputReceived || frameRequested || changeTick != this->lastSeenChangeTick_) {
+            this->idleMillis_ = 0.0f;
+            this->lastSeenChangeTick_ = changeTick;
+        } else {
+            this->idleMillis_ += millis;
+            idle = this->idleMillis_ >= this->config_.idleDelay;
+        }
+
+        // A replay in real time paces the frames by itself
+        if (this->replayer_ && this->config_.replayRealTime) return;
+
+        size_t fps = this->config_.targetFps;
+        if (this->config_.idleFps > 0 && idle) {
+            fps = fps ? std::min(fps, this->config_.idleFps) : this->config_.idleFps;
+        }
+        if (fps == 0) {
+            this->frameLimiter_.reset();
+            return;
+        }
+        this->frameLimiter_.wait(1000.0f / (float)fps);
+    }
+
     void Game::run() {
+        // Load the replay first, so that an invalid replay neither truncates nor leaves behind a recording
+        if (!this->config_.replayInput.empty()) {
+            this->replayer_ = new InputReplayer(this->config_.replayInput);
+        }
+        if (!this->config_.recordInput.empty()) {
+            try {
+                this->recorder_ = new InputRecorder(this->config_.recordInput);
+            } catch (...) {
+                delete this->replayer_;
+                this->replayer_ = nullptr;
+                throw;
+            }
+            this->interface_->setRecorder(this->recorder_);
+        }
+
         this->active_ = true;
+        this->accumulator_ = 0.0f;
+        this->idleMillis_ = 0.0f;
+        this->frameLimiter_.reset();
         this->sw_.clear();  // Just in case
         this->sw_.play();
 
@@ -128,12 +220,29 @@ namespace corn {
 
         while (this->active_ && !this->scenes_.empty()) {
             // Get millis
-            float millis = this->sw_.millis();
+            float realMillis = this->sw_.millis();
             this->sw_.clear();
             this->sw_.play();
+            float millis = this->config_.virtualFrameTime > 0.0f
+                           ? this->config_.virtualFrameTime
+                           : realMillis * this->config_.timeScale;
+
+            // Replay the recorded frame time and input
+            if (this->replayer_) {
+                const InputFrame* frame = this->replayer_->next();
+                if (!frame) break;
+                if (this->config_.replayRealTime) {
+                    // Start the frame as long after the previous one as recorded, regardless of the time scale
+                    this->frameLimiter_.wait(frame->realMillis);
+                }
+                millis = frame->millis;
+                for (const InputEvent& input : frame->inputs) {
+                    this->interface_->simulateInput(input);
+                }
+            }
 
             // Update debug data
-            debugDataRefreshProgress += millis;
+            debugDataRefreshProgress += realMillis;
             nFrames++;
             if (debugDataRefreshProgress >= debugDataRefreshRate) {
                 debugDataAvailable = true;
@@ -143,10 +252,10 @@ namespace corn {
             }
 
             // Update scene
-            this->scenes_.top()->update(millis);
+            this->updateScene(millis);
 
             // Update interface
-            this->interface_->handleUserInput();
+            bool inputReceived = this->interface_->handleUserInput();
             this->interface_->render(this->scenes_.top());
             if (this->debugOverlayEnabled_ && debugDataAvailable) {
                 this->interface_->renderDebugOverlay(fps);
@@ -154,7 +263,25 @@ namespace corn {
             this->interface_->update();
 
             // Update scene stack
+            if (!this->sceneEvents_.empty()) {
+                inputReceived = true;  // Wake up for the new scene
+            }
             this->resolveSceneEvents();
+
+            // Record the frame
+            if (this->recorder_) {
+                this->recorder_->endFrame(millis, realMillis);
+            }
+
+            // Wait for the next frame
+            this->limitFrame(realMillis, inputReceived);
         }
+
+        // Close the log files
+        this->interface_->setRecorder(nullptr);
+        delete this->recorder_;
+        this->recorder_ = nullptr;
+        delete this->replayer_;
+        this->replayer_ = nullptr;
     }
 }
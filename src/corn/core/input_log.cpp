@@ -0,0 +1,221 @@
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <corn/core/input_log.h>
+#include <corn/util/exceptions.h>
+
+namespace corn {
+    /*
+     * Layout of the log (little-endian):
+     *   header: "CRNI" and a version byte
+     *   frame:  millis (f32), real millis (f32, since version 2), number of inputs (varint), inputs
+     *   input:  type (u8), then depending on the type
+     *           KEYBOARD:     key (u8), status (u8), modifiers (u8), mouse x and y (f32)
+     *           MOUSE_BUTTON: mouse (u8), status (u8), mouse x and y (f32)
+     *           MOUSE_MOVE:   mouse x and y (f32)
+     *           MOUSE_SCROLL: value (f32), mouse x and y (f32)
+     *           TEXT:         unicode (varint)
+     */
+    static constexpr char LOG_MAGIC[4] = { 'C', 'R', 'N', 'I' };
+    static constexpr unsigned char LOG_VERSION = 2;
+
+    static void writeByte(std::string& buffer, unsigned char value) {
+        buffer.push_back((char)value);
+    }
+
+    static void writeVarint(std::string& buffer, std::uint32_t value) {
+        while (value >= 0x80) {
+            writeByte(buffer, (unsigned char)(value | 0x80));
+            value >>= 7;
+        }
+        writeByte(buffer, (unsigned char)value);
+    }
+
+    static void writeFloat(std::string& buffer, float value) {
+        auto bits = std::bit_cast<std::uint32_t>(value);
+        for (int i = 0; i < 4; i++) {
+            writeByte(buffer, (unsigned char)(bits >> (8 * i)));
+        }
+    }
+
+    /**
+     * @brief Reads a byte of the log and advances the position.
+     * @throw ResourceLoadFailed if the log ends too early.
+     */
+    static unsigned char readByte(const std::string& data, size_t& pos, const std::filesystem::path& path) {
+        if (pos >= data.size()) {
+            throw ResourceLoadFailed("Input log ends unexpectedly: '" + path.string() + "'");
+        }
+        return (unsigned char)data[pos++];
+    }
+
+    static std::uint32_t readVarint(const std::string& data, size_t& pos, const std::filesystem::path& path) {
+        std::uint32_t value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            unsigned char byte = readByte(data, pos, path);
+            value |= (std::uint32_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        throw ResourceLoadFailed("Input log is corrupted: '" + path.string() + "'");
+    }
+
+    static float readFloat(const std::string& data, size_t& pos, const std::filesystem::path& path) {
+        std::uint32_t bits = 0;
+        for (int i = 0; i < 4; i++) {
+            bits |= (std::uint32_t)readByte(data, pos, path) << (8 * i);
+        }
+        return std::bit_cast<float>(bits);
+    }
+
+    /**
+     * @brief Reads an enum stored as a byte and advances the position.
+     * @throw ResourceLoadFailed if the log ends too early or the value is out of range.
+     */
+    template <typename E>
+    static E readEnum(const std::string& data, size_t& pos, const std::filesystem::path& path, E last) {
+        unsigned char value = readByte(data, pos, path);
+        if (value > (unsigned char)last) {
+            throw ResourceLoadFailed("Input log is corrupted: '" + path.string() + "'");
+        }
+        return (E)value;
+    }
+
+    static Vec2 readVec2(const std::string& data, size_t& pos, const std::filesystem::path& path) {
+        float x = readFloat(data, pos, path);
+        float y = readFloat(data, pos, path);
+        return { x, y };
+    }
+
+    InputRecorder::InputRecorder(const std::filesystem::path& path)
+            : file_(path, std::ios::binary | std::ios::trunc), inputs_(), buffer_(), frameCount_(0) {
+
+        if (!this->file_) {
+            throw std::runtime_error("Could not open the file: '" + path.string() + "'");
+        }
+        this->file_.write(LOG_MAGIC, sizeof(LOG_MAGIC));
+        this->file_.put((char)LOG_VERSION);
+    }
+
+    InputRecorder::~InputRecorder() = default;
+
+    void InputRecorder::record(const InputEvent& input) {
+        this->inputs_.push_back(input);
+    }
+
+    void InputRecorder::endFrame(float millis, float realMillis) {
+        std::string& buffer = this->buffer_;
+        buffer.clear();
+        writeFloat(buffer, millis);
+        writeFloat(buffer, realMillis < 0.0f ? millis : realMillis);
+        writeVarint(buffer, (std::uint32_t)this->inputs_.size());
+        for (const InputEvent& input : this->inputs_) {
+            writeByte(buffer, (unsigned char)input.type);
+            switch (input.type) {
+                case InputType::EXIT:
+                    break;
+                case InputType::KEYBOARD:
+                    writeByte(buffer, (unsigned char)input.key);
+                    writeByte(buffer, (unsigned char)input.status);
+                    writeByte(buffer, input.modifiers);
+                    writeFloat(buffer, input.mousePos.x);
+                    writeFloat(buffer, input.mousePos.y);
+                    break;
+                case InputType::MOUSE_BUTTON:
+                    writeByte(buffer, (unsigned char)input.mouse);
+                    writeByte(buffer, (unsigned char)input.status);
+                    writeFloat(buffer, input.mousePos.x);
+                    writeFloat(buffer, input.mousePos.y);
+                    break;
+                case InputType::MOUSE_MOVE:
+                    writeFloat(buffer, input.mousePos.x);
+                    writeFloat(buffer, input.mousePos.y);
+                    break;
+                case InputType::MOUSE_SCROLL:
+                    writeFloat(buffer, input.value);
+                    writeFloat(buffer, input.mousePos.x);
+                    writeFloat(buffer, input.mousePos.y);
+                    break;
+                case InputType::TEXT:
+                    writeVarint(buffer, input.unicode);
+                    break;
+            }
+        }
+        this->file_.write(buffer.data(), (std::streamsize)buffer.size());
+        this->inputs_.clear();
+        this->frameCount_++;
+    }
+
+    size_t InputRecorder::getFrameCount() const noexcept {
+        return this->frameCount_;
+    }
+
+    InputReplayer::InputReplayer(const std::filesystem::path& path) : frames_(), current_(0) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw ResourceLoadFailed("Could not open the file: '" + path.string() + "'");
+        }
+        std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        size_t pos = 0;
+        for (char c : LOG_MAGIC) {
+            if (readByte(data, pos, path) != (unsigned char)c) {
+                throw ResourceLoadFailed("Not an input log: '" + path.string() + "'");
+            }
+        }
+        // Version 1 logs only have the game clock, which is also used as the wall clock
+        unsigned char version = readByte(data, pos, path);
+        if (version == 0 || version > LOG_VERSION) {
+            throw ResourceLoadFailed("Unsupported input log version: '" + path.string() + "'");
+        }
+
+        while (pos < data.size()) {
+            InputFrame& frame = this->frames_.emplace_back();
+            frame.millis = readFloat(data, pos, path);
+            frame.realMillis = version >= 2 ? readFloat(data, pos, path) : frame.millis;
+            std::uint32_t count = readVarint(data, pos, path);
+            for (std::uint32_t i = 0; i < count; i++) {
+                InputEvent& input = frame.inputs.emplace_back();
+                input.type = readEnum(data, pos, path, InputType::TEXT);
+                switch (input.type) {
+                    case InputType::EXIT:
+                        break;
+                    case InputType::KEYBOARD:
+                        input.key = readEnum(data, pos, path, Key::NONE);
+                        input.status = readEnum(data, pos, path, ButtonEvent::UP);
+                        input.modifiers = readByte(data, pos, path);
+                        input.mousePos = readVec2(data, pos, path);
+                        break;
+                    case InputType::MOUSE_BUTTON:
+                        input.mouse = readEnum(data, pos, path, Mouse::NONE);
+                        input.status = readEnum(data, pos, path, ButtonEvent::UP);
+                        input.mousePos = readVec2(data, pos, path);
+                        break;
+                    case InputType::MOUSE_MOVE:
+                        input.mousePos = readVec2(data, pos, path);
+                        break;
+                    case InputType::MOUSE_SCROLL:
+                        input.value = readFloat(data, pos, path);
+                        input.mousePos = readVec2(data, pos, path);
+                        break;
+                    case InputType::TEXT:
+                        input.unicode = readVarint(data, pos, path);
+                        break;
+                }
+            }
+        }
+    }
+
+    const InputFrame* InputReplayer::next() noexcept {
+        if (this->isFinished()) return nullptr;
+        return &this->frames_[this->current_++];
+    }
+
+    bool InputReplayer::isFinished() const noexcept {
+        return this->current_ >= this->frames_.size();
+    }
+
+    size_t InputReplayer::getFrameCount() const noexcept {
+        return this->frames_.size();
+    }
+}
@@ -1,16 +1,21 @@
+#include <cstdint>
 #include <corn/core/scene.h>
+#include <corn/ecs/entity_command_buffer.h>
 #include <corn/ecs/entity_manager.h>
 #include <corn/ecs/system.h>
 #include <corn/event/event_manager.h>
 #include <corn/ui/ui_manager.h>
+#include <corn/util/thread_pool.h>
 
 namespace corn {
-    Scene::Scene() noexcept : game_(nullptr), systems_() {
+    Scene::Scene() noexcept : game_(nullptr), systems_(), parallel_(true), stages_(), stagesDirty_(true),
+            frameRequested_(false) {
         static SceneID uniqueID = 0;
         this->id_ = uniqueID++;
         this->room_ = "Scene::" + std::to_string(this->id_);
         EventManager::addRoom(this->room_);
         this->entityManager_ = new EntityManager(*this);
+        this->commandBuffer_ = new EntityCommandBuffer(*this->entityManager_);
         this->uiManager_ = new UIManager(*this);
     }
 
@@ -18,6 +23,7 @@ namespace corn {
         for (corn::System* system : this->systems_) {
             delete system;
         }
+        delete this->commandBuffer_;
         delete this->entityManager_;
         EventManager::removeRoom(this->room_);
     }
@@ -30,6 +36,10 @@ namespace corn {
         return *this->entityManager_;
     }
 
+    EntityCommandBuffer& Scene::getCommandBuffer() const noexcept {
+        return *this->commandBuffer_;
+    }
+
     UIManager& Scene::getUIManager() const noexcept {
         return *this->uiManager_;
     }
@@ -42,11 +52,75 @@ namespace corn {
         return this->game_;
     }
 
+    void Scene::requestFrame() noexcept {
+        this->frameRequested_ = true;
+    }
+
+    bool Scene::isParallel() const noexcept {
+        return this->parallel_;
+    }
+
+    void Scene::setParallel(bool parallel) noexcept {
+        this->parallel_ = parallel;
+    }
+
     void Scene::update(float millis) {
+        ThreadPool& threadPool = ThreadPool::instance();
+        if (!this->parallel_ || threadPool.getThreadCount() == 0) {
+            for (System* system : this->systems_) {
+                if (system->isActive()) {
+                    system->update(millis);
+                    this->commandBuffer_->playback();
+                    system->lastRunTick_ = this->entityManager_->advanceTick();
+                }
+            }
+            return;
+        }
+
+        // Run the stages
+        if (this->stagesDirty_) {
+            this->buildStages();
+        }
+        for (const std::vector<System*>& stage : this->stages_) {
+            if (stage.size() == 1) {
+                stage[0]->update(millis);
+                this->commandBuffer_->playback();
+                stage[0]->lastRunTick_ = this->entityManager_->advanceTick();
+                continue;
+            }
+            // Systems in the same stage may read the same world transforms, so refresh them beforehand
+            this->entityManager_->tidy();
+            std::vector<ThreadPool::Task> tasks;
+            tasks.reserve(stage.size());
+            for (System* system : stage) {
+                tasks.emplace_back([system, millis]() { system->update(millis); });
+            }
+            threadPool.run(tasks);
+            this->commandBuffer_->playback();
+            std::uint64_t tick = this->entityManager_->advanceTick();
+            for (System* system : stage) {
+                system->lastRunTick_ = tick;
+            }
+        }
+    }
+
+    void Scene::buildStages() {
+        this->stages_.clear();
+        std::vector<std::pair<System*, size_t>> scheduled;
         for (System* system : this->systems_) {
-            if (system->isActive()) {
-                system->update(millis);
+            if (!system->isActive()) continue;
+            size_t stage = 0;
+            for (auto [other, otherStage] : scheduled) {
+                if (otherStage >= stage && system->conflictsWith(*other)) {
+                    stage = otherStage + 1;
+                }
+            }
+            if (stage == this->stages_.size()) {
+                this->stages_.emplace_back();
             }
+            this->stages_[stage].push_back(system);
+            scheduled.emplace_back(system, stage);
         }
+        this->stagesDirty_ = false;
     }
 }
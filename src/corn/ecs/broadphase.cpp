@@ -0,0 +1,335 @@
+#include <algorithm>
+#include <cmath>
+#include "broadphase.h"
+
+namespace corn {
+    bool AABB::valid() const noexcept {
+        return this->tl.x < this->br.x && this->tl.y < this->br.y;
+    }
+
+    bool AABB::overlapWith(const AABB& other) const noexcept {
+        return std::min(this->br.x, other.br.x) > std::max(this->tl.x, other.tl.x)
+               && std::min(this->br.y, other.br.y) > std::max(this->tl.y, other.tl.y);
+    }
+
+    bool AABB::contains(const AABB& other) const noexcept {
+        return this->tl.x <= other.tl.x && this->tl.y <= other.tl.y
+               && this->br.x >= other.br.x && this->br.y >= other.br.y;
+    }
+
+    AABB AABB::merge(const AABB& other) const noexcept {
+        return {
+                Vec2(std::min(this->tl.x, other.tl.x), std::min(this->tl.y, other.tl.y)),
+                Vec2(std::max(this->br.x, other.br.x), std::max(this->br.y, other.br.y)),
+        };
+    }
+
+    float AABB::cost() const noexcept {
+        return (this->br.x - this->tl.x) + (this->br.y - this->tl.y);
+    }
+
+    bool CollisionFilter::interactsWith(const CollisionFilter& other) const noexcept {
+        return (this->layer & other.mask) && (other.layer & this->mask);
+    }
+
+    Broadphase::~Broadphase() = default;
+
+    void BroadphaseBruteForce::findPairs(
+            const std::vector<AABB>& boxes, const std::vector<CollisionFilter>& filters,
+            const std::vector<Entity::EntityID>&,
+            std::vector<std::pair<size_t, size_t>>& pairs) {
+
+        pairs.clear();
+        for (size_t i = 0; i < boxes.size(); i++) {
+            for (size_t j = i + 1; j < boxes.size(); j++) {
+                if (!filters[i].interactsWith(filters[j])) continue;
+                pairs.emplace_back(i, j);
+            }
+        }
+    }
+
+    void BroadphaseSweepAndPrune::findPairs(
+            const std::vector<AABB>& boxes, const std::vector<CollisionFilter>& filters,
+            const std::vector<Entity::EntityID>&,
+            std::vector<std::pair<size_t, size_t>>& pairs) {
+
+        pairs.clear();
+        size_t n = boxes.size();
+
+        // Insertion sort is near-linear when the order barely changes, which is the common case as long as the
+        // colliders keep their indices. Otherwise, fall back to a full sort.
+        bool sorted = false;
+        if (this->order_.size() == n) {
+            for (auto& [left, index] : this->order_) {
+                left = boxes[index].tl.x;
+            }
+            size_t budget = 8 * n;
+            for (size_t i = 1; i < n && budget > 0; i++) {
+                std::pair<float, size_t> current = this->order_[i];
+                size_t j = i;
+                for (; j > 0 && this->order_[j - 1].first > current.first && budget > 0; j--, budget--) {
+                    this->order_[j] = this->order_[j - 1];
+                }
+                this->order_[j] = current;
+            }
+            sorted = budget > 0;
+        } else {
+            this->order_.resize(n);
+            for (size_t i = 0; i < n; i++) {
+                this->order_[i] = { boxes[i].tl.x, i };
+            }
+        }
+        if (!sorted) {
+            std::sort(this->order_.begin(), this->order_.end());
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            const AABB& box1 = boxes[this->order_[i].second];
+            for (size_t j = i + 1; j < n && this->order_[j].first < box1.br.x; j++) {
+                const AABB& box2 = boxes[this->order_[j].second];
+                if (std::min(box1.br.y, box2.br.y) <= std::max(box1.tl.y, box2.tl.y)) continue;
+                size_t index1 = this->order_[i].second;
+                size_t index2 = this->order_[j].second;
+                if (!filters[index1].interactsWith(filters[index2])) continue;
+                pairs.emplace_back(std::min(index1, index2), std::max(index1, index2));
+            }
+        }
+    }
+
+    BroadphaseSpatialHash::BroadphaseSpatialHash(float cellSize) noexcept
+            : cellSize_(cellSize), cells_(), ranges_(), oversized_(), isOversized_() {}
+
+    void BroadphaseSpatialHash::findPairs(
+            const std::vector<AABB>& boxes, const std::vector<CollisionFilter>& filters,
+            const std::vector<Entity::EntityID>&,
+            std::vector<std::pair<size_t, size_t>>& pairs) {
+
+        // Boxes covering more cells than this are paired with every box instead of being hashed
+        constexpr long long MAX_CELLS = 64;
+
+        pairs.clear();
+        this->cells_.clear();
+        this->oversized_.clear();
+        this->ranges_.resize(boxes.size());
+        this->isOversized_.assign(boxes.size(), false);
+
+        auto cellKey = [](long long x, long long y) {
+            return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32)
+                   | static_cast<std::uint32_t>(y);
+        };
+
+        for (size_t i = 0; i < boxes.size(); i++) {
+            CellRange& range = this->ranges_[i];
+            range.x0 = static_cast<long long>(std::floor(boxes[i].tl.x / this->cellSize_));
+            range.y0 = static_cast<long long>(std::floor(boxes[i].tl.y / this->cellSize_));
+            range.x1 = static_cast<long long>(std::floor(boxes[i].br.x / this->cellSize_));
+            range.y1 = static_cast<long long>(std::floor(boxes[i].br.y / this->cellSize_));
+            if ((range.x1 - range.x0 + 1) * (range.y1 - range.y0 + 1) > MAX_CELLS) {
+                this->oversized_.push_back(i);
+                this->isOversized_[i] = true;
+                continue;
+            }
+            for (long long x = range.x0; x <= range.x1; x++) {
+                for (long long y = range.y0; y <= range.y1; y++) {
+                    this->cells_.emplace_back(cellKey(x, y), i);
+                }
+            }
+        }
+
+        // Group the entries by cell, with the boxes of each cell in increasing order
+        std::sort(this->cells_.begin(), this->cells_.end());
+        for (size_t begin = 0, end = 0; begin < this->cells_.size(); begin = end) {
+            std::uint64_t key = this->cells_[begin].first;
+            while (end < this->cells_.size() && this->cells_[end].first == key) end++;
+            for (size_t a = begin; a < end; a++) {
+                for (size_t b = a + 1; b < end; b++) {
+                    size_t i = this->cells_[a].second;
+                    size_t j = this->cells_[b].second;
+                    if (!filters[i].interactsWith(filters[j])) continue;
+                    const CellRange& range1 = this->ranges_[i];
+                    const CellRange& range2 = this->ranges_[j];
+                    // Only report the pair in the first cell shared by both boxes
+                    if (key != cellKey(std::max(range1.x0, range2.x0), std::max(range1.y0, range2.y0))) continue;
+                    pairs.emplace_back(i, j);
+                }
+            }
+        }
+
+        for (size_t i : this->oversized_) {
+            for (size_t j = 0; j < boxes.size(); j++) {
+                // Pairs of two oversized boxes are reported by the box with the smaller index
+                if (i == j || (this->isOversized_[j] && j < i) || !filters[i].interactsWith(filters[j])) continue;
+                pairs.emplace_back(std::min(i, j), std::max(i, j));
+            }
+        }
+    }
+
+    BroadphaseAABBTree::BroadphaseAABBTree(float margin) noexcept
+            : margin_(margin), nodes_(), root_(NONE), freeList_(NONE), frame_(0), leaves_(), stack_() {}
+
+    void BroadphaseAABBTree::findPairs(
+            const std::vector<AABB>& boxes, const std::vector<CollisionFilter>& filters,
+            const std::vector<Entity::EntityID>& ids,
+            std::vector<std::pair<size_t, size_t>>& pairs) {
+
+        pairs.clear();
+        this->frame_++;
+        Vec2 margin(this->margin_, this->margin_);
+
+        // Update the leaves, only reinserting those that moved out of their fattened boxes
+        for (size_t i = 0; i < boxes.size(); i++) {
+            auto [it, inserted] = this->leaves_.try_emplace(ids[i], NONE);
+            if (inserted) {
+                size_t leaf = this->allocateNode();
+                it->second = leaf;
+                this->nodes_[leaf].id = ids[i];
+                this->nodes_[leaf].layers = filters[i].layer;
+                this->nodes_[leaf].box = AABB(boxes[i].tl - margin, boxes[i].br + margin);
+                this->insertLeaf(leaf);
+            } else if (this->nodes_[it->second].layers != filters[i].layer) {
+                this->nodes_[it->second].layers = filters[i].layer;
+                if (this->nodes_[it->second].box.contains(boxes[i])) {
+                    this->refit(this->nodes_[it->second].parent);
+                } else {
+                    size_t leaf = it->second;
+                    this->removeLeaf(leaf);
+                    this->nodes_[leaf].box = AABB(boxes[i].tl - margin, boxes[i].br + margin);
+                    this->insertLeaf(leaf);
+                }
+            } else if (!this->nodes_[it->second].box.contains(boxes[i])) {
+                size_t leaf = it->second;
+                this->removeLeaf(leaf);
+                this->nodes_[leaf].box = AABB(boxes[i].tl - margin, boxes[i].br + margin);
+                this->insertLeaf(leaf);
+            }
+            this->nodes_[it->second].collider = i;
+            this->nodes_[it->second].lastSeen = this->frame_;
+        }
+
+        // Remove colliders that no longer exist
+        for (auto it = this->leaves_.begin(); it != this->leaves_.end();) {
+            if (this->nodes_[it->second].lastSeen == this->frame_) {
+                it++;
+                continue;
+            }
+            this->removeLeaf(it->second);
+            this->freeNode(it->second);
+            it = this->leaves_.erase(it);
+        }
+
+        // Query the tree with the tight box of each collider
+        for (size_t i = 0; i < boxes.size(); i++) {
+            if (this->root_ == NONE) break;
+            this->stack_.clear();
+            this->stack_.push_back(this->root_);
+            while (!this->stack_.empty()) {
+                const Node& node = this->nodes_[this->stack_.back()];
+                this->stack_.pop_back();
+                if (!(node.layers & filters[i].mask) || !node.box.overlapWith(boxes[i])) continue;
+                if (node.left == NONE) {
+                    if (node.collider > i && filters[i].interactsWith(filters[node.collider])) {
+                        pairs.emplace_back(i, node.collider);
+                    }
+                } else {
+                    this->stack_.push_back(node.left);
+                    this->stack_.push_back(node.right);
+                }
+            }
+        }
+    }
+
+    size_t BroadphaseAABBTree::allocateNode() {
+        size_t node;
+        if (this->freeList_ != NONE) {
+            node = this->freeList_;
+            this->freeList_ = this->nodes_[node].parent;
+        } else {
+            node = this->nodes_.size();
+            this->nodes_.emplace_back();
+        }
+        this->nodes_[node] = Node{ AABB(), NONE, NONE, NONE, 0, 0, 0, 0 };
+        return node;
+    }
+
+    void BroadphaseAABBTree::insertLeaf(size_t leaf) {
+        if (this->root_ == NONE) {
+            this->root_ = leaf;
+            this->nodes_[leaf].parent = NONE;
+            return;
+        }
+
+        // Find the best sibling by descending the tree, minimizing the total perimeter of the new internal nodes
+        AABB leafBox = this->nodes_[leaf].box;
+        size_t sibling = this->root_;
+        while (this->nodes_[sibling].left != NONE) {
+            const Node& node = this->nodes_[sibling];
+            float combinedCost = node.box.merge(leafBox).cost();
+            float newParentCost = 2.0f * combinedCost;
+            float inheritanceCost = 2.0f * (combinedCost - node.box.cost());
+            auto descendCost = [&](size_t child) {
+                const Node& childNode = this->nodes_[child];
+                float cost = childNode.box.merge(leafBox).cost() + inheritanceCost;
+                return childNode.left == NONE ? cost : cost - childNode.box.cost();
+            };
+            float leftCost = descendCost(node.left);
+            float rightCost = descendCost(node.right);
+            if (newParentCost < leftCost && newParentCost < rightCost) break;
+            sibling = leftCost < rightCost ? node.left : node.right;
+        }
+
+        // Create a new parent for the sibling and the leaf
+        size_t oldParent = this->nodes_[sibling].parent;
+        size_t newParent = this->allocateNode();
+        this->nodes_[newParent].parent = oldParent;
+        this->nodes_[newParent].left = sibling;
+        this->nodes_[newParent].right = leaf;
+        this->nodes_[sibling].parent = newParent;
+        this->nodes_[leaf].parent = newParent;
+        if (oldParent == NONE) {
+            this->root_ = newParent;
+        } else if (this->nodes_[oldParent].left == sibling) {
+            this->nodes_[oldParent].left = newParent;
+        } else {
+            this->nodes_[oldParent].right = newParent;
+        }
+
+        this->refit(newParent);
+    }
+
+    void BroadphaseAABBTree::removeLeaf(size_t leaf) {
+        if (leaf == this->root_) {
+            this->root_ = NONE;
+            return;
+        }
+
+        size_t parent = this->nodes_[leaf].parent;
+        size_t grandParent = this->nodes_[parent].parent;
+        size_t sibling = this->nodes_[parent].left == leaf ? this->nodes_[parent].right : this->nodes_[parent].left;
+        this->nodes_[sibling].parent = grandParent;
+        this->freeNode(parent);
+        if (grandParent == NONE) {
+            this->root_ = sibling;
+            return;
+        }
+        if (this->nodes_[grandParent].left == parent) {
+            this->nodes_[grandParent].left = sibling;
+        } else {
+            this->nodes_[grandParent].right = sibling;
+        }
+        this->refit(grandParent);
+    }
+
+    void BroadphaseAABBTree::refit(size_t node) noexcept {
+        for (; node != NONE; node = this->nodes_[node].parent) {
+            Node& current = this->nodes_[node];
+            current.box = this->nodes_[current.left].box.merge(this->nodes_[current.right].box);
+            current.layers = this->nodes_[current.left].layers | this->nodes_[current.right].layers;
+        }
+    }
+
+    void BroadphaseAABBTree::freeNode(size_t node) noexcept {
+        this->nodes_[node].parent = this->freeList_;
+        this->nodes_[node].left = NONE;
+        this->freeList_ = node;
+    }
+}
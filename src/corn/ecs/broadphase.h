@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <corn/ecs/entity.h>
+#include <corn/geometry/vec2.h>
+
+namespace corn {
+    /**
+     * @struct AABB
+     * @brief Axis-aligned bounding box in the world's reference frame.
+     */
+    struct AABB {
+        Vec2 tl;                                   ///< Top left corner
+        Vec2 br;                                   ///< Bottom right corner
+
+        /// @return Whether the box has a positive area.
+        [[nodiscard]] bool valid() const noexcept;
+
+        /// @return Whether the two boxes overlap. Boxes that only touch at the edges do not overlap.
+        [[nodiscard]] bool overlapWith(const AABB& other) const noexcept;
+
+        /// @return Whether this box fully contains the other box.
+        [[nodiscard]] bool contains(const AABB& other) const noexcept;
+
+        /// @return The smallest box containing both boxes.
+        [[nodiscard]] AABB merge(const AABB& other) const noexcept;
+
+        /// @return Half of the perimeter, used as the cost of a box in the AABB tree.
+        [[nodiscard]] float cost() const noexcept;
+    };
+
+    /**
+     * @struct CollisionFilter
+     * @brief Collision layers of a collider.
+     * @see CBBox
+     */
+    struct CollisionFilter {
+        std::uint32_t layer;                       ///< Bitmask of the layers that the collider belongs to
+        std::uint32_t mask;                        ///< Bitmask of the layers that the collider collides with
+
+        /// @return Whether the two colliders interact.
+        [[nodiscard]] bool interactsWith(const CollisionFilter& other) const noexcept;
+    };
+
+    /**
+     * @class Broadphase
+     * @brief Finds the pairs of colliders whose world AABBs might overlap.
+     *
+     * All broadphases report every overlapping pair of interacting colliders exactly once, and never report pairs that
+     * do not interact according to their collision filters. They may also report some pairs that do not overlap, so
+     * candidate pairs must still go through the exact overlap test.
+     *
+     * @see SCollisionDetection
+     */
+    class Broadphase {
+    public:
+        /// @brief Destructor.
+        virtual ~Broadphase();
+
+        /**
+         * @brief Finds all candidate pairs.
+         * @param boxes World AABBs of all colliders. Must be valid.
+         * @param filters Collision filters of all colliders.
+         * @param ids IDs of the owners of the colliders, used to track the colliders across frames.
+         * @param pairs Output list of candidate pairs (i, j) with i < j, indexing into boxes. Cleared before use.
+         */
+        virtual void findPairs(
+                const std::vector<AABB>& boxes, const std::vector<CollisionFilter>& filters,
+                const std::vector<Entity::EntityID>& ids,
+                std::vector<std::pair<size_t, size_t>>& pairs) = 0;
+    };
+
+    /**
+     * @class BroadphaseBruteForce
+     * @brief Reports all pairs. Takes O(n^2) time.
+     */
+    class BroadphaseBruteForce : public Broadphase {
+    public:
+        void findPairs(
+                const std::vector<AABB>& boxes, const std::vector<CollisionFilter>& filters,
+                const std::vector<Entity::EntityID>& ids,
+                std::vector<std::pair<size_t, size_t>>& pairs) override;
+    };
+
+    /**
+     * @class BroadphaseSweepAndPrune
+     * @brief Sorts the boxes by their left edges and sweeps along the x-axis.
+     *
+     * The sorted order is kept between frames, so that sorting takes close to linear time when the colliders move
+     * coherently.
+     */
+    class BroadphaseSweepAndPrune : public Broadphase {
+    public:
+        void findPairs(
+                const std::vector<AABB>& boxes, const std::vector<CollisionFilter>& filters,
+                const std::vector<Entity::EntityID>& ids,
+                std::vector<std::pair<size_t, size_t>>& pairs) override;
+
+    private:
+        /// @brief Boxes sorted by their left edges.
+        std::vector<std::pair<float, size_t>> order_;
+    };
+
+    /**
+     * @class BroadphaseSpatialHash
+     * @brief Hashes the boxes into a uniform grid, and only pairs boxes sharing a cell.
+     *
+     * The cells are stored as a flat list of (cell, box) entries sorted by cell, so that the storage is reused across
+     * frames instead of allocating a bucket per cell.
+     */
+    class BroadphaseSpatialHash : public Broadphase {
+    public:
+        /// @brief Constructor.
+        explicit BroadphaseSpatialHash(float cellSize) noexcept;
+
+        void findPairs(
+                const std::vector<AABB>& boxes, const std::vector<CollisionFilter>& filters,
+                const std::vector<Entity::EntityID>& ids,
+                std::vector<std::pair<size_t, size_t>>& pairs) override;
+
+    private:
+        /// @brief Width and height of each cell.
+        float cellSize_;
+
+        /// @brief Range of cells covered by a box, inclusive.
+        struct CellRange {
+            long long x0, y0, x1, y1;
+        };
+
+        /// @brief Key of each cell covered by each box, with the index of the box, sorted by key.
+        std::vector<std::pair<std::uint64_t, size_t>> cells_;
+
+        /// @brief Range of cells covered by each box.
+        std::vector<CellRange> ranges_;
+
+        /// @brief Indices of the boxes covering too many cells to be hashed.
+        std::vector<size_t> oversized_;
+
+        /// @brief Whether each box is oversized.
+        std::vector<bool> isOversized_;
+    };
+
+    /**
+     * @class BroadphaseAABBTree
+     * @brief Stores the boxes in a dynamic bounding volume hierarchy that persists between frames.
+     *
+     * Each collider is stored as a leaf with a fattened box. A leaf is only reinserted when the collider moves out of
+     * its fattened box, so colliders that move a little (or not at all) cost nothing to update.
+     */
+    class BroadphaseAABBTree : public Broadphase {
+    public:
+        /**
+         * @brief Constructor.
+         * @param margin Amount by which the boxes of the leaves are fattened in each direction.
+         */
+        explicit BroadphaseAABBTree(float margin) noexcept;
+
+        void findPairs(
+                const std::vector<AABB>& boxes, const std::vector<CollisionFilter>& filters,
+                const std::vector<Entity::EntityID>& ids,
+                std::vector<std::pair<size_t, size_t>>& pairs) override;
+
+    private:
+        /// @brief Marks the absence of a node.
+        static constexpr size_t NONE = static_cast<size_t>(-1);
+
+        /// @brief Node of the tree.
+        struct Node {
+            AABB box;                              ///< Box containing all descendant leaves (fattened for leaves)
+            size_t parent;                         ///< Parent node, or the next free node if the node is free
+            size_t left;                           ///< Left child, or NONE for leaves
+            size_t right;                          ///< Right child, or NONE for leaves
+            size_t collider;                       ///< Index of the collider in the current frame (leaves only)
+            Entity::EntityID id;                   ///< ID of the owner of the collider (leaves only)
+            size_t lastSeen;                       ///< Frame in which the collider last existed (leaves only)
+            std::uint32_t layers;                  ///< Union of the layers of all descendant leaves
+        };
+
+        /// @return Index of a new node.
+        size_t allocateNode();
+
+        /// @brief Inserts a leaf into the tree.
+        void insertLeaf(size_t leaf);
+
+        /// @brief Removes a leaf from the tree. The leaf is not freed.
+        void removeLeaf(size_t leaf);
+
+        /// @brief Recomputes the boxes and layers of the node and its ancestors from their children.
+        void refit(size_t node) noexcept;
+
+        /// @brief Adds the node to the free list.
+        void freeNode(size_t node) noexcept;
+
+        /// @brief Amount by which the boxes of the leaves are fattened in each direction.
+        float margin_;
+
+        /// @brief All nodes, including free ones.
+        std::vector<Node> nodes_;
+
+        /// @brief Root of the tree.
+        size_t root_;
+
+        /// @brief Head of the list of free nodes.
+        size_t freeList_;
+
+        /// @brief Number of frames processed.
+        size_t frame_;
+
+        /// @brief Leaf of each collider, by the ID of its owner.
+        std::unordered_map<Entity::EntityID, size_t> leaves_;
+
+        /// @brief Stack used for traversing the tree.
+        std::vector<size_t> stack_;
+    };
+}
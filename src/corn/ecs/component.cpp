@@ -6,11 +6,11 @@
 #include <corn/ecs/entity_manager.h>
 #include <corn/geometry/operations.h>
 #include <corn/media/image.h>
-#include "../event/event_args_extend.h"
 
 namespace corn {
     Component::Component(Entity& entity) noexcept
-            : active(true), entityManager_(entity.getEntityManager()), entityID_(entity.getID()) {}
+            : active(true), entityManager_(entity.getEntityManager()), entityID_(entity.getID()),
+            changeTick_(entity.getEntityManager().getTick()) {}
 
     Component::~Component() = default;
 
@@ -30,33 +30,79 @@ namespace corn {
         return this->entityManager_.getGame();
     }
 
+    std::uint64_t Component::getChangeTick() const noexcept {
+        return this->changeTick_;
+    }
+
+    bool Component::isChangedSince(std::uint64_t tick) const noexcept {
+        return this->changeTick_ >= tick;
+    }
+
+    void Component::markChanged() noexcept {
+        this->changeTick_ = this->entityManager_.getTick();
+        this->entityManager_.recordChange();
+    }
+
     CTransform2D::CTransform2D(Entity &entity, Vec2 location, Deg rotation) noexcept
-            : Component(entity), location(location), rotation(rotation), zOrder_(0) {}
+            : Component(entity), location_(location), rotation_(rotation), zOrder_(0) {}
+
+    Vec2 CTransform2D::getLocation() const noexcept {
+        return this->location_;
+    }
+
+    void CTransform2D::setLocation(Vec2 location) noexcept {
+        this->location_ = location;
+        this->markChanged();
+        this->getEntityManager().notifySet(*this);
+        this->getEntityManager().invalidateWorldCache(this->getEntity());
+    }
+
+    Deg CTransform2D::getRotation() const noexcept {
+        return this->rotation_;
+    }
+
+    void CTransform2D::setRotation(Deg rotation) noexcept {
+        this->rotation_ = rotation;
+        this->markChanged();
+        this->getEntityManager().notifySet(*this);
+        this->getEntityManager().invalidateWorldCache(this->getEntity());
+    }
+
+    void CTransform2D::setTransform(Vec2 location, Deg rotation) noexcept {
+        this->location_ = location;
+        this->rotation_ = rotation;
+        this->markChanged();
+        this->getEntityManager().notifySet(*this);
+        this->getEntityManager().invalidateWorldCache(this->getEntity());
+    }
 
     std::pair<Vec2, Deg> CTransform2D::getWorldTransform() const noexcept {
-        std::pair<Vec2, Deg> worldTransform = { this->location, this->rotation };
-        for (Entity* ancestor = this->getEntity().getParent(); ancestor; ancestor = ancestor->getParent()) {
-            auto* ancestorTransform = ancestor->getComponent<CTransform2D>();
-            if (ancestorTransform) {
-                worldTransform.second += ancestorTransform->rotation;
-                worldTransform.first = rotate(worldTransform.first, ancestorTransform->rotation);
-                worldTransform.first += ancestorTransform->location;
-            }
+        const EntityManager::Node& node = this->getEntityManager().getUpdatedNode(this->getEntity());
+        return { node.worldLocation, node.worldRotation };
+    }
+
+    std::pair<Vec2, Deg> CTransform2D::getRenderTransform() const noexcept {
+        EntityManager& entityManager = this->getEntityManager();
+        const EntityManager::Node& node = entityManager.getUpdatedNode(this->getEntity());
+        float alpha = entityManager.getInterpolationAlpha();
+        if (alpha >= 1.0f || !node.hasPrevious) {
+            return { node.worldLocation, node.worldRotation };
         }
-        return worldTransform;
+        // Rotate along the shorter arc
+        float delta = (node.worldRotation - node.prevWorldRotation).get();
+        if (delta >= 180.0f) delta -= 360.0f;
+        return { node.prevWorldLocation + (node.worldLocation - node.prevWorldLocation) * alpha,
+                 node.prevWorldRotation + delta * alpha };
     }
 
     void CTransform2D::setWorldLocation(Vec2 worldLocation) noexcept {
-        auto [curWorldLocation, curWorldRotation] = this->getWorldTransform();
-        Deg parentWorldRotation = curWorldRotation - this->rotation;
-        Vec2 parentWorldLocation = curWorldLocation - rotate(this->location, parentWorldRotation);
-        this->location = rotate(worldLocation - parentWorldLocation, -parentWorldRotation);
+        const EntityManager::Node& parent = *this->getEntityManager().getUpdatedNode(this->getEntity()).parent;
+        this->setLocation(rotate(worldLocation - parent.worldLocation, -parent.worldSin, parent.worldCos));
     }
 
     void CTransform2D::addWorldLocationOffset(Vec2 offset) noexcept {
-        Deg curWorldRotation = this->getWorldTransform().second;
-        Deg parentWorldRotation = curWorldRotation - this->rotation;
-        this->location += rotate(offset, -parentWorldRotation);
+        const EntityManager::Node& parent = *this->getEntityManager().getUpdatedNode(this->getEntity()).parent;
+        this->setLocation(this->location_ + rotate(offset, -parent.worldSin, parent.worldCos));
     }
 
     int CTransform2D::getZOrder() const noexcept {
@@ -65,10 +111,17 @@ namespace corn {
 
     void CTransform2D::setZOrder(int zOrder) noexcept {
         this->zOrder_ = zOrder;
-        this->getScene().getEventManager().emit(EventArgsEntityZOrderChange(&this->getEntity()));
+        this->markChanged();
+        this->getEntityManager().notifySet(*this);
+        this->getEntityManager().updateZOrder(this->getEntity());
     }
 
-    CBBox::CBBox(Entity& entity, Vec2 tl, Vec2 br) noexcept : Component(entity), tl(tl), br(br) {}
+    CBBox::CBBox(Entity& entity, Vec2 tl, Vec2 br, std::uint32_t layer, std::uint32_t mask) noexcept
+            : Component(entity), tl(tl), br(br), layer(layer), mask(mask) {}
+
+    bool CBBox::interactsWith(const CBBox& other) const noexcept {
+        return (this->layer & other.mask) && (other.layer & this->mask);
+    }
 
     bool CBBox::overlapWith(const CBBox& other) const noexcept {
         auto* transform1 = this->getEntity().getComponent<CTransform2D>();
@@ -118,6 +171,7 @@ namespace corn {
     void CText::setX(const std::string& x) noexcept {
         static const std::array<std::string, 3> units = { "px", "%w", "%h" };
         this->x_ = Expression(x, units);
+        this->markChanged();
     }
 
     float CText::getY() const noexcept {
@@ -128,57 +182,47 @@ namespace corn {
     void CText::setY(const std::string& y) noexcept {
         static const std::array<std::string, 3> units = { "px", "%w", "%h" };
         this->y_ = Expression(y, units);
+        this->markChanged();
     }
 
     CMovement2D::CMovement2D(Entity& entity, Vec2 velocity, float angularVelocity) noexcept
-            : Component(entity), velocity(velocity), angularVelocity(angularVelocity) {}
+            : Component(entity), velocity_(velocity), angularVelocity_(angularVelocity) {}
 
-    std::pair<Vec2, float> CMovement2D::getWorldMovement() const noexcept {
-        std::pair<Vec2, float> movement = { this->velocity, this->angularVelocity };
-        for (Entity* ancestor = this->getEntity().getParent(); ancestor; ancestor = ancestor->getParent()) {
-            auto* ancestorMovement = ancestor->getComponent<CMovement2D>();
-            if (ancestorMovement) {
-                movement.second += ancestorMovement->angularVelocity;
-                auto* ancestorTransform = ancestor->getComponent<CTransform2D>();
-                if (ancestorTransform) {
-                    movement.first = rotate(movement.first, ancestorTransform->rotation);
-                    movement.first += ancestorMovement->velocity;
-                }
-            }
-        }
-        return movement;
+    Vec2 CMovement2D::getVelocity() const noexcept {
+        return this->velocity_;
     }
 
-    void CMovement2D::setWorldVelocity(Vec2 worldVelocity) noexcept {
-        // Calculate parent rotation
-        Deg parentWorldRotation = 0.0f;
-        for (Entity* ancestor = this->getEntity().getParent(); ancestor; ancestor = ancestor->getParent()) {
-            auto ancestorTransform = ancestor->getComponent<CTransform2D>();
-            if (ancestorTransform) {
-                parentWorldRotation += ancestorTransform->rotation;
-            }
-        }
+    void CMovement2D::setVelocity(Vec2 velocity) noexcept {
+        this->velocity_ = velocity;
+        this->markChanged();
+        this->getEntityManager().notifySet(*this);
+        this->getEntityManager().invalidateWorldCache(this->getEntity());
+    }
 
-        // Calculate parent world velocity
-        Vec2 curWorldVelocity = this->getWorldMovement().first;
-        Vec2 parentWorldVelocity = curWorldVelocity - rotate(this->velocity, parentWorldRotation);
+    float CMovement2D::getAngularVelocity() const noexcept {
+        return this->angularVelocity_;
+    }
 
-        // Set current velocity
-        this->velocity = rotate(worldVelocity - parentWorldVelocity, -parentWorldRotation);
+    void CMovement2D::setAngularVelocity(float angularVelocity) noexcept {
+        this->angularVelocity_ = angularVelocity;
+        this->markChanged();
+        this->getEntityManager().notifySet(*this);
+        this->getEntityManager().invalidateWorldCache(this->getEntity());
     }
 
-    void CMovement2D::addWorldVelocityOffset(Vec2 offset) noexcept {
-        // Calculate parent rotation
-        Deg parentWorldRotation = 0.0f;
-        for (Entity* ancestor = this->getEntity().getParent(); ancestor; ancestor = ancestor->getParent()) {
-            auto ancestorTransform = ancestor->getComponent<CTransform2D>();
-            if (ancestorTransform) {
-                parentWorldRotation += ancestorTransform->rotation;
-            }
-        }
+    std::pair<Vec2, float> CMovement2D::getWorldMovement() const noexcept {
+        const EntityManager::Node& node = this->getEntityManager().getUpdatedNode(this->getEntity());
+        return { node.worldVelocity, node.worldAngularVelocity };
+    }
 
-        // Add offset to velocity
-        this->velocity += rotate(offset, -parentWorldRotation);
+    void CMovement2D::setWorldVelocity(Vec2 worldVelocity) noexcept {
+        const EntityManager::Node& parent = *this->getEntityManager().getUpdatedNode(this->getEntity()).parent;
+        this->setVelocity(rotate(worldVelocity - parent.worldVelocity, -parent.worldSin, parent.worldCos));
+    }
+
+    void CMovement2D::addWorldVelocityOffset(Vec2 offset) noexcept {
+        const EntityManager::Node& parent = *this->getEntityManager().getUpdatedNode(this->getEntity()).parent;
+        this->setVelocity(this->velocity_ + rotate(offset, -parent.worldSin, parent.worldCos));
     }
 
     CGravity2D::CGravity2D(Entity& entity, float scale) noexcept : Component(entity), scale(scale) {}
@@ -189,19 +233,11 @@ namespace corn {
 
         this->setViewport("0px", "0px", "100%ww", "100%wh");
         this->setFov("100%vw", "100%vh");
-        this->getScene().getEventManager().emit(EventArgsCamera(CameraEventType::ADD, this));
     }
 
     CCamera::CCamera(Entity& entity, Vec3 anchor, Color background) noexcept
             : Component(entity), cameraType(CameraType::_3D), background(background), opacity(255),
-            anchor(anchor), scale(1.0f) {
-
-        this->getScene().getEventManager().emit(EventArgsCamera(CameraEventType::ADD, this));
-    }
-
-    CCamera::~CCamera() {
-        this->getScene().getEventManager().emit(EventArgsCamera(CameraEventType::REMOVE, this));
-    }
+            anchor(anchor), scale(1.0f) {}
 
     void CCamera::setViewport(const std::string& x, const std::string& y, const std::string& w, const std::string& h) {
         static const std::array<std::string, 3> units = { "px", "%ww", "%wh" };
@@ -217,6 +253,7 @@ namespace corn {
         if (!h.empty()) {
             this->viewport.h = Expression(h, units);
         }
+        this->markChanged();
     }
 
     void CCamera::setFov(const std::string& w, const std::string& h) {
@@ -227,5 +264,6 @@ namespace corn {
         if (!h.empty()) {
             this->fovH = Expression(h, units);
         }
+        this->markChanged();
     }
 }
@@ -0,0 +1,78 @@
+#include <corn/ecs/component.h>
+#include <corn/ecs/component_pool.h>
+
+namespace corn {
+    ComponentPoolBase::ComponentPoolBase() noexcept : sparse_(), dense_(), owners_(), indices_() {}
+
+    ComponentPoolBase::~ComponentPoolBase() = default;
+
+    size_t ComponentPoolBase::size() const noexcept {
+        return this->dense_.size();
+    }
+
+    bool ComponentPoolBase::contains(size_t index) const noexcept {
+        return index < this->sparse_.size() && this->sparse_[index] != NPOS;
+    }
+
+    Component* ComponentPoolBase::getBase(size_t index) const noexcept {
+        if (!this->contains(index)) return nullptr;
+        return this->dense_[this->sparse_[index]];
+    }
+
+    const std::vector<Entity*>& ComponentPoolBase::getOwners() const noexcept {
+        return this->owners_;
+    }
+
+    void ComponentPoolBase::link(size_t index, Entity* owner, Component* component) {
+        if (index >= this->sparse_.size()) {
+            this->sparse_.resize(index + 1, NPOS);
+        }
+        this->sparse_[index] = this->dense_.size();
+        this->dense_.push_back(component);
+        this->owners_.push_back(owner);
+        this->indices_.push_back(index);
+    }
+
+    size_t ComponentPoolBase::unlink(size_t index) noexcept {
+        size_t position = this->sparse_[index];
+        size_t last = this->dense_.size() - 1;
+        if (position != last) {
+            // Move the last component into the vacated position
+            this->dense_[position] = this->dense_[last];
+            this->owners_[position] = this->owners_[last];
+            this->indices_[position] = this->indices_[last];
+            this->sparse_[this->indices_[position]] = position;
+        }
+        this->dense_.pop_back();
+        this->owners_.pop_back();
+        this->indices_.pop_back();
+        this->sparse_[index] = NPOS;
+        return position;
+    }
+
+    ComponentStorage::ComponentStorage(std::pmr::memory_resource* resource) noexcept : resource_(resource), pools_() {}
+
+    ComponentStorage::~ComponentStorage() = default;
+
+    ComponentPoolBase* ComponentStorage::findPool(size_t typeID) const noexcept {
+        if (typeID >= this->pools_.size()) return nullptr;
+        return this->pools_[typeID].get();
+    }
+
+    void ComponentStorage::removeAll(size_t index, const ComponentSignature& signature) noexcept {
+        size_t count = std::min(signature.size(), this->pools_.size());
+        for (size_t id = 0; id < count; id++) {
+            if (signature.test(id) && this->pools_[id]) {
+                this->pools_[id]->remove(index);
+            }
+        }
+    }
+
+    void ComponentStorage::clear() noexcept {
+        for (std::unique_ptr<ComponentPoolBase>& pool : this->pools_) {
+            if (pool) {
+                pool->clear();
+            }
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <corn/ecs/component_registry.h>
+
+namespace corn {
+    /// @brief IDs of all registered component types.
+    static std::unordered_map<std::type_index, size_t>& registeredTypes() {
+        static std::unordered_map<std::type_index, size_t> types;
+        return types;
+    }
+
+    /// @brief Mutex for the registered types.
+    static std::mutex& registryMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    size_t ComponentRegistry::size() noexcept {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        return registeredTypes().size();
+    }
+
+    size_t ComponentRegistry::registerType(std::type_index type) {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        std::unordered_map<std::type_index, size_t>& types = registeredTypes();
+        auto it = types.find(type);
+        if (it != types.end()) return it->second;
+        if (types.size() == MAX_COMPONENT_TYPES) {
+            throw std::length_error("Reached the maximum number of component types.");
+        }
+        size_t id = types.size();
+        types.emplace(type, id);
+        return id;
+    }
+
+    size_t ComponentRegistry::findType(std::type_index type) noexcept {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        const std::unordered_map<std::type_index, size_t>& types = registeredTypes();
+        auto it = types.find(type);
+        return it == types.end() ? NPOS : it->second;
+    }
+}
@@ -1,18 +1,20 @@
-#include <utility>
+#include <algorithm>
+#include <stdexcept>
 #include <corn/ecs/component.h>
 #include <corn/ecs/entity.h>
 #include <corn/ecs/entity_manager.h>
 
 namespace corn {
-    Entity::Entity(EntityID id, std::string name, EntityManager& entityManager) noexcept
-            : id_(id), name_(std::move(name)), active_(true), entityManager_(entityManager), components_() {}
+    thread_local const Component* Entity::patchedComponent_ = nullptr;
+
+    Entity::Entity(EntityID id, EntityManager& entityManager) noexcept
+            : id_(id), index_(Entity::indexOf(id)), name_(nullptr), tags_(), active_(true), signature_(),
+            entityManager_(entityManager),
+            componentStorage_(entityManager.componentStorage_) {}
 
     Entity::~Entity() {
         // Destroy all components
-        for (auto& [key, component] : this->components_) {
-            delete component;
-            component = nullptr;
-        }
+        this->componentStorage_.removeAll(this->index_, this->signature_);
     }
 
     Entity::EntityID Entity::getID() const noexcept {
@@ -20,28 +22,66 @@ namespace corn {
     }
 
     const std::string& Entity::getName() const noexcept {
-        return this->name_;
+        return *this->name_;
+    }
+
+    void Entity::setName(const std::string& name) {
+        if (*this->name_ == name) return;
+        this->checkStructureUnlocked();
+        this->entityManager_.unindexName(*this);
+        this->entityManager_.indexName(*this, name);
+    }
+
+    bool Entity::addTag(const std::string& tag) {
+        if (this->hasTag(tag)) return false;
+        this->checkStructureUnlocked();
+        this->entityManager_.indexTag(*this, tag);
+        return true;
+    }
+
+    bool Entity::removeTag(const std::string& tag) {
+        if (!this->hasTag(tag)) return false;
+        this->checkStructureUnlocked();
+        this->entityManager_.unindexTag(*this, tag);
+        return true;
     }
 
-    void Entity::setName(std::string name) noexcept {
-        this->name_ = std::move(name);
+    bool Entity::hasTag(const std::string& tag) const noexcept {
+        return std::any_of(this->tags_.begin(), this->tags_.end(), [&tag](const std::string* t) {
+            return *t == tag;
+        });
+    }
+
+    std::vector<std::string> Entity::getTags() const {
+        std::vector<std::string> tags;
+        tags.reserve(this->tags_.size());
+        for (const std::string* tag : this->tags_) {
+            tags.push_back(*tag);
+        }
+        return tags;
     }
 
     bool Entity::isActive() const noexcept {
         return this->active_;
     }
 
-    void Entity::setActive(bool active) noexcept {
+    const ComponentSignature& Entity::getSignature() const noexcept {
+        return this->signature_;
+    }
+
+    void Entity::setActive(bool active) {
+        if (this->active_ == active) return;
+        this->checkStructureUnlocked();
         this->active_ = active;
+        this->entityManager_.updateActiveInWorld(*this);
+        if (active) {
+            // Do not interpolate from where the entity was before it was deactivated
+            this->entityManager_.resetInterpolation(*this);
+        }
     }
 
     bool Entity::isActiveInWorld() const noexcept {
-        const Entity* current = this;
-        while (current) {
-            if (!this->active_) return false;
-            current = current->getParent();
-        }
-        return true;
+        return this->entityManager_.activeInWorld_[this->index_];
     }
 
     EntityManager& Entity::getEntityManager() const noexcept {
@@ -56,20 +96,66 @@ namespace corn {
         return this->entityManager_.getGame();
     }
 
-    void Entity::destroy() noexcept {
+    void Entity::destroy() {
+        this->checkStructureUnlocked();
         this->entityManager_.destroyEntity(*this);
     }
 
+    void Entity::checkStructureUnlocked() const {
+        if (this->entityManager_.isStructureLocked()) {
+            throw std::logic_error("Cannot change the structure of the entities during a parallel pass.");
+        }
+    }
+
+    void Entity::onComponentAdd(size_t typeID, Component& component) {
+        this->onComponentChange(typeID);
+        this->entityManager_.notifyObservers(typeID, EntityManager::ObserverEvent::ADD, *this, component);
+        this->entityManager_.notifyObservers(typeID, EntityManager::ObserverEvent::SET, *this, component);
+    }
+
+    void Entity::onComponentRemove(size_t typeID, Component& component) {
+        this->entityManager_.notifyObservers(typeID, EntityManager::ObserverEvent::REMOVE, *this, component);
+    }
+
+    void Entity::onComponentSet(size_t typeID, Component& component) {
+        this->entityManager_.notifyObservers(typeID, EntityManager::ObserverEvent::SET, *this, component);
+    }
+
+    void Entity::onComponentReset(size_t typeID, Component& component) {
+        // The signature is unchanged, so only the caches derived from the values need updating
+        bool transform = typeID == ComponentRegistry::id<CTransform2D>();
+        if (transform || typeID == ComponentRegistry::id<CMovement2D>()) {
+            this->entityManager_.invalidateWorldCache(*this);
+        }
+        if (transform) {
+            this->entityManager_.updateZOrder(*this);
+        }
+        this->onComponentSet(typeID, component);
+    }
+
+    void Entity::onComponentChange(size_t typeID) {
+        this->entityManager_.recordChange();
+        this->entityManager_.updateQueries(*this, typeID);
+        bool transform = typeID == ComponentRegistry::id<CTransform2D>();
+        if (transform || typeID == ComponentRegistry::id<CMovement2D>()) {
+            this->entityManager_.invalidateWorldCache(*this);
+        }
+        if (transform) {
+            this->entityManager_.updateZOrder(*this);
+        }
+    }
+
     Entity* Entity::getParent() const noexcept {
-        EntityManager::Node* parent = this->entityManager_.nodes_.at(this->id_).parent;
+        EntityManager::Node* parent = this->entityManager_.nodes_[this->index_].parent;
         return parent ? parent->ent : nullptr;
     }
 
     std::vector<Entity*> Entity::getChildren() const noexcept {
-        std::vector<EntityManager::Node*> children = this->entityManager_.nodes_.at(this->id_).children;
-        std::vector<Entity*> result = std::vector<Entity*>(children.size());
-        for (size_t i = 0; i < children.size(); i++) {
-            result[i] = children[i]->ent;
+        const EntityManager::Node& node = this->entityManager_.nodes_[this->index_];
+        std::vector<Entity*> result;
+        result.reserve(node.childCount);
+        for (const EntityManager::Node* child = node.firstChild; child; child = child->nextSibling) {
+            result.push_back(child->ent);
         }
         return result;
     }
@@ -0,0 +1,102 @@
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <corn/ecs/entity_command_buffer.h>
+#include <corn/ecs/entity_manager.h>
+
+namespace corn {
+    EntityCommandBuffer::EntityCommandBuffer(EntityManager& entityManager) noexcept
+            : entityManager_(entityManager), commands_(), mutex_() {}
+
+    void EntityCommandBuffer::createEntity(std::string name, const Entity* parent, Initializer init) {
+        this->record({ CommandType::CREATE, parent ? parent->getID() : 0, std::move(name), std::move(init) });
+    }
+
+    void EntityCommandBuffer::destroy(const Entity& entity) {
+        this->record({ CommandType::DESTROY, entity.getID(), {}, nullptr });
+    }
+
+    void EntityCommandBuffer::setActive(const Entity& entity, bool active) {
+        this->record({ CommandType::MODIFY, entity.getID(), {}, [active](Entity& target) {
+            target.setActive(active);
+        } });
+    }
+
+    size_t EntityCommandBuffer::size() const noexcept {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        return this->commands_.size();
+    }
+
+    bool EntityCommandBuffer::empty() const noexcept {
+        return this->size() == 0;
+    }
+
+    void EntityCommandBuffer::playback() {
+        if (this->entityManager_.isStructureLocked()) {
+            throw std::logic_error("Cannot play back the command buffer during a parallel pass.");
+        }
+
+        std::vector<Command> commands;
+        std::vector<Entity::EntityID> destroyed;
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(this->mutex_);
+                if (this->commands_.empty()) break;
+                std::swap(commands, this->commands_);
+            }
+
+            // If a command throws, it is discarded, and the commands after it go back to the front of the buffer
+            size_t i = 0;
+            try {
+                for (; i < commands.size(); i++) {
+                    Command& command = commands[i];
+                    switch (command.type) {
+                        case CommandType::CREATE: {
+                            Entity* parent = nullptr;
+                            if (command.target) {
+                                parent = this->entityManager_.getEntityByID(command.target);
+                                if (!parent) break;
+                            }
+                            Entity& entity = this->entityManager_.createEntity(command.name, parent);
+                            if (command.action) {
+                                command.action(entity);
+                            }
+                            break;
+                        }
+                        case CommandType::DESTROY:
+                            // Batch consecutive destructions
+                            destroyed.clear();
+                            for (; i < commands.size() && commands[i].type == CommandType::DESTROY; i++) {
+                                destroyed.push_back(commands[i].target);
+                            }
+                            i--;
+                            this->entityManager_.destroyEntities(destroyed);
+                            break;
+                        case CommandType::MODIFY:
+                            if (Entity* entity = this->entityManager_.getEntityByID(command.target)) {
+                                command.action(*entity);
+                            }
+                            break;
+                    }
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(this->mutex_);
+                this->commands_.insert(this->commands_.begin(),
+                                       std::make_move_iterator(commands.begin() + (std::ptrdiff_t)(i + 1)),
+                                       std::make_move_iterator(commands.end()));
+                throw;
+            }
+            commands.clear();
+        }
+    }
+
+    void EntityCommandBuffer::clear() noexcept {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->commands_.clear();
+    }
+
+    void EntityCommandBuffer::record(Command command) {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->commands_.push_back(std::move(command));
+    }
+}
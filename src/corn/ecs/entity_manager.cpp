@@ -1,49 +1,55 @@
 #include <algorithm>
+#include <limits>
+#include <new>
 #include <ranges>
-#include <stack>
+#include <stdexcept>
 #include <corn/core/game.h>
 #include <corn/core/scene.h>
 #include <corn/ecs/component.h>
 #include <corn/ecs/entity_manager.h>
-#include "../event/event_args_extend.h"
+#include <corn/geometry/operations.h>
 
 namespace corn {
-    EntityManager::Node::Node(Entity* ent, Node* parent) noexcept : ent(ent), parent(parent), children(), dirty(false) {}
-
-    EntityManager::EntityManager(Scene& scene) noexcept : scene_(scene), root_(nullptr, nullptr), nodes_() {
-        // Listen to zorder change events
-        this->eventScope_.addListener(
-                this->scene_.getEventManager(),
-                "corn::game::ecs::zorder",
-                [this](const EventArgs& args) {
-                    const auto& _args = dynamic_cast<const EventArgsEntityZOrderChange&>(args);
-                    if (!_args.entity) return;
-                    Node* node = this->getNodeFromEntity(_args.entity);
-                    node->parent->dirty = true;
-                });
+    /// @brief Gap between the sibling orders of consecutive children after renumbering.
+    static constexpr std::uint64_t SIBLING_ORDER_SPACING = std::uint64_t(1) << 32;
+
+    /// @brief Removes an element from the vector without preserving the order, by moving the last element into its place.
+    template <typename T>
+    static void eraseUnordered(std::vector<T>& vector, const T& value) noexcept {
+        auto it = std::find(vector.begin(), vector.end(), value);
+        if (it == vector.end()) return;
+        *it = vector.back();
+        vector.pop_back();
+    }
 
-        // Listen to add/remove camera events
-        this->eventScope_.addListener(
-                this->scene_.getEventManager(),
-                "corn::game::ecs::camera",
-                [this](const EventArgs& args) {
-                    const auto& _args = dynamic_cast<const EventArgsCamera&>(args);
-                    if (!_args.camera || &_args.camera->getEntityManager() != this) return;
-                    switch (_args.eventType) {
-                        case CameraEventType::ADD:
-                            this->cameras_.push_back(_args.camera);
-                            break;
-                        case CameraEventType::REMOVE:
-                            std::erase(this->cameras_, _args.camera);
-                            break;
-                    }
-                });
+    EntityManager::Node::Node(Entity* ent, Node* parent) noexcept
+            : ent(ent), parent(parent), firstChild(nullptr), lastChild(nullptr), prevSibling(nullptr),
+            nextSibling(nullptr), childCount(0), siblingOrder(0), dirty(false), zOrder(0), worldDirty(false), worldPending(false),
+            worldLocation(Vec2::ZERO()), worldRotation(), worldSin(0.0f), worldCos(1.0f), worldVelocity(Vec2::ZERO()),
+            worldAngularVelocity(0.0f), prevWorldLocation(Vec2::ZERO()), prevWorldRotation(), hasPrevious(false) {}
+
+    EntityManager::EntityManager(Scene& scene) noexcept
+            : scene_(scene), root_(nullptr, nullptr), arena_(), memoryPool_(&this->arena_),
+            componentStorage_(&this->memoryPool_), nameIndex_(), tagIndex_(), nodes_(), generations_(), activeInWorld_(), freeIndices_(),
+            queries_(), queriesByComponent_(), observers_(), nextObserverID_(0), interpolationAlpha_(1.0f), tick_(1), lastChangeTick_(0), parallelPasses_(0),
+            transformPasses_(0), pendingInvalidations_() {
+
+        // Keep the list of cameras in sync
+        this->onAdd<CCamera>([this](Entity&, CCamera& camera) {
+            this->cameras_.push_back(&camera);
+        });
+        this->onRemove<CCamera>([this](Entity&, CCamera& camera) {
+            std::erase(this->cameras_, &camera);
+        });
     }
 
     EntityManager::~EntityManager() {
-        // Delete entities
-        for (auto& [id, node] : this->nodes_) {
-            delete node.ent;
+        // Destroy the components pool by pool, then the entities. Their memory is released with the arena.
+        this->componentStorage_.clear();
+        for (Node& node : this->nodes_) {
+            if (node.ent) {
+                node.ent->~Entity();
+            }
         }
     }
 
@@ -55,43 +61,91 @@ namespace corn {
         return &this->root_;
     }
 
+    std::pmr::memory_resource* EntityManager::getMemoryResource() noexcept {
+        return &this->memoryPool_;
+    }
+
     Entity& EntityManager::createEntity(const std::string& name, const Entity* parent) {
+        if (this->isStructureLocked()) {
+            throw std::logic_error("Cannot change the structure of the entities during a parallel pass.");
+        }
+
         // Verify parent
         Node* parentNode = this->getNodeFromEntity(parent);
 
-        // Create the entity
-        static Entity::EntityID entID = 1;
-        while (entID == 0 || this->nodes_.contains(entID)) {  // Avoid ID 0
-            entID++;
+        // Find a free slot
+        std::uint32_t index;
+        if (!this->freeIndices_.empty()) {
+            index = this->freeIndices_.back();
+            this->freeIndices_.pop_back();
+        } else if (this->nodes_.size() < std::numeric_limits<std::uint32_t>::max()) {
+            index = (std::uint32_t)this->nodes_.size();
+            this->nodes_.emplace_back(nullptr, nullptr);
+            this->generations_.push_back(1);
+            this->activeInWorld_.push_back(false);
+        } else {
+            throw std::length_error("Reached the maximum number of entities.");
         }
-        auto* entity = new Entity(entID++, name, *this);
+
+        // Create the entity
+        void* memory = this->memoryPool_.allocate(sizeof(Entity), alignof(Entity));
+        auto* entity = new(memory) Entity(Entity::makeID(index, this->generations_[index]), *this);
+        this->indexName(*entity, name);
 
         // Create the node
-        this->nodes_.emplace(entity->id_, Node(entity, parentNode));
-        parentNode->children.push_back(&this->nodes_.at(entity->id_));
-        parentNode->dirty = true;
+        Node& node = this->nodes_[index];
+        node.ent = entity;
+        linkChild(parentNode, nullptr, &node);
+        if (node.prevSibling && node.prevSibling->zOrder > 0) {
+            // New entities have z-order 0, so they only need sorting if the last sibling is in front of them
+            this->markUnsorted(parentNode);
+        }
+        this->invalidateWorldCache(*entity);
+
+        // New entities are active, so they are active in the world if their parent is
+        bool activeInWorld = parentNode == &this->root_ || this->activeInWorld_[parentNode->ent->index_];
+        this->activeInWorld_[index] = activeInWorld;
+        this->recordChange();
+
+        // Queries without required components also match the new entity
+        for (auto& [key, query] : this->queries_) {
+            query->update(*entity, activeInWorld);
+        }
 
         return *entity;
     }
 
+    void EntityManager::reserve(size_t count) {
+        size_t reused = std::min(count, this->freeIndices_.size());
+        size_t slots = this->nodes_.size() + count - reused;
+        this->generations_.reserve(slots);
+        this->activeInWorld_.reserve(slots);
+    }
+
     Entity* EntityManager::getEntityByID(Entity::EntityID id) const noexcept {
-        if (!this->nodes_.contains(id)) return nullptr;
-        return this->nodes_.at(id).ent;
+        std::uint32_t index = Entity::indexOf(id);
+        if (index >= this->nodes_.size() || this->generations_[index] != Entity::generationOf(id)) return nullptr;
+        return this->nodes_[index].ent;
     }
 
     Entity* EntityManager::getEntityByName(const std::string& name, const Entity* parent, bool recurse) const noexcept {
-        std::vector<Entity*> result = getEntitiesHelper([&name](const Entity* entity) {
-                return entity->name_ == name;
-            }, false, 1, parent, recurse);
-        return result.empty() ? nullptr : result[0];
+        return this->getIndexedEntity(this->nameIndex_, name, parent, recurse);
     }
 
     std::vector<Entity*> EntityManager::getEntitiesByName(
             const std::string& name, const Entity* parent, bool recurse) const noexcept {
 
-        return getEntitiesHelper([&name](const Entity* entity) {
-                return entity->name_ == name;
-            }, false, 0, parent, recurse);
+        return this->getIndexedEntities(this->nameIndex_, name, parent, recurse);
+    }
+
+    Entity* EntityManager::getEntityByTag(const std::string& tag, const Entity* parent, bool recurse) const noexcept {
+        return this->getIndexedEntity(this->tagIndex_, tag, parent, recurse);
+    }
+
+    std::vector<Entity*> EntityManager::getEntitiesByTag(
+            const std::string& tag, const Entity* parent, bool recurse) const noexcept {
+
+        return this->getIndexedEntities(this->tagIndex_, tag, parent, recurse);
     }
 
     Entity* EntityManager::getEntityThat(
@@ -107,6 +161,14 @@ namespace corn {
         return this->getEntitiesHelper(pred, false, 0, parent, recurse);
     }
 
+    EntityView EntityManager::view(const Entity* parent, bool recurse) const {
+        return { this->getNodeFromEntity(parent), recurse, false };
+    }
+
+    EntityView EntityManager::activeView(const Entity* parent, bool recurse) const {
+        return { this->getNodeFromEntity(parent), recurse, true };
+    }
+
     std::vector<Entity*> EntityManager::getAllEntities(const Entity* parent, bool recurse) const noexcept {
         return this->getEntitiesHelper(nullptr, false, 0, parent, recurse);
     }
@@ -116,69 +178,263 @@ namespace corn {
     }
 
     void EntityManager::clear() noexcept {
-        // Delete child nodes
-        for (auto& [id, node] : this->nodes_) {
-            delete node.ent;
+        // Notify the observers before destroying anything
+        for (size_t typeID = 0; typeID < this->observers_.size(); typeID++) {
+            if (!this->hasObservers(typeID, ObserverEvent::REMOVE)) continue;
+            ComponentPoolBase* pool = this->componentStorage_.findPool(typeID);
+            if (!pool) continue;
+            std::vector<Entity*> owners = pool->getOwners();
+            for (Entity* owner : owners) {
+                Component* component = pool->getBase(owner->index_);
+                if (component) {
+                    this->notifyObservers(typeID, ObserverEvent::REMOVE, *owner, *component);
+                }
+            }
+        }
+        // Destroy the components pool by pool, then the entities
+        this->componentStorage_.clear();
+        for (Node& node : this->nodes_) {
+            if (node.ent) {
+                this->deleteEntity(node.ent);
+            }
+        }
+        for (auto& [key, query] : this->queries_) {
+            query->clear();
+        }
+        this->nameIndex_.clear();
+        this->tagIndex_.clear();
+        // Free all slots (lower indices are reused first)
+        this->freeIndices_.clear();
+        for (size_t i = this->nodes_.size(); i-- > 0;) {
+            if (this->nodes_[i].ent) {
+                this->releaseSlot((std::uint32_t)i);
+            }
+            this->freeIndices_.push_back((std::uint32_t)i);
         }
-        this->nodes_.clear();
         // Reset root node
-        this->root_.children.clear();
+        this->root_.firstChild = nullptr;
+        this->root_.lastChild = nullptr;
+        this->root_.childCount = 0;
         this->root_.dirty = false;
+        this->unsortedNodes_.clear();
+        this->root_.worldPending = false;
+        this->recordChange();
     }
 
     void EntityManager::tidy() noexcept {
-        if (this->root_.dirty) {
-            this->root_.dirty = false;
-            std::stable_sort(this->root_.children.begin(), this->root_.children.end(),
-                             [](Node* left, Node* right) {
-                                 if (left == right) return false;
-                                 auto lTrans = left->ent->getComponent<CTransform2D>();
-                                 auto rTrans = right->ent->getComponent<CTransform2D>();
-                                 if (lTrans == nullptr || rTrans == nullptr) return false;
-                                 else return lTrans->getZOrder() < rTrans->getZOrder();
-                             });
-        }
-
-        for (auto& [id, node] : this->nodes_) {
-            if (!node.dirty) continue;
-            node.dirty = false;
-            std::stable_sort(node.children.begin(), node.children.end(),
-                             [](Node* left, Node* right) {
-                                 if (left == right) return false;
-                                 auto lTrans = left->ent->getComponent<CTransform2D>();
-                                 auto rTrans = right->ent->getComponent<CTransform2D>();
-                                 if (lTrans == nullptr || rTrans == nullptr) return false;
-                                 else return lTrans->getZOrder() < rTrans->getZOrder();
-                             });
+        // Sort the children of dirty nodes
+        for (Node* node : this->unsortedNodes_) {
+            if (!node->dirty) continue;
+            node->dirty = false;
+            sortChildren(*node);
+        }
+        this->unsortedNodes_.clear();
+
+        // Refresh world transforms and movements
+        if (this->root_.worldPending) {
+            this->refreshWorldCaches(this->root_);
+        }
+    }
+
+    void EntityManager::indexName(Entity& entity, const std::string& name) {
+        auto it = this->nameIndex_.try_emplace(name).first;
+        it->second.push_back(&entity);
+        entity.name_ = &it->first;
+    }
+
+    void EntityManager::unindexName(Entity& entity) noexcept {
+        auto it = this->nameIndex_.find(*entity.name_);
+        eraseUnordered(it->second, &entity);
+        entity.name_ = nullptr;
+        if (it->second.empty()) {
+            this->nameIndex_.erase(it);
+        }
+    }
+
+    void EntityManager::indexTag(Entity& entity, const std::string& tag) {
+        auto it = this->tagIndex_.try_emplace(tag).first;
+        entity.tags_.reserve(entity.tags_.size() + 1);
+        it->second.push_back(&entity);
+        entity.tags_.push_back(&it->first);
+    }
+
+    void EntityManager::unindexTag(Entity& entity, const std::string& tag) noexcept {
+        auto it = this->tagIndex_.find(tag);
+        std::erase(entity.tags_, &it->first);
+        eraseUnordered(it->second, &entity);
+        if (it->second.empty()) {
+            this->tagIndex_.erase(it);
+        }
+    }
+
+    bool EntityManager::isUnder(const Node* node, const Node* parentNode, bool recurse) noexcept {
+        const Node* ancestor = node->parent;
+        if (recurse) {
+            while (ancestor && ancestor != parentNode) {
+                ancestor = ancestor->parent;
+            }
+        }
+        return ancestor == parentNode;
+    }
+
+    Entity* EntityManager::getIndexedEntity(
+            const StringIndex& index, const std::string& key, const Entity* parent, bool recurse) const {
+
+        const Node* parentNode = this->getNodeFromEntity(parent);
+        auto it = index.find(key);
+        if (it == index.end()) return nullptr;
+
+        // Keep the first candidate in tree order
+        const Node* first = nullptr;
+        for (const Entity* entity : it->second) {
+            const Node* node = &this->nodes_[entity->index_];
+            if (!isUnder(node, parentNode, recurse)) continue;
+            if (!first || precedesInTree(node, first)) {
+                first = node;
+            }
+        }
+        return first ? first->ent : nullptr;
+    }
+
+    std::vector<Entity*> EntityManager::getIndexedEntities(
+            const StringIndex& index, const std::string& key, const Entity* parent, bool recurse) const {
+
+        const Node* parentNode = this->getNodeFromEntity(parent);
+        auto it = index.find(key);
+        if (it == index.end()) return {};
+
+        // Filter the candidates by their ancestors
+        std::vector<Entity*> entities;
+        for (Entity* entity : it->second) {
+            if (isUnder(&this->nodes_[entity->index_], parentNode, recurse)) {
+                entities.push_back(entity);
+            }
         }
+
+        // Order the matches as a traversal of the tree would
+        std::sort(entities.begin(), entities.end(), [this](const Entity* a, const Entity* b) {
+            return precedesInTree(&this->nodes_[a->index_], &this->nodes_[b->index_]);
+        });
+        return entities;
+    }
+
+    bool EntityManager::precedesInTree(const Node* a, const Node* b) noexcept {
+        if (a == b) return false;
+        size_t depthA = 0, depthB = 0;
+        for (const Node* node = a->parent; node; node = node->parent) {
+            depthA++;
+        }
+        for (const Node* node = b->parent; node; node = node->parent) {
+            depthB++;
+        }
+
+        // Lift the deeper node to the depth of the other, which is reached if it is an ancestor
+        bool aDeeper = depthA > depthB;
+        for (; depthA > depthB; depthA--) {
+            a = a->parent;
+        }
+        for (; depthB > depthA; depthB--) {
+            b = b->parent;
+        }
+        if (a == b) return !aDeeper;
+
+        // Lift both until they are siblings
+        while (a->parent != b->parent) {
+            a = a->parent;
+            b = b->parent;
+        }
+        return a->siblingOrder < b->siblingOrder;
     }
 
     void EntityManager::destroyNode(Node* node) noexcept {  // NOLINT
         if (node == nullptr) return;
         // Destroy all children
-        for (Node* child : node->children) {
+        for (Node* child = node->firstChild; child;) {
+            Node* next = child->nextSibling;
             this->destroyNode(child);
+            child = next;
+        }
+        // Destroy self, notifying the observers while the entity is still intact
+        this->recordChange();
+        this->notifyRemoveAll(*node->ent);
+        auto index = (std::uint32_t)node->ent->index_;
+        for (auto& [key, query] : this->queries_) {
+            query->erase(*node->ent);
+        }
+        this->unindexName(*node->ent);
+        while (!node->ent->tags_.empty()) {
+            this->unindexTag(*node->ent, *node->ent->tags_.back());
+        }
+        this->deleteEntity(node->ent);
+        this->releaseSlot(index);
+        this->freeIndices_.push_back(index);
+    }
+
+    void EntityManager::deleteEntity(Entity* entity) noexcept {
+        entity->~Entity();
+        this->memoryPool_.deallocate(entity, sizeof(Entity), alignof(Entity));
+    }
+
+    void EntityManager::releaseSlot(std::uint32_t index) noexcept {
+        Node& node = this->nodes_[index];
+        node.ent = nullptr;
+        node.parent = nullptr;
+        node.firstChild = nullptr;
+        node.lastChild = nullptr;
+        node.prevSibling = nullptr;
+        node.nextSibling = nullptr;
+        node.childCount = 0;
+        node.siblingOrder = 0;
+        node.dirty = false;
+        node.zOrder = 0;
+        node.worldDirty = false;
+        node.worldPending = false;
+        node.hasPrevious = false;
+        this->activeInWorld_[index] = false;
+        // Invalidate all IDs referring to the slot (generation 0 is skipped)
+        if (++this->generations_[index] == 0) {
+            this->generations_[index] = 1;
         }
-        // Destroy self
-        Entity::EntityID entID = node->ent->id_;
-        delete node->ent;
-        this->nodes_.erase(entID);
     }
 
     void EntityManager::destroyEntity(Entity& entity) noexcept {
-        Node* node = &this->nodes_.at(entity.id_);
-        Node* parent = node->parent;
+        Node* node = &this->nodes_[entity.index_];
         // Removes relation (parent --> node)
-        std::erase(parent->children, node);
+        unlinkChild(node);
         // Destroy node itself
         this->destroyNode(node);
     }
 
+    void EntityManager::destroyEntities(const std::vector<Entity::EntityID>& ids) {
+        // Mark the targets, so that targets whose ancestors are also targets are destroyed along with the ancestors
+        std::vector<Node*> targets;
+        std::vector<bool> marked(this->nodes_.size(), false);
+        for (Entity::EntityID id : ids) {
+            Entity* entity = this->getEntityByID(id);
+            if (!entity || marked[entity->index_]) continue;
+            marked[entity->index_] = true;
+            targets.push_back(&this->nodes_[entity->index_]);
+        }
+
+        // Skip targets with marked ancestors before destroying anything, as destroying a node resets its descendants
+        std::erase_if(targets, [this, &marked](const Node* node) {
+            for (const Node* ancestor = node->parent; ancestor != &this->root_; ancestor = ancestor->parent) {
+                if (marked[ancestor->ent->index_]) return true;
+            }
+            return false;
+        });
+
+        for (Node* node : targets) {
+            unlinkChild(node);
+            this->destroyNode(node);
+        }
+    }
+
     const EntityManager::Node* EntityManager::getNodeFromEntity(const Entity* entity) const {
         if (!entity) {
             return &this->root_;
         } else if (&entity->entityManager_ == this) {
-            return &this->nodes_.at(entity->id_);
+            return &this->nodes_[entity->index_];
         } else {
             throw std::invalid_argument("Parent Entity must be created by the same Entity Manager.");
         }
@@ -188,7 +444,7 @@ namespace corn {
         if (!entity) {
             return &this->root_;
         } else if (&entity->entityManager_ == this) {
-            return &this->nodes_.at(entity->id_);
+            return &this->nodes_[entity->index_];
         } else {
             throw std::invalid_argument("Parent Entity must be created by the same Entity Manager.");
         }
@@ -199,33 +455,391 @@ namespace corn {
             size_t limit, const Entity* parent, bool recurse) const {
 
         auto entities = std::vector<Entity*>();
-        auto nodeStack = std::stack<const Node*>();
-        const Node* parentNode = this->getNodeFromEntity(parent);
-        std::for_each(parentNode->children.rbegin(), parentNode->children.rend(), [&nodeStack](Node *child) {
-            nodeStack.push(child);
+        EntityView entityView(this->getNodeFromEntity(parent), recurse, onlyActive);
+        for (Entity* entity : entityView) {
+            // Add Entity pointer to vector if current Entity satisfy conditions
+            if (!pred || pred(entity)) {
+                entities.push_back(entity);
+                if ((--limit) == 0) break;
+            }
+        }
+        return entities;
+    }
+
+    void EntityManager::updateZOrder(const Entity& entity) noexcept {
+        Node& node = this->nodes_[entity.index_];
+        auto* transform = entity.getComponent<CTransform2D>();
+        int zOrder = transform ? transform->getZOrder() : 0;
+        if (zOrder == node.zOrder) return;
+        node.zOrder = zOrder;
+        this->markUnsorted(node.parent);
+    }
+
+    void EntityManager::markUnsorted(Node* node) noexcept {
+        // Transforms may change z-orders concurrently during parallel passes
+        std::unique_lock<std::mutex> lock(this->unsortedMutex_, std::defer_lock);
+        if (this->isStructureLocked()) {
+            lock.lock();
+        }
+        if (node->dirty) return;
+        node->dirty = true;
+        this->unsortedNodes_.push_back(node);
+    }
+
+    void EntityManager::sortChildren(Node& node) noexcept {
+        size_t budget = 8 * node.childCount;
+        Node* current = node.firstChild ? node.firstChild->nextSibling : nullptr;
+        while (current) {
+            Node* next = current->nextSibling;
+            Node* position = current->prevSibling;
+            while (position && position->zOrder > current->zOrder && budget > 0) {
+                position = position->prevSibling;
+                budget--;
+            }
+            if (budget == 0) break;
+            if (position != current->prevSibling) {
+                unlinkChild(current);
+                linkChild(&node, position ? position->nextSibling : node.firstChild, current);
+            }
+            current = next;
+        }
+        if (budget > 0) return;
+
+        // Too many children are out of place
+        std::vector<Node*> children;
+        children.reserve(node.childCount);
+        for (Node* child = node.firstChild; child; child = child->nextSibling) {
+            children.push_back(child);
+        }
+        std::stable_sort(children.begin(), children.end(), [](const Node* left, const Node* right) {
+            return left->zOrder < right->zOrder;
         });
-        while (!nodeStack.empty()) {
-            // Retrieve the next node
-            const Node* next = nodeStack.top();
-            nodeStack.pop();
+        for (Node* child : children) {
+            unlinkChild(child);
+            linkChild(&node, nullptr, child);
+        }
+    }
 
-            // Skip if not active
-            if (onlyActive && (next != &this->root_) && !next->ent->active_) continue;
+    void EntityManager::linkChild(Node* parent, Node* before, Node* child) noexcept {
+        child->parent = parent;
+        child->nextSibling = before;
+        child->prevSibling = before ? before->prevSibling : parent->lastChild;
+        if (child->prevSibling) {
+            child->prevSibling->nextSibling = child;
+        } else {
+            parent->firstChild = child;
+        }
+        if (before) {
+            before->prevSibling = child;
+        } else {
+            parent->lastChild = child;
+        }
+        parent->childCount++;
+
+        // Take a key between the neighbors, or renumber the siblings if there is no room
+        std::uint64_t low = child->prevSibling ? child->prevSibling->siblingOrder : 0;
+        std::uint64_t high = before ? before->siblingOrder : std::numeric_limits<std::uint64_t>::max();
+        if (!before && high - low > SIBLING_ORDER_SPACING) {
+            child->siblingOrder = low + SIBLING_ORDER_SPACING;
+        } else if (before && high - low > 1) {
+            child->siblingOrder = low + (high - low) / 2;
+        } else {
+            std::uint64_t order = 0;
+            for (Node* sibling = parent->firstChild; sibling; sibling = sibling->nextSibling) {
+                order += SIBLING_ORDER_SPACING;
+                sibling->siblingOrder = order;
+            }
+        }
+    }
 
-            // Add Entity pointer to vector if current Entity satisfy conditions
-            if (!pred || pred(next->ent)) {
-                entities.push_back(next->ent);
-                if ((--limit) == 0) break;
+    void EntityManager::unlinkChild(Node* child) noexcept {
+        Node* parent = child->parent;
+        if (child->prevSibling) {
+            child->prevSibling->nextSibling = child->nextSibling;
+        } else {
+            parent->firstChild = child->nextSibling;
+        }
+        if (child->nextSibling) {
+            child->nextSibling->prevSibling = child->prevSibling;
+        } else {
+            parent->lastChild = child->prevSibling;
+        }
+        child->prevSibling = nullptr;
+        child->nextSibling = nullptr;
+        parent->childCount--;
+    }
+
+    EntityManager::Node* EntityManager::nextInTree(const Node* node, const Node* top, bool descend) noexcept {
+        if (descend && node->firstChild) return node->firstChild;
+        while (node != top) {
+            if (node->nextSibling) return node->nextSibling;
+            node = node->parent;
+        }
+        return nullptr;
+    }
+
+    void EntityManager::invalidateWorldCache(const Entity& entity) noexcept {
+        // Deferred until the end of the parallel pass
+        if (this->transformPasses_ > 0) return;
+        Node* node = &this->nodes_[entity.index_];
+        if (node->worldDirty) return;
+        // Mark the path from the root, so that the refresh can find the node
+        for (Node* ancestor = node->parent; ancestor && !ancestor->worldPending; ancestor = ancestor->parent) {
+            ancestor->worldPending = true;
+        }
+        markWorldDirty(node);
+    }
+
+    void EntityManager::markWorldDirty(Node* node) noexcept {  // NOLINT
+        node->worldDirty = true;
+        for (Node* child = node->firstChild; child; child = child->nextSibling) {
+            // Descendants of a dirty node are already dirty
+            if (!child->worldDirty) {
+                markWorldDirty(child);
+            }
+        }
+    }
+
+    const EntityManager::Node& EntityManager::getUpdatedNode(const Entity& entity) noexcept {
+        Node& node = this->nodes_[entity.index_];
+        if (node.worldDirty) {
+            this->refreshWorldCache(node);
+        }
+        return node;
+    }
+
+    void EntityManager::refreshWorldCache(Node& node) noexcept {  // NOLINT
+        Node& parent = *node.parent;
+        if (parent.worldDirty) {
+            this->refreshWorldCache(parent);
+        }
+
+        // Transform
+        auto* transform = node.ent->getComponent<CTransform2D>();
+        if (transform) {
+            node.worldLocation = parent.worldLocation + rotate(transform->getLocation(), parent.worldSin, parent.worldCos);
+            node.worldRotation = parent.worldRotation + transform->getRotation();
+            node.worldSin = node.worldRotation.sin();
+            node.worldCos = node.worldRotation.cos();
+        } else {
+            node.worldLocation = parent.worldLocation;
+            node.worldRotation = parent.worldRotation;
+            node.worldSin = parent.worldSin;
+            node.worldCos = parent.worldCos;
+        }
+
+        // Movement
+        auto* movement = node.ent->getComponent<CMovement2D>();
+        if (movement) {
+            node.worldVelocity = parent.worldVelocity + rotate(movement->getVelocity(), parent.worldSin, parent.worldCos);
+            node.worldAngularVelocity = parent.worldAngularVelocity + movement->getAngularVelocity();
+        } else {
+            node.worldVelocity = parent.worldVelocity;
+            node.worldAngularVelocity = parent.worldAngularVelocity;
+        }
+
+        // Children remain dirty, so the refresh must still visit the node
+        node.worldDirty = false;
+        node.worldPending = true;
+    }
+
+    void EntityManager::refreshWorldCaches(Node& node) noexcept {  // NOLINT
+        node.worldPending = false;
+        for (Node* child = node.firstChild; child; child = child->nextSibling) {
+            if (!child->worldDirty && !child->worldPending) continue;
+            if (child->worldDirty) {
+                this->refreshWorldCache(*child);
             }
+            this->refreshWorldCaches(*child);
+        }
+    }
 
-            // Add children to stack
-            if (recurse) {
-                std::for_each(next->children.rbegin(), next->children.rend(), [&nodeStack](Node *child) {
-                    nodeStack.push(child);
+    bool EntityManager::removeObserver(ObserverID id) {
+        if (this->isStructureLocked()) {
+            throw std::logic_error("Cannot change the observers during a parallel pass.");
+        }
+        for (ObserverLists& lists : this->observers_) {
+            for (std::vector<Observer>& list : lists) {
+                auto it = std::find_if(list.begin(), list.end(), [id](const Observer& observer) {
+                    return observer.id == id;
                 });
+                if (it != list.end()) {
+                    list.erase(it);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    EntityManager::ObserverID EntityManager::addObserver(
+            size_t typeID, ObserverEvent event, std::function<void(Entity&, Component&)> callback) {
+
+        if (this->isStructureLocked()) {
+            throw std::logic_error("Cannot change the observers during a parallel pass.");
+        }
+        if (typeID >= this->observers_.size()) {
+            this->observers_.resize(typeID + 1);
+        }
+        ObserverID id = this->nextObserverID_++;
+        this->observers_[typeID][(size_t)event].push_back({ id, std::move(callback) });
+        return id;
+    }
+
+    bool EntityManager::hasObservers(size_t typeID, ObserverEvent event) const noexcept {
+        return typeID < this->observers_.size() && !this->observers_[typeID][(size_t)event].empty();
+    }
+
+    void EntityManager::notifyObservers(size_t typeID, ObserverEvent event, Entity& entity, Component& component) {
+        if (!this->hasObservers(typeID, event)) return;
+        for (const Observer& observer : this->observers_[typeID][(size_t)event]) {
+            observer.callback(entity, component);
+        }
+    }
+
+    void EntityManager::notifyRemoveAll(Entity& entity) {
+        const ComponentSignature& signature = entity.signature_;
+        size_t count = std::min(this->observers_.size(), MAX_COMPONENT_TYPES);
+        for (size_t typeID = 0; typeID < count; typeID++) {
+            if (!signature.test(typeID) || !this->hasObservers(typeID, ObserverEvent::REMOVE)) continue;
+            ComponentPoolBase* pool = this->componentStorage_.findPool(typeID);
+            Component* component = pool ? pool->getBase(entity.index_) : nullptr;
+            if (component) {
+                this->notifyObservers(typeID, ObserverEvent::REMOVE, entity, *component);
+            }
+        }
+    }
+
+    void EntityManager::snapshotTransforms() noexcept {
+        this->tidy();
+        for (Node& node : this->nodes_) {
+            if (!node.ent) continue;
+            node.prevWorldLocation = node.worldLocation;
+            node.prevWorldRotation = node.worldRotation;
+            node.hasPrevious = true;
+        }
+    }
+
+    void EntityManager::resetInterpolation(const Entity& entity) noexcept {
+        // Walk the subtree through the links between the nodes, so that no stack is allocated
+        Node* root = &this->nodes_[entity.index_];
+        Node* node = root;
+        while (true) {
+            node->hasPrevious = false;
+            if (node->firstChild) {
+                node = node->firstChild;
+                continue;
+            }
+            while (node != root && !node->nextSibling) {
+                node = node->parent;
+            }
+            if (node == root) break;
+            node = node->nextSibling;
+        }
+    }
+
+    float EntityManager::getInterpolationAlpha() const noexcept {
+        return this->interpolationAlpha_;
+    }
+
+    void EntityManager::setInterpolationAlpha(float alpha) noexcept {
+        this->interpolationAlpha_ = std::clamp(alpha, 0.0f, 1.0f);
+    }
+
+    std::uint64_t EntityManager::getTick() const noexcept {
+        return this->tick_;
+    }
+
+    std::uint64_t EntityManager::getLastChangeTick() const noexcept {
+        return this->lastChangeTick_.load(std::memory_order_relaxed);
+    }
+
+    void EntityManager::recordChange() noexcept {
+        // Read before writing, so that concurrent changes in the same tick do not contend for the cache line
+        if (this->lastChangeTick_.load(std::memory_order_relaxed) != this->tick_) {
+            this->lastChangeTick_.store(this->tick_, std::memory_order_relaxed);
+        }
+    }
+
+    std::uint64_t EntityManager::advanceTick() noexcept {
+        return ++this->tick_;
+    }
+
+    bool EntityManager::isStructureLocked() const noexcept {
+        return this->parallelPasses_ > 0;
+    }
+
+    void EntityManager::beginParallelPass(bool accessed, bool transformed) noexcept {
+        ++this->parallelPasses_;
+        if (!accessed) return;
+        std::lock_guard<std::mutex> lock(this->passMutex_);
+        if (this->root_.worldPending) {
+            this->refreshWorldCaches(this->root_);
+        }
+        if (transformed) {
+            ++this->transformPasses_;
+        }
+    }
+
+    void EntityManager::endParallelPass(const std::vector<Entity*>& entities, bool transformed) noexcept {
+        if (transformed) {
+            // Passes running concurrently may end in any order, so invalidate the entities of all of them at the end
+            std::lock_guard<std::mutex> lock(this->passMutex_);
+            this->pendingInvalidations_.insert(this->pendingInvalidations_.end(), entities.begin(), entities.end());
+            if (--this->transformPasses_ == 0) {
+                for (Entity* entity : this->pendingInvalidations_) {
+                    this->invalidateWorldCache(*entity);
+                }
+                this->pendingInvalidations_.clear();
+            }
+        }
+        --this->parallelPasses_;
+    }
+
+    void EntityManager::addQuery(std::type_index key, std::unique_ptr<QueryBase> query) {
+        ComponentSignature types = query->with_ | query->without_;
+        for (size_t id = 0; id < types.size(); id++) {
+            if (!types.test(id)) continue;
+            if (id >= this->queriesByComponent_.size()) {
+                this->queriesByComponent_.resize(id + 1);
+            }
+            this->queriesByComponent_[id].push_back(query.get());
+        }
+        for (Entity* entity : this->activeView()) {
+            query->update(*entity, true);
+        }
+        this->queries_.emplace(key, std::move(query));
+    }
+
+    void EntityManager::updateQueries(Entity& entity, size_t typeID) {
+        if (typeID >= this->queriesByComponent_.size() || this->queriesByComponent_[typeID].empty()) return;
+        bool activeInWorld = entity.isActiveInWorld();
+        for (QueryBase* query : this->queriesByComponent_[typeID]) {
+            query->update(entity, activeInWorld);
+        }
+    }
+
+    void EntityManager::updateActiveInWorld(Entity& entity) {
+        this->recordChange();
+        std::vector<Node*> nodeStack = { &this->nodes_[entity.index_] };
+        while (!nodeStack.empty()) {
+            Node* node = nodeStack.back();
+            nodeStack.pop_back();
+
+            // Stop at entities whose flag does not flip, as their descendants do not flip either
+            const Node* parent = node->parent;
+            bool parentActive = parent == &this->root_ || this->activeInWorld_[parent->ent->index_];
+            bool activeInWorld = parentActive && node->ent->active_;
+            if (this->activeInWorld_[node->ent->index_] == activeInWorld) continue;
+            this->activeInWorld_[node->ent->index_] = activeInWorld;
+
+            for (auto& [key, query] : this->queries_) {
+                query->update(*node->ent, activeInWorld);
+            }
+            for (Node* child = node->firstChild; child; child = child->nextSibling) {
+                nodeStack.push_back(child);
             }
         }
-        return entities;
     }
 
     const Game* EntityManager::getGame() const noexcept {
@@ -259,7 +873,7 @@ namespace corn {
             }
 
             // Calculate the world position
-            Vec2 cameraCenter = camera->getEntity().getComponent<CTransform2D>()->getWorldTransform().first +
+            Vec2 cameraCenter = camera->getEntity().getComponent<CTransform2D>()->getRenderTransform().first +
                                 camera->anchor.vec2();
             Vec2 fovSize(camera->fovW.calc(1.0f, viewportSize.x / 100, viewportSize.y / 100) * (1 / camera->scale),
                          camera->fovH.calc(1.0f, viewportSize.x / 100, viewportSize.y / 100) * (1 / camera->scale));
@@ -0,0 +1,180 @@
+#include <corn/ecs/integration.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CORN_SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER  // MSVC
+#include <intrin.h>
+#define CORN_TARGET_AVX2
+#else
+#define CORN_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace corn {
+    void MotionBatch::resize(size_t size) {
+        this->x.resize(size);
+        this->y.resize(size);
+        this->rotation.resize(size);
+        this->vx.resize(size);
+        this->vy.resize(size);
+        this->angularVelocity.resize(size);
+        this->gravityScale.resize(size);
+        this->parentSin.resize(size);
+        this->parentCos.resize(size);
+    }
+
+    size_t MotionBatch::size() const noexcept {
+        return this->x.size();
+    }
+
+    /// @return Whether the CPU and the operating system support AVX2.
+    static bool detectAVX2() noexcept {
+#if !defined(CORN_SIMD_X86)
+        return false;
+#elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        bool osxsave = info[2] & (1 << 27);
+        if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) return false;  // YMM state saved by the OS
+        __cpuidex(info, 7, 0);
+        return info[1] & (1 << 5);
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+    SimdLevel getSimdLevel() noexcept {
+#ifdef CORN_SIMD_X86
+        static const SimdLevel level = detectAVX2() ? SimdLevel::AVX2 : SimdLevel::SSE2;
+        return level;
+#else
+        return SimdLevel::SCALAR;
+#endif
+    }
+
+    /**
+     * @brief Scalar kernel of `integrateMovement`, also handling the remainder of the vectorized kernels.
+     * @param begin Index of the first body to integrate.
+     */
+    static void integrateMovementScalar(MotionBatch& batch, float seconds, size_t begin) noexcept {
+        for (size_t i = begin; i < batch.size(); i++) {
+            float ox = batch.vx[i] * seconds;
+            float oy = batch.vy[i] * seconds;
+            batch.x[i] += ox * batch.parentCos[i] - oy * batch.parentSin[i];
+            batch.y[i] += ox * batch.parentSin[i] + oy * batch.parentCos[i];
+            batch.rotation[i] += batch.angularVelocity[i] * seconds;
+        }
+    }
+
+    /**
+     * @brief Scalar kernel of `integrateGravity`, also handling the remainder of the vectorized kernels.
+     * @param begin Index of the first body to integrate.
+     */
+    static void integrateGravityScalar(MotionBatch& batch, float gSeconds, size_t begin) noexcept {
+        for (size_t i = begin; i < batch.size(); i++) {
+            float oy = batch.gravityScale[i] * gSeconds;
+            batch.vx[i] -= oy * batch.parentSin[i];
+            batch.vy[i] += oy * batch.parentCos[i];
+        }
+    }
+
+#ifdef CORN_SIMD_X86
+    /// @return Number of bodies integrated by the SSE2 kernel of `integrateMovement`.
+    static size_t integrateMovementSSE2(MotionBatch& batch, float seconds) noexcept {
+        size_t n = batch.size() / 4 * 4;
+        __m128 dt = _mm_set1_ps(seconds);
+        for (size_t i = 0; i < n; i += 4) {
+            __m128 ox = _mm_mul_ps(_mm_loadu_ps(&batch.vx[i]), dt);
+            __m128 oy = _mm_mul_ps(_mm_loadu_ps(&batch.vy[i]), dt);
+            __m128 sin = _mm_loadu_ps(&batch.parentSin[i]);
+            __m128 cos = _mm_loadu_ps(&batch.parentCos[i]);
+            __m128 dx = _mm_sub_ps(_mm_mul_ps(ox, cos), _mm_mul_ps(oy, sin));
+            __m128 dy = _mm_add_ps(_mm_mul_ps(ox, sin), _mm_mul_ps(oy, cos));
+            __m128 dr = _mm_mul_ps(_mm_loadu_ps(&batch.angularVelocity[i]), dt);
+            _mm_storeu_ps(&batch.x[i], _mm_add_ps(_mm_loadu_ps(&batch.x[i]), dx));
+            _mm_storeu_ps(&batch.y[i], _mm_add_ps(_mm_loadu_ps(&batch.y[i]), dy));
+            _mm_storeu_ps(&batch.rotation[i], _mm_add_ps(_mm_loadu_ps(&batch.rotation[i]), dr));
+        }
+        return n;
+    }
+
+    /// @return Number of bodies integrated by the SSE2 kernel of `integrateGravity`.
+    static size_t integrateGravitySSE2(MotionBatch& batch, float gSeconds) noexcept {
+        size_t n = batch.size() / 4 * 4;
+        __m128 gdt = _mm_set1_ps(gSeconds);
+        for (size_t i = 0; i < n; i += 4) {
+            __m128 oy = _mm_mul_ps(_mm_loadu_ps(&batch.gravityScale[i]), gdt);
+            __m128 dvx = _mm_mul_ps(oy, _mm_loadu_ps(&batch.parentSin[i]));
+            __m128 dvy = _mm_mul_ps(oy, _mm_loadu_ps(&batch.parentCos[i]));
+            _mm_storeu_ps(&batch.vx[i], _mm_sub_ps(_mm_loadu_ps(&batch.vx[i]), dvx));
+            _mm_storeu_ps(&batch.vy[i], _mm_add_ps(_mm_loadu_ps(&batch.vy[i]), dvy));
+        }
+        return n;
+    }
+
+    /// @return Number of bodies integrated by the AVX2 kernel of `integrateMovement`.
+    CORN_TARGET_AVX2 static size_t integrateMovementAVX2(MotionBatch& batch, float seconds) noexcept {
+        size_t n = batch.size() / 8 * 8;
+        __m256 dt = _mm256_set1_ps(seconds);
+        for (size_t i = 0; i < n; i += 8) {
+            __m256 ox = _mm256_mul_ps(_mm256_loadu_ps(&batch.vx[i]), dt);
+            __m256 oy = _mm256_mul_ps(_mm256_loadu_ps(&batch.vy[i]), dt);
+            __m256 sin = _mm256_loadu_ps(&batch.parentSin[i]);
+            __m256 cos = _mm256_loadu_ps(&batch.parentCos[i]);
+            __m256 dx = _mm256_sub_ps(_mm256_mul_ps(ox, cos), _mm256_mul_ps(oy, sin));
+            __m256 dy = _mm256_add_ps(_mm256_mul_ps(ox, sin), _mm256_mul_ps(oy, cos));
+            __m256 dr = _mm256_mul_ps(_mm256_loadu_ps(&batch.angularVelocity[i]), dt);
+            _mm256_storeu_ps(&batch.x[i], _mm256_add_ps(_mm256_loadu_ps(&batch.x[i]), dx));
+            _mm256_storeu_ps(&batch.y[i], _mm256_add_ps(_mm256_loadu_ps(&batch.y[i]), dy));
+            _mm256_storeu_ps(&batch.rotation[i], _mm256_add_ps(_mm256_loadu_ps(&batch.rotation[i]), dr));
+        }
+        return n;
+    }
+
+    /// @return Number of bodies integrated by the AVX2 kernel of `integrateGravity`.
+    CORN_TARGET_AVX2 static size_t integrateGravityAVX2(MotionBatch& batch, float gSeconds) noexcept {
+        size_t n = batch.size() / 8 * 8;
+        __m256 gdt = _mm256_set1_ps(gSeconds);
+        for (size_t i = 0; i < n; i += 8) {
+            __m256 oy = _mm256_mul_ps(_mm256_loadu_ps(&batch.gravityScale[i]), gdt);
+            __m256 dvx = _mm256_mul_ps(oy, _mm256_loadu_ps(&batch.parentSin[i]));
+            __m256 dvy = _mm256_mul_ps(oy, _mm256_loadu_ps(&batch.parentCos[i]));
+            _mm256_storeu_ps(&batch.vx[i], _mm256_sub_ps(_mm256_loadu_ps(&batch.vx[i]), dvx));
+            _mm256_storeu_ps(&batch.vy[i], _mm256_add_ps(_mm256_loadu_ps(&batch.vy[i]), dvy));
+        }
+        return n;
+    }
+#endif
+
+    void integrateMovement(MotionBatch& batch, float seconds, SimdLevel level) noexcept {
+        size_t done = 0;
+#ifdef CORN_SIMD_X86
+        if (level == SimdLevel::AVX2 && getSimdLevel() == SimdLevel::AVX2) {
+            done = integrateMovementAVX2(batch, seconds);
+        } else if (level != SimdLevel::SCALAR) {
+            done = integrateMovementSSE2(batch, seconds);
+        }
+#else
+        (void)level;
+#endif
+        integrateMovementScalar(batch, seconds, done);
+    }
+
+    void integrateGravity(MotionBatch& batch, float g, float seconds, SimdLevel level) noexcept {
+        float gSeconds = g * seconds;
+        size_t done = 0;
+#ifdef CORN_SIMD_X86
+        if (level == SimdLevel::AVX2 && getSimdLevel() == SimdLevel::AVX2) {
+            done = integrateGravityAVX2(batch, gSeconds);
+        } else if (level != SimdLevel::SCALAR) {
+            done = integrateGravitySSE2(batch, gSeconds);
+        }
+#else
+        (void)level;
+#endif
+        integrateGravityScalar(batch, gSeconds, done);
+    }
+}
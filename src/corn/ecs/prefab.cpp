@@ -0,0 +1,163 @@
+#include <stdexcept>
+#include <utility>
+#include <corn/ecs/entity_manager.h>
+#include <corn/ecs/prefab.h>
+
+namespace corn {
+    Prefab::Prefab(std::string name) : nodes_() {
+        this->nodes_.push_back({ std::move(name), ROOT, {} });
+    }
+
+    size_t Prefab::addChild(std::string name, size_t parent) {
+        if (parent >= this->nodes_.size()) {
+            throw std::out_of_range("Parent node does not exist in the prefab.");
+        }
+        this->nodes_.push_back({ std::move(name), parent, {} });
+        return this->nodes_.size() - 1;
+    }
+
+    size_t Prefab::size() const noexcept {
+        return this->nodes_.size();
+    }
+
+    Entity& Prefab::instantiate(EntityManager& entityManager, const Entity* parent) const {
+        std::vector<Entity*> entities;
+        entities.reserve(this->nodes_.size());
+        this->create(entityManager, parent, entities);
+        return *entities[ROOT];
+    }
+
+    std::vector<Entity*> Prefab::instantiate(EntityManager& entityManager, size_t count, const Entity* parent) const {
+        this->reserve(entityManager, count);
+        std::vector<Entity*> roots;
+        roots.reserve(count);
+        std::vector<Entity*> entities;
+        entities.reserve(this->nodes_.size());
+        for (size_t i = 0; i < count; i++) {
+            this->create(entityManager, parent, entities);
+            roots.push_back(entities[ROOT]);
+        }
+        return roots;
+    }
+
+    void Prefab::reserve(EntityManager& entityManager, size_t count) const {
+        entityManager.reserve(count * this->nodes_.size());
+        for (const NodeTemplate& node : this->nodes_) {
+            for (const ComponentTemplate& component : node.components) {
+                component.reserve(entityManager, count);
+            }
+        }
+    }
+
+    void Prefab::create(EntityManager& entityManager, const Entity* parent, std::vector<Entity*>& entities) const {
+        entities.clear();
+        for (size_t i = 0; i < this->nodes_.size(); i++) {
+            const NodeTemplate& node = this->nodes_[i];
+            Entity& entity = entityManager.createEntity(node.name, i == ROOT ? parent : entities[node.parent]);
+            entities.push_back(&entity);
+            for (const ComponentTemplate& component : node.components) {
+                component.add(entity);
+            }
+        }
+    }
+
+    void Prefab::reset(const std::vector<Entity*>& entities) const {
+        for (size_t i = 0; i < this->nodes_.size(); i++) {
+            Entity* entity = entities[i];
+            if (!entity) continue;
+            for (const ComponentTemplate& component : this->nodes_[i].components) {
+                component.reset(*entity);
+            }
+            if (i != ROOT) {
+                entity->setActive(true);
+            }
+        }
+    }
+
+    PrefabPool::PrefabPool(Prefab prefab, EntityManager& entityManager, const Entity* parent)
+            : prefab_(std::move(prefab)), entityManager_(entityManager), parentID_(parent ? parent->getID() : 0),
+            instances_(), released_(), slotOfRoot_(), buffer_() {}
+
+    const Prefab& PrefabPool::getPrefab() const noexcept {
+        return this->prefab_;
+    }
+
+    Entity& PrefabPool::acquire() {
+        while (!this->released_.empty()) {
+            size_t slot = this->released_.back();
+            this->released_.pop_back();
+            Instance& instance = this->instances_[slot];
+            instance.released = false;
+            Entity* root = this->entityManager_.getEntityByID(instance.ids[Prefab::ROOT]);
+            if (!root) {
+                // Destroyed by other means, so the slot is reused for a new instance
+                return this->create(slot);
+            }
+            this->buffer_.clear();
+            for (Entity::EntityID id : instance.ids) {
+                this->buffer_.push_back(this->entityManager_.getEntityByID(id));
+            }
+            this->prefab_.reset(this->buffer_);
+            root->setActive(true);
+            this->entityManager_.resetInterpolation(*root);
+            return *root;
+        }
+        this->instances_.push_back({ {}, false });
+        return this->create(this->instances_.size() - 1);
+    }
+
+    bool PrefabPool::release(Entity& root) {
+        size_t index = Entity::indexOf(root.getID());
+        if (index >= this->slotOfRoot_.size() || this->slotOfRoot_[index] >= this->instances_.size()) return false;
+        size_t slot = this->slotOfRoot_[index];
+        Instance& instance = this->instances_[slot];
+        if (instance.ids[Prefab::ROOT] != root.getID() || instance.released) return false;
+        root.setActive(false);
+        instance.released = true;
+        this->released_.push_back(slot);
+        return true;
+    }
+
+    void PrefabPool::reserve(size_t count) {
+        if (count <= this->released_.size()) return;
+        size_t missing = count - this->released_.size();
+        this->prefab_.reserve(this->entityManager_, missing);
+        this->instances_.reserve(this->instances_.size() + missing);
+        this->released_.reserve(count);
+        for (size_t i = 0; i < missing; i++) {
+            this->instances_.push_back({ {}, true });
+            size_t slot = this->instances_.size() - 1;
+            this->create(slot).setActive(false);
+            this->released_.push_back(slot);
+        }
+    }
+
+    size_t PrefabPool::available() const noexcept {
+        return this->released_.size();
+    }
+
+    const Entity* PrefabPool::getParent() const {
+        if (!this->parentID_) return nullptr;
+        const Entity* parent = this->entityManager_.getEntityByID(this->parentID_);
+        if (!parent) {
+            throw std::logic_error("The parent entity of the prefab pool is destroyed.");
+        }
+        return parent;
+    }
+
+    Entity& PrefabPool::create(size_t slot) {
+        this->prefab_.create(this->entityManager_, this->getParent(), this->buffer_);
+        Instance& instance = this->instances_[slot];
+        instance.ids.clear();
+        for (Entity* entity : this->buffer_) {
+            instance.ids.push_back(entity->getID());
+        }
+        Entity& root = *this->buffer_[Prefab::ROOT];
+        size_t index = Entity::indexOf(root.getID());
+        if (index >= this->slotOfRoot_.size()) {
+            this->slotOfRoot_.resize(index + 1, static_cast<size_t>(-1));
+        }
+        this->slotOfRoot_[index] = slot;
+        return root;
+    }
+}
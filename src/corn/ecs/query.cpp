@@ -0,0 +1,66 @@
+#include <corn/ecs/component_pool.h>
+#include <corn/ecs/query.h>
+
+namespace corn {
+    QueryBase::QueryBase(const ComponentSignature& with, const ComponentSignature& without) noexcept
+            : with_(with), without_(without), entities_(), positions_() {}
+
+    QueryBase::~QueryBase() = default;
+
+    const std::vector<Entity*>& QueryBase::getEntities() const noexcept {
+        return this->entities_;
+    }
+
+    size_t QueryBase::size() const noexcept {
+        return this->entities_.size();
+    }
+
+    bool QueryBase::empty() const noexcept {
+        return this->entities_.empty();
+    }
+
+    bool QueryBase::matches(const Entity& entity) const noexcept {
+        const ComponentSignature& signature = entity.getSignature();
+        return (signature & this->with_) == this->with_ && (signature & this->without_).none();
+    }
+
+    QueryBase::Iterator QueryBase::begin() const noexcept {
+        return this->entities_.begin();
+    }
+
+    QueryBase::Iterator QueryBase::end() const noexcept {
+        return this->entities_.end();
+    }
+
+    void QueryBase::update(Entity& entity, bool activeInWorld) {
+        bool match = activeInWorld && this->matches(entity);
+        bool contained = entity.index_ < this->positions_.size() &&
+                this->positions_[entity.index_] != ComponentPoolBase::NPOS;
+        if (match && !contained) {
+            if (entity.index_ >= this->positions_.size()) {
+                this->positions_.resize(entity.index_ + 1, ComponentPoolBase::NPOS);
+            }
+            this->positions_[entity.index_] = this->entities_.size();
+            this->entities_.push_back(&entity);
+        } else if (!match && contained) {
+            this->erase(entity);
+        }
+    }
+
+    void QueryBase::erase(const Entity& entity) noexcept {
+        if (entity.index_ >= this->positions_.size()) return;
+        size_t position = this->positions_[entity.index_];
+        if (position == ComponentPoolBase::NPOS) return;
+        // Move the last entity into the vacated position
+        Entity* last = this->entities_.back();
+        this->entities_[position] = last;
+        this->positions_[last->index_] = position;
+        this->entities_.pop_back();
+        this->positions_[entity.index_] = ComponentPoolBase::NPOS;
+    }
+
+    void QueryBase::clear() noexcept {
+        this->entities_.clear();
+        this->positions_.clear();
+    }
+}
@@ -1,12 +1,23 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
 #include <vector>
 #include <corn/core/scene.h>
 #include <corn/ecs/component.h>
 #include <corn/ecs/entity_manager.h>
+#include <corn/ecs/integration.h>
 #include <corn/ecs/system.h>
 #include <corn/event/event_args.h>
+#include <corn/event/event_manager.h>
+#include "broadphase.h"
 
 namespace corn {
-    System::System(Scene& scene) noexcept : scene_(scene), active_(true) {}
+    System::System(Scene& scene) noexcept
+            : scene_(scene), active_(true), exclusive_(true), reads_(), writes_(), lastRunTick_(0) {}
 
     System::~System() = default;
 
@@ -15,7 +26,9 @@ namespace corn {
     }
 
     void System::setActive(bool active) noexcept {
+        if (this->active_ == active) return;
         this->active_ = active;
+        this->scene_.stagesDirty_ = true;
     }
 
     Scene& System::getScene() const noexcept {
@@ -26,41 +39,255 @@ namespace corn {
         return this->scene_.getGame();
     }
 
-    SMovement2D::SMovement2D(Scene& scene) noexcept : System(scene) {}
+    bool System::isExclusive() const noexcept {
+        return this->exclusive_;
+    }
 
-    void SMovement2D::update(float millis) {
-        for (Entity* entity : this->getScene().getEntityManager().getActiveEntitiesWith<CTransform2D, CMovement2D>()) {
-            auto transform = entity->getComponent<CTransform2D>();
-            auto movement = entity->getComponent<CMovement2D>();
-            if (!transform->active || !movement->active) continue;
-            transform->addWorldLocationOffset(movement->velocity * (millis / 1000.0f));
-            transform->rotation += movement->angularVelocity * (millis / 1000.0f);
+    std::uint64_t System::getLastRunTick() const noexcept {
+        return this->lastRunTick_;
+    }
+
+    const std::vector<std::type_index>& System::getReads() const noexcept {
+        return this->reads_;
+    }
+
+    const std::vector<std::type_index>& System::getWrites() const noexcept {
+        return this->writes_;
+    }
+
+    bool System::conflictsWith(const System& other) const noexcept {
+        if (this->exclusive_ || other.exclusive_) return true;
+        auto overlaps = [](const std::vector<std::type_index>& types1, const std::vector<std::type_index>& types2) {
+            return std::ranges::any_of(types1, [&types2](std::type_index type) {
+                return std::ranges::find(types2, type) != types2.end();
+            });
+        };
+        return overlaps(this->writes_, other.reads_) || overlaps(this->writes_, other.writes_) ||
+               overlaps(this->reads_, other.writes_);
+    }
+
+    void System::declareAccess(const std::vector<std::type_index>& types, bool write) {
+        this->exclusive_ = false;
+        this->scene_.stagesDirty_ = true;
+        std::vector<std::type_index>& list = write ? this->writes_ : this->reads_;
+        auto add = [&list](std::type_index type) {
+            if (std::ranges::find(list, type) == list.end()) {
+                list.push_back(type);
+            }
+        };
+        for (std::type_index type : types) {
+            // Transforms and movements share the world transforms cached by the entity manager
+            if (type == typeid(CTransform2D) || type == typeid(CMovement2D)) {
+                add(typeid(CTransform2D));
+                add(typeid(CMovement2D));
+            } else {
+                add(type);
+            }
         }
     }
 
-    SGravity::SGravity(Scene& scene, float g) noexcept : System(scene), g(g) {}
+    SMovement2D::SMovement2D(Scene& scene) noexcept : System(scene) {
+        this->reads<CMovement2D>();
+        this->writes<CTransform2D>();
+    }
+
+    void SMovement2D::update(float millis) {
+        float seconds = millis / 1000.0f;
+        EntityManager& entityManager = this->getScene().getEntityManager();
+        entityManager.forEachChunkParallel<CTransform2D, const CMovement2D>(
+                [&entityManager, seconds](std::span<Entity* const> chunk) {
+                    // Gather the chunk into arrays, integrate in batch, and write back
+                    thread_local MotionBatch batch;
+                    thread_local std::vector<CTransform2D*> transforms;
+                    batch.resize(chunk.size());
+                    transforms.clear();
+                    for (Entity* entity : chunk) {
+                        auto* transform = entity->getComponent<CTransform2D>();
+                        const auto* movement = entity->getComponent<CMovement2D>();
+                        if (!transform->active || !movement->active) continue;
+                        const EntityManager::Node& parent = *entityManager.getUpdatedNode(*entity).parent;
+                        size_t i = transforms.size();
+                        Vec2 location = transform->getLocation();
+                        Vec2 velocity = movement->getVelocity();
+                        batch.x[i] = location.x;
+                        batch.y[i] = location.y;
+                        batch.rotation[i] = transform->getRotation().get();
+                        batch.vx[i] = velocity.x;
+                        batch.vy[i] = velocity.y;
+                        batch.angularVelocity[i] = movement->getAngularVelocity();
+                        batch.parentSin[i] = parent.worldSin;
+                        batch.parentCos[i] = parent.worldCos;
+                        transforms.push_back(transform);
+                    }
+                    batch.resize(transforms.size());
+                    integrateMovement(batch, seconds);
+                    for (size_t i = 0; i < transforms.size(); i++) {
+                        transforms[i]->setTransform(Vec2(batch.x[i], batch.y[i]), batch.rotation[i]);
+                    }
+                });
+    }
+
+    SGravity::SGravity(Scene& scene, float g) noexcept : System(scene), g(g) {
+        this->reads<CGravity2D>();
+        this->writes<CMovement2D>();
+    }
 
     void SGravity::update(float millis) {
-        for (Entity* entity : this->getScene().getEntityManager().getActiveEntitiesWith<CMovement2D, CGravity2D>()) {
-            auto movement = entity->getComponent<CMovement2D>();
-            auto gravity2D = entity->getComponent<CGravity2D>();
-            if (!movement->active || !gravity2D->active) continue;
-            movement->addWorldVelocityOffset(
-                    Vec2(0, this->g * gravity2D->scale * (millis / 1000.0f)));
+        float seconds = millis / 1000.0f;
+        EntityManager& entityManager = this->getScene().getEntityManager();
+        entityManager.forEachChunkParallel<CMovement2D, const CGravity2D>(
+                [this, &entityManager, seconds](std::span<Entity* const> chunk) {
+                    // Gather the chunk into arrays, integrate in batch, and write back
+                    thread_local MotionBatch batch;
+                    thread_local std::vector<CMovement2D*> movements;
+                    batch.resize(chunk.size());
+                    movements.clear();
+                    for (Entity* entity : chunk) {
+                        auto* movement = entity->getComponent<CMovement2D>();
+                        const auto* gravity2D = entity->getComponent<CGravity2D>();
+                        if (!movement->active || !gravity2D->active) continue;
+                        const EntityManager::Node& parent = *entityManager.getUpdatedNode(*entity).parent;
+                        size_t i = movements.size();
+                        Vec2 velocity = movement->getVelocity();
+                        batch.vx[i] = velocity.x;
+                        batch.vy[i] = velocity.y;
+                        batch.gravityScale[i] = gravity2D->scale;
+                        batch.parentSin[i] = parent.worldSin;
+                        batch.parentCos[i] = parent.worldCos;
+                        movements.push_back(movement);
+                    }
+                    batch.resize(movements.size());
+                    integrateGravity(batch, this->g, seconds);
+                    for (size_t i = 0; i < movements.size(); i++) {
+                        movements[i]->setVelocity(Vec2(batch.vx[i], batch.vy[i]));
+                    }
+                });
+    }
+
+    /**
+     * @return The given cell size of the spatial hash.
+     * @throw std::invalid_argument if the cell size is not positive and finite.
+     */
+    static float checkCellSize(float cellSize) {
+        if (!std::isfinite(cellSize) || cellSize <= 0.0f) {
+            throw std::invalid_argument("Cell size of the spatial hash must be positive and finite.");
         }
+        return cellSize;
     }
 
-    SCollisionDetection::SCollisionDetection(Scene& scene) noexcept : System(scene) {}
+    /// @return A new broadphase of the given type.
+    std::unique_ptr<Broadphase> createBroadphase(BroadphaseType type, float cellSize) {
+        switch (type) {
+            case BroadphaseType::SPATIAL_HASH:
+                checkCellSize(cellSize);
+                return std::make_unique<BroadphaseSpatialHash>(cellSize);
+            case BroadphaseType::AABB_TREE:
+                return std::make_unique<BroadphaseAABBTree>(SCollisionDetection::AABB_TREE_MARGIN);
+            case BroadphaseType::SWEEP_AND_PRUNE:
+            default:
+                return std::make_unique<BroadphaseSweepAndPrune>();
+        }
+    }
+
+    SCollisionDetection::SCollisionDetection(Scene& scene, BroadphaseType broadphase, float cellSize)
+            : System(scene), emitCollisionEvents(true), emitContactsEvent(true), broadphaseType_(broadphase),
+              cellSize_(checkCellSize(cellSize)), broadphase_(createBroadphase(broadphase, cellSize)), colliders_(), colliderIDs_(),
+              boxes_(), filters_(), pairs_(), contacts_(), nextContacts_() {}
+
+    SCollisionDetection::~SCollisionDetection() = default;
+
+    BroadphaseType SCollisionDetection::getBroadphase() const noexcept {
+        return this->broadphaseType_;
+    }
+
+    void SCollisionDetection::setBroadphase(BroadphaseType broadphase) {
+        if (broadphase == this->broadphaseType_) return;
+        this->broadphaseType_ = broadphase;
+        this->broadphase_ = createBroadphase(broadphase, this->cellSize_);
+    }
+
+    const std::vector<CollisionContact>& SCollisionDetection::getContacts() const noexcept {
+        return this->contacts_;
+    }
 
     void SCollisionDetection::update(float) {
-        std::vector<Entity*> entities = this->getScene().getEntityManager().getActiveEntitiesWith<CTransform2D, CBBox>();
-        for (size_t i = 0; i < entities.size(); i++) {
-            for (size_t j = i + 1; j < entities.size(); j++) {
-                auto* bBox1 = entities[i]->getComponent<CBBox>();
-                auto* bBox2 = entities[j]->getComponent<CBBox>();
-                if (!bBox1->active || !bBox2->active || !bBox1->overlapWith(*bBox2)) continue;
-                this->getScene().getEventManager().emit(EventArgsCollision(bBox1, bBox2));
+        EntityManager& entityManager = this->getScene().getEntityManager();
+
+        // Compute the world AABBs once
+        this->colliders_.clear();
+        this->colliderIDs_.clear();
+        this->boxes_.clear();
+        this->filters_.clear();
+        for (Entity* entity : entityManager.getQuery<With<CTransform2D, CBBox>>().getEntities()) {
+            auto* bBox = entity->getComponent<CBBox>();
+            // Colliders without any layer or mask never interact with others
+            if (!bBox->active || !bBox->layer || !bBox->mask) continue;
+            Vec2 worldLocation = entity->getComponent<CTransform2D>()->getWorldTransform().first;
+            AABB box(bBox->tl + worldLocation, bBox->br + worldLocation);
+            if (!box.valid()) continue;
+            this->colliders_.push_back(bBox);
+            this->colliderIDs_.push_back(entity->getID());
+            this->boxes_.push_back(box);
+            this->filters_.push_back({ bBox->layer, bBox->mask });
+        }
+
+        // Only candidate pairs go through the exact test
+        this->broadphase_->findPairs(this->boxes_, this->filters_, this->colliderIDs_, this->pairs_);
+        std::erase_if(this->pairs_, [this](const std::pair<size_t, size_t>& pair) {
+            return !this->boxes_[pair.first].overlapWith(this->boxes_[pair.second]);
+        });
+
+        // Current contacts, sorted by the IDs of their owners
+        this->nextContacts_.clear();
+        for (auto [i, j] : this->pairs_) {
+            if (this->colliderIDs_[i] > this->colliderIDs_[j]) std::swap(i, j);
+            this->nextContacts_.push_back({
+                    this->colliderIDs_[i], this->colliderIDs_[j], this->colliders_[i], this->colliders_[j],
+                    ContactPhase::BEGIN });
+        }
+        auto byIDs = [](const CollisionContact& lhs, const CollisionContact& rhs) {
+            return std::tie(lhs.entity1, lhs.entity2) < std::tie(rhs.entity1, rhs.entity2);
+        };
+        std::sort(this->nextContacts_.begin(), this->nextContacts_.end(), byIDs);
+
+        // Classify them by merging with the contacts of the previous frame
+        size_t currentCount = this->nextContacts_.size();
+        size_t current = 0;
+        for (const CollisionContact& previous : this->contacts_) {
+            if (previous.phase == ContactPhase::END) continue;
+            while (current < currentCount && byIDs(this->nextContacts_[current], previous)) current++;
+            if (current < currentCount && !byIDs(previous, this->nextContacts_[current])) {
+                this->nextContacts_[current++].phase = ContactPhase::PERSIST;
+                continue;
             }
+            Entity* entity1 = entityManager.getEntityByID(previous.entity1);
+            Entity* entity2 = entityManager.getEntityByID(previous.entity2);
+            this->nextContacts_.push_back({
+                    previous.entity1, previous.entity2,
+                    entity1 ? entity1->getComponent<CBBox>() : nullptr,
+                    entity2 ? entity2->getComponent<CBBox>() : nullptr,
+                    ContactPhase::END });
+        }
+        std::inplace_merge(
+                this->nextContacts_.begin(), this->nextContacts_.begin() + static_cast<std::ptrdiff_t>(currentCount),
+                this->nextContacts_.end(), byIDs);
+        std::swap(this->contacts_, this->nextContacts_);
+
+        if (this->emitContactsEvent && !this->contacts_.empty()) {
+            this->getScene().getEventManager().emit(EventArgsContacts(this->contacts_));
+        }
+        if (!this->emitCollisionEvents) return;
+        for (const CollisionContact& contact : this->contacts_) {
+            if (contact.phase == ContactPhase::END) continue;
+            // Collision listeners may destroy the entities or remove their colliders
+            Entity* entity1 = entityManager.getEntityByID(contact.entity1);
+            Entity* entity2 = entityManager.getEntityByID(contact.entity2);
+            if (!entity1 || !entity2) continue;
+            auto* bBox1 = entity1->getComponent<CBBox>();
+            auto* bBox2 = entity2->getComponent<CBBox>();
+            if (bBox1 != contact.collider1 || bBox2 != contact.collider2) continue;
+            if (!bBox1->active || !bBox2->active) continue;
+            this->getScene().getEventManager().emit(EventArgsCollision(bBox1, bBox2));
         }
     }
 }
@@ -32,16 +32,14 @@ namespace corn {
 
     EventArgsScene::EventArgsScene(SceneOperation op, Scene* scene) noexcept : op(op), scene(scene) {}
 
-    EventArgsEntityZOrderChange::EventArgsEntityZOrderChange(Entity* entity) noexcept : entity(entity) {}
-
     EventArgsWidgetZOrderChange::EventArgsWidgetZOrderChange(UIWidget* widget) noexcept : widget(widget) {}
 
-    EventArgsCamera::EventArgsCamera(CameraEventType eventType, const CCamera* camera) noexcept
-            : eventType(eventType), camera(camera) {}
-
     EventArgsCollision::EventArgsCollision(CBBox* collider1, CBBox* collider2) noexcept
             : collider1(collider1), collider2(collider2) {}
 
+    EventArgsContacts::EventArgsContacts(const std::vector<CollisionContact>& contacts) noexcept
+            : contacts(contacts) {}
+
     EventArgsUIKeyboard::EventArgsUIKeyboard(EventArgsKeyboard keyboardEvent) noexcept
             : keyboardEvent(std::move(keyboardEvent)) {}
 
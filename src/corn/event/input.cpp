@@ -0,0 +1,50 @@
+#include <corn/event/input.h>
+
+namespace corn {
+    InputEvent InputEvent::exit() noexcept {
+        return {};
+    }
+
+    InputEvent InputEvent::keyboard(
+            Key key, ButtonEvent status, unsigned char modifiers, const Vec2& mousePos) noexcept {
+
+        InputEvent input;
+        input.type = InputType::KEYBOARD;
+        input.key = key;
+        input.status = status;
+        input.modifiers = modifiers;
+        input.mousePos = mousePos;
+        return input;
+    }
+
+    InputEvent InputEvent::mouseButton(Mouse mouse, ButtonEvent status, const Vec2& mousePos) noexcept {
+        InputEvent input;
+        input.type = InputType::MOUSE_BUTTON;
+        input.mouse = mouse;
+        input.status = status;
+        input.mousePos = mousePos;
+        return input;
+    }
+
+    InputEvent InputEvent::mouseMove(const Vec2& mousePos) noexcept {
+        InputEvent input;
+        input.type = InputType::MOUSE_MOVE;
+        input.mousePos = mousePos;
+        return input;
+    }
+
+    InputEvent InputEvent::mouseScroll(float value, const Vec2& mousePos) noexcept {
+        InputEvent input;
+        input.type = InputType::MOUSE_SCROLL;
+        input.value = value;
+        input.mousePos = mousePos;
+        return input;
+    }
+
+    InputEvent InputEvent::text(unsigned int unicode) noexcept {
+        InputEvent input;
+        input.type = InputType::TEXT;
+        input.unicode = unicode;
+        return input;
+    }
+}
@@ -100,9 +100,11 @@ namespace corn {
     }
 
     Vec2 rotate(const Vec2& point, const Deg& deg) noexcept {
-        float cdeg = deg.cos();
-        float sdeg = deg.sin();
-        return { point.x * cdeg + point.y * sdeg, -point.x * sdeg + point.y * cdeg };
+        return rotate(point, deg.sin(), deg.cos());
+    }
+
+    Vec2 rotate(const Vec2& point, float sin, float cos) noexcept {
+        return { point.x * cos + point.y * sin, -point.x * sin + point.y * cos };
     }
 
     Vec3 rotate(const Vec3& point, const Quaternion& quaternion) noexcept {
@@ -1,5 +1,6 @@
 #include <array>
 #include <cmath>
+#include <ranges>
 #include <corn/core.h>
 #include <corn/ecs.h>
 #include <corn/event.h>
@@ -23,7 +24,8 @@ namespace corn {
     }
 
     Interface::Interface(const Game& game, std::unordered_map<Key, bool>& keyPressed)
-            : game_(game), keyPressed_(keyPressed), impl_(new Interface::InterfaceImpl()) {}
+            : game_(game), keyPressed_(keyPressed), simulatedInput_(), recorder_(nullptr),
+            impl_(new Interface::InterfaceImpl()) {}
 
     Interface::~Interface() {
         delete this->impl_;
@@ -34,6 +36,7 @@ namespace corn {
             this->impl_->window->close();
         }
         const Config& config = this->game_.getConfig();
+        if (config.headless) return;
         sf::ContextSettings contextSettings;
         contextSettings.antialiasingLevel = config.antialiasing;
 
@@ -48,143 +51,167 @@ namespace corn {
             this->impl_->window->setIcon(
                     (unsigned int)w, (unsigned int)h, config.icon->impl_->image.getPixelsPtr());
         }
+        this->impl_->window->setVerticalSyncEnabled(config.vsync);
     }
 
     Vec2 Interface::windowSize() const noexcept {
+        if (this->isHeadless()) {
+            const Config& config = this->game_.getConfig();
+            return {(float)config.width, (float)config.height};
+        }
         sf::Vector2u size = this->impl_->window->getSize();
         return {(float)size.x, (float)size.y};
     }
 
-    void Interface::handleUserInput() const {
-        sf::Event event{};
-        while (this->impl_->window->pollEvent(event)) {
-            switch (event.type) {
-                case (sf::Event::Closed): {
-                    EventArgsInputExit eventArgs;
-                    EventManager::instance().emit(eventArgs);
-                    this->game_.getTopScene()->getEventManager().emit(eventArgs);
-                    break;
-                }
-                case (sf::Event::MouseButtonPressed): {
-                    EventArgsMouseButton eventArgs(
-                            sfInput2CornInput(event.mouseButton.button), ButtonEvent::DOWN,
-                            Vec2((float)event.mouseButton.x, (float)event.mouseButton.y));
-                    EventManager::instance().emit(eventArgs);
-                    this->game_.getTopScene()->getEventManager().emit(eventArgs);
-                    // Only emit the event to the top scene if not caught by UI
-                    if (!this->game_.getTopScene()->getUIManager().onClick(eventArgs)) {
-                        EventArgsWorldMouseButton worldEventArgs(
-                                sfInput2CornInput(event.mouseButton.button), ButtonEvent::DOWN,
-                                Vec2((float)event.mouseButton.x, (float)event.mouseButton.y));
-                        this->game_.getTopScene()->getEventManager().emit(worldEventArgs);
-                    }
-                    break;
-                }
-                case (sf::Event::MouseButtonReleased): {
-                    EventArgsMouseButton eventArgs(
-                            sfInput2CornInput(event.mouseButton.button), ButtonEvent::UP,
-                            Vec2((float)event.mouseButton.x, (float)event.mouseButton.y));
-                    EventManager::instance().emit(eventArgs);
-                    this->game_.getTopScene()->getEventManager().emit(eventArgs);
-                    // Only emit the world event if not caught by UI
-                    if (!this->game_.getTopScene()->getUIManager().onClick(eventArgs)) {
-                        EventArgsWorldMouseButton worldEventArgs(
-                                sfInput2CornInput(event.mouseButton.button), ButtonEvent::UP,
-                                Vec2((float)event.mouseButton.x, (float)event.mouseButton.y));
-                        this->game_.getTopScene()->getEventManager().emit(worldEventArgs);
-                    }
-                    break;
-                }
-                case sf::Event::MouseMoved: {
-                    EventArgsMouseMove eventArgs(
-                            Vec2((float)event.mouseMove.x, (float)event.mouseMove.y));
-                    EventManager::instance().emit(eventArgs);
-                    this->game_.getTopScene()->getEventManager().emit(eventArgs);
-                    // Only emit the world event if not caught by UI
-                    if (!this->game_.getTopScene()->getUIManager().onHover(eventArgs)) {
-                        EventArgsWorldMouseMove worldEventArgs(
-                                Vec2((float)event.mouseMove.x, (float)event.mouseMove.y));
-                        this->game_.getTopScene()->getEventManager().emit(worldEventArgs);
-                    }
-                    break;
-                }
-                case (sf::Event::MouseWheelScrolled): {
-                    EventArgsMouseScroll eventArgs(
-                            event.mouseWheelScroll.delta,
-                            Vec2((float)event.mouseWheelScroll.x, (float)event.mouseWheelScroll.y));
-                    EventManager::instance().emit(eventArgs);
-                    this->game_.getTopScene()->getEventManager().emit(eventArgs);
-                    // Only emit the world event if not caught by UI
-                    if (!this->game_.getTopScene()->getUIManager().onScroll(eventArgs)) {
-                        EventArgsWorldMouseScroll worldEventArgs(
+    bool Interface::handleUserInput() {
+        bool received = false;
+        if (!this->isHeadless()) {
+            bool replaying = !this->game_.getConfig().replayInput.empty();
+            sf::Event event{};
+            while (this->impl_->window->pollEvent(event)) {
+                // The replay stands in for the user, except that the window can still be closed
+                if (replaying && event.type != sf::Event::Closed) continue;
+                received = true;
+                switch (event.type) {
+                    case (sf::Event::Closed):
+                        this->dispatchInput(InputEvent::exit());
+                        break;
+                    case (sf::Event::MouseButtonPressed):
+                    case (sf::Event::MouseButtonReleased):
+                        this->dispatchInput(InputEvent::mouseButton(
+                                sfInput2CornInput(event.mouseButton.button),
+                                event.type == sf::Event::MouseButtonPressed ? ButtonEvent::DOWN : ButtonEvent::UP,
+                                Vec2((float)event.mouseButton.x, (float)event.mouseButton.y)));
+                        break;
+                    case (sf::Event::MouseMoved):
+                        this->dispatchInput(InputEvent::mouseMove(
+                                Vec2((float)event.mouseMove.x, (float)event.mouseMove.y)));
+                        break;
+                    case (sf::Event::MouseWheelScrolled):
+                        this->dispatchInput(InputEvent::mouseScroll(
                                 event.mouseWheelScroll.delta,
-                                Vec2((float)event.mouseWheelScroll.x, (float)event.mouseWheelScroll.y));
-                        this->game_.getTopScene()->getEventManager().emit(worldEventArgs);
-                    }
-                    break;
-                }
-                case (sf::Event::KeyPressed): {
-                    sf::Event::KeyEvent keyEvent = event.key;
-                    Key key = sfInput2CornInput(keyEvent.code, keyEvent.scancode);
-                    if (this->keyPressed_[key]) break;
-                    this->keyPressed_[key] = true;
-                    EventArgsKeyboard eventArgs(
-                            key, ButtonEvent::DOWN,
-                            (keyEvent.system << 3) + (keyEvent.control << 2) + (keyEvent.alt << 1) + keyEvent.shift,
-                            Vec2((float)event.mouseButton.x, (float)event.mouseButton.y));
-                    EventManager::instance().emit(eventArgs);
-                    this->game_.getTopScene()->getEventManager().emit(eventArgs);
-                    // Only emit the world event if not caught by UI
-                    if (!this->game_.getTopScene()->getUIManager().onKeyboard(eventArgs)) {
-                        EventArgsWorldKeyboard worldEventArgs(
-                                key, ButtonEvent::DOWN,
+                                Vec2((float)event.mouseWheelScroll.x, (float)event.mouseWheelScroll.y)));
+                        break;
+                    case (sf::Event::KeyPressed):
+                    case (sf::Event::KeyReleased): {
+                        sf::Event::KeyEvent keyEvent = event.key;
+                        this->dispatchInput(InputEvent::keyboard(
+                                sfInput2CornInput(keyEvent.code, keyEvent.scancode),
+                                event.type == sf::Event::KeyPressed ? ButtonEvent::DOWN : ButtonEvent::UP,
                                 (keyEvent.system << 3) + (keyEvent.control << 2) + (keyEvent.alt << 1) + keyEvent.shift,
-                                Vec2((float)event.mouseButton.x, (float)event.mouseButton.y));
-                        this->game_.getTopScene()->getEventManager().emit(worldEventArgs);
+                                Vec2((float)event.mouseButton.x, (float)event.mouseButton.y)));
+                        break;
                     }
-                    break;
+                    case (sf::Event::TextEntered):
+                        this->dispatchInput(InputEvent::text(event.text.unicode));
+                        break;
+                    default:
+                        break;
                 }
-                case (sf::Event::KeyReleased): {
-                    sf::Event::KeyEvent keyEvent = event.key;
-                    Key key = sfInput2CornInput(keyEvent.code, keyEvent.scancode);
-                    if (!this->keyPressed_[key]) break;
-                    this->keyPressed_[key] = false;
-                    EventArgsKeyboard eventArgs(
-                            key, ButtonEvent::UP,
-                            (keyEvent.system << 3) + (keyEvent.control << 2) + (keyEvent.alt << 1) + keyEvent.shift,
-                            Vec2((float)event.mouseButton.x, (float)event.mouseButton.y));
-                    EventManager::instance().emit(eventArgs);
-                    this->game_.getTopScene()->getEventManager().emit(eventArgs);
-                    // Only emit the world event if not caught by UI
-                    if (!this->game_.getTopScene()->getUIManager().onKeyboard(eventArgs)) {
-                        EventArgsWorldKeyboard worldEventArgs(
-                                key, ButtonEvent::UP,
-                                (keyEvent.system << 3) + (keyEvent.control << 2) + (keyEvent.alt << 1) + keyEvent.shift,
-                                Vec2((float)event.mouseButton.x, (float)event.mouseButton.y));
-                        this->game_.getTopScene()->getEventManager().emit(worldEventArgs);
-                    }
-                    break;
+            }
+        }
+
+        // Simulated input, after the input from the window
+        while (!this->simulatedInput_.empty()) {
+            received = true;
+            InputEvent input = this->simulatedInput_.front();
+            this->simulatedInput_.pop();
+            this->dispatchInput(input);
+        }
+        return received;
+    }
+
+    void Interface::simulateInput(const InputEvent& input) {
+        this->simulatedInput_.push(input);
+    }
+
+    void Interface::setRecorder(InputRecorder* recorder) noexcept {
+        this->recorder_ = recorder;
+    }
+
+    void Interface::dispatchInput(const InputEvent& input) const {
+        Scene* scene = this->game_.getTopScene();
+        if (!scene) return;
+        if (this->recorder_) {
+            this->recorder_->record(input);
+        }
+        switch (input.type) {
+            case InputType::EXIT: {
+                EventArgsInputExit eventArgs;
+                EventManager::instance().emit(eventArgs);
+                scene->getEventManager().emit(eventArgs);
+                break;
+            }
+            case InputType::MOUSE_BUTTON: {
+                EventArgsMouseButton eventArgs(input.mouse, input.status, input.mousePos);
+                EventManager::instance().emit(eventArgs);
+                scene->getEventManager().emit(eventArgs);
+                // Only emit the world event if not caught by UI
+                if (!scene->getUIManager().onClick(eventArgs)) {
+                    EventArgsWorldMouseButton worldEventArgs(input.mouse, input.status, input.mousePos);
+                    scene->getEventManager().emit(worldEventArgs);
                 }
-                case (sf::Event::TextEntered): {
-                    EventArgsTextEntered eventArgs(
-                            event.text.unicode, unicodeToUTF8(event.text.unicode));
-                    EventManager::instance().emit(eventArgs);
-                    this->game_.getTopScene()->getEventManager().emit(eventArgs);
-                    this->game_.getTopScene()->getUIManager().onTextEntered(eventArgs);
-                    break;
+                break;
+            }
+            case InputType::MOUSE_MOVE: {
+                EventArgsMouseMove eventArgs(input.mousePos);
+                EventManager::instance().emit(eventArgs);
+                scene->getEventManager().emit(eventArgs);
+                // Only emit the world event if not caught by UI
+                if (!scene->getUIManager().onHover(eventArgs)) {
+                    EventArgsWorldMouseMove worldEventArgs(input.mousePos);
+                    scene->getEventManager().emit(worldEventArgs);
                 }
-                default:
-                    break;
+                break;
+            }
+            case InputType::MOUSE_SCROLL: {
+                EventArgsMouseScroll eventArgs(input.value, input.mousePos);
+                EventManager::instance().emit(eventArgs);
+                scene->getEventManager().emit(eventArgs);
+                // Only emit the world event if not caught by UI
+                if (!scene->getUIManager().onScroll(eventArgs)) {
+                    EventArgsWorldMouseScroll worldEventArgs(input.value, input.mousePos);
+                    scene->getEventManager().emit(worldEventArgs);
+                }
+                break;
+            }
+            case InputType::KEYBOARD: {
+                // Ignore repeated presses and releases of keys already in that state
+                bool pressed = input.status == ButtonEvent::DOWN;
+                if (this->keyPressed_[input.key] == pressed) break;
+                this->keyPressed_[input.key] = pressed;
+                EventArgsKeyboard eventArgs(input.key, input.status, input.modifiers, input.mousePos);
+                EventManager::instance().emit(eventArgs);
+                scene->getEventManager().emit(eventArgs);
+                // Only emit the world event if not caught by UI
+                if (!scene->getUIManager().onKeyboard(eventArgs)) {
+                    EventArgsWorldKeyboard worldEventArgs(input.key, input.status, input.modifiers, input.mousePos);
+                    scene->getEventManager().emit(worldEventArgs);
+                }
+                break;
+            }
+            case InputType::TEXT: {
+                EventArgsTextEntered eventArgs(input.unicode, unicodeToUTF8(input.unicode));
+                EventManager::instance().emit(eventArgs);
+                scene->getEventManager().emit(eventArgs);
+                scene->getUIManager().onTextEntered(eventArgs);
+                break;
             }
         }
     }
 
+    bool Interface::isHeadless() const noexcept {
+        return this->game_.getConfig().headless;
+    }
+
     void Interface::clear() {
+        if (this->isHeadless()) return;
         auto [r, g, b] = this->game_.getConfig().background.getRGB();
         this->impl_->window->clear(sf::Color(r, g, b));
     }
 
     void Interface::render(Scene* scene) {
+        if (this->isHeadless()) return;
         // Clear the screen
         this->clear();
 
@@ -201,6 +228,7 @@ namespace corn {
     }
 
     void Interface::renderDebugOverlay(size_t fps) {
+        if (this->isHeadless()) return;
         // Render dark background in the top left corner
         sf::RectangleShape overlay(sf::Vector2f(100, 30));
         overlay.setFillColor(sf::Color(0, 0, 0, 200));
@@ -217,6 +245,7 @@ namespace corn {
     }
 
     void Interface::update() {
+        if (this->isHeadless()) return;
         this->impl_->window->display();
     }
 
@@ -237,7 +266,7 @@ namespace corn {
         camera->viewport.impl_->texture.clear(sf::Color(r, g, b, a));
 
         // Calculate location of camera
-        Vec2 cameraCenter = camera->getEntity().getComponent<CTransform2D>()->getWorldTransform().first + camera->anchor.vec2();
+        Vec2 cameraCenter = camera->getEntity().getComponent<CTransform2D>()->getRenderTransform().first + camera->anchor.vec2();
 
         // Return the location and scale
         return { cameraCenter - fovSize * 0.5, { viewportSize.x / fovSize.x, viewportSize.y / fovSize.y } };
@@ -261,7 +290,10 @@ namespace corn {
         scaleTransform.scale(cameraScale.x, cameraScale.y);
 
         // Render entities
-        for (Entity* entity: scene->getEntityManager().getActiveEntitiesWith<CTransform2D>()) {
+        auto entities = scene->getEntityManager().activeView() | std::views::filter([](const Entity* entity) {
+            return entity->hasComponents<CTransform2D>();
+        });
+        for (Entity* entity: entities) {
             auto transform = entity->getComponent<CTransform2D>();
 
             // Sprite
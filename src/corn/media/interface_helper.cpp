@@ -12,7 +12,7 @@ namespace corn {
             const CTransform2D& cTransform, const CSprite& cSprite,
             const Vec2& cameraOffset, const Vec2&, const sf::Transform& scaleTransform) {
 
-        auto [worldLocation, worldRotation] = cTransform.getWorldTransform();
+        auto [worldLocation, worldRotation] = cTransform.getRenderTransform();
         auto [ancX, ancY] = worldLocation - cameraOffset;
         auto [locX, locY] = cSprite.location;
         auto [scaleX, scaleY] = cSprite.image->impl_->scale;
@@ -40,7 +40,7 @@ namespace corn {
             const CTransform2D& cTransform, const std::vector<Vec2>& vertices, float thickness, const Color& color, bool closed,
             const Vec2& cameraOffset, const Vec2& cameraScale, const sf::Transform& scaleTransform) {
 
-        auto [worldLocation, worldRotation] = cTransform.getWorldTransform();
+        auto [worldLocation, worldRotation] = cTransform.getRenderTransform();
         auto [ancX, ancY] = worldLocation - cameraOffset;
         auto [r, g, b, a] = color.getRGBA();
 
@@ -92,7 +92,7 @@ namespace corn {
             }
         } else {
             // Draw polygon and fill inside
-            auto [worldLocation, worldRotation] = cTransform.getWorldTransform();
+            auto [worldLocation, worldRotation] = cTransform.getRenderTransform();
             auto [ancX, ancY] = worldLocation - cameraOffset;
             auto [r, g, b, a] = cPolygon.color.getRGBA();
 
@@ -119,7 +119,7 @@ namespace corn {
             const CTransform2D& cTransform, const CText& cText,
             const Vec2& cameraOffset, const Vec2&, const sf::Transform& scaleTransform) {
 
-        auto [worldLocation, worldRotation] = cTransform.getWorldTransform();
+        auto [worldLocation, worldRotation] = cTransform.getRenderTransform();
         auto [ancX, ancY] = worldLocation - cameraOffset;
         Vec2 location(cText.getX(), cText.getY());
         auto [w, h] = cText.textRender.getSize();
@@ -1,3 +1,4 @@
+#include <corn/core/scene.h>
 #include <corn/media/image.h>
 #include <corn/ui/ui_image.h>
 
@@ -20,5 +21,6 @@ namespace corn {
     void UIImage::setImage(Image* image) noexcept {
         delete this->image_;
         this->image_ = image;
+        this->getScene().requestFrame();
     }
 }
@@ -1,3 +1,4 @@
+#include <corn/core/scene.h>
 #include <corn/ui/ui_label.h>
 #include "../media/text_render_impl.h"
 
@@ -15,6 +16,7 @@ namespace corn {
 
     void UILabel::setText(const RichText& richText) {
         this->textRender_.setText(richText);
+        this->getScene().requestFrame();
     }
 
     TextRender& UILabel::getTextRender() noexcept {
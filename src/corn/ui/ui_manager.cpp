@@ -84,6 +84,7 @@ namespace corn {
         // Reset root node
         this->root_.children.clear();
         this->root_.dirty = false;
+        this->scene_.requestFrame();
     }
 
     void UIManager::tidy() noexcept {
@@ -348,6 +349,7 @@ namespace corn {
         std::erase(parent->children, node);
         // Destroy node itself
         this->destroyNode(node);
+        this->scene_.requestFrame();
     }
 
     const UIManager::Node* UIManager::getNodeFromWidget(const UIWidget* widget) const {
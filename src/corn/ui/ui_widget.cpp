@@ -46,6 +46,7 @@ namespace corn {
 
     void UIWidget::setActive(bool active) noexcept {
         this->active_ = active;
+        this->getScene().requestFrame();
     }
 
     bool UIWidget::isActiveInWorld() const noexcept {
@@ -99,6 +100,7 @@ namespace corn {
     void UIWidget::setZOrder(int zOrder) noexcept {
         this->zOrder_ = zOrder;
         this->getScene().getEventManager().emit(EventArgsWidgetZOrderChange(this));
+        this->getScene().requestFrame();
     }
 
     const Expression<5>& UIWidget::getX() const noexcept {
@@ -109,6 +111,7 @@ namespace corn {
         static const std::array<std::string, 5> units = { "px", "%pw", "%ph", "%nw", "%nh" };
         this->x_ = Expression(expression, units);
         this->independent_[0] = expression.find("%p") == std::string::npos;
+        this->getScene().requestFrame();
     }
 
     const Expression<5>& UIWidget::getY() const noexcept {
@@ -119,6 +122,7 @@ namespace corn {
         static const std::array<std::string, 5> units = { "px", "%pw", "%ph", "%nw", "%nh" };
         this->y_ = Expression(expression, units);
         this->independent_[1] = expression.find("%p") == std::string::npos;
+        this->getScene().requestFrame();
     }
 
     const Expression<5>& UIWidget::getW() const noexcept {
@@ -129,6 +133,7 @@ namespace corn {
         static const std::array<std::string, 5> units = { "px", "%pw", "%ph", "%nw", "%nh" };
         this->w_ = Expression(expression, units);
         this->independent_[2] = expression.find("%p") == std::string::npos;
+        this->getScene().requestFrame();
     }
 
     const Expression<5>& UIWidget::getH() const noexcept {
@@ -139,6 +144,7 @@ namespace corn {
         static const std::array<std::string, 5> units = { "px", "%pw", "%ph", "%nw", "%nh" };
         this->h_ = Expression(expression, units);
         this->independent_[3] = expression.find("%p") == std::string::npos;
+        this->getScene().requestFrame();
     }
 
     Vec2 UIWidget::getNaturalSize() const noexcept {
@@ -168,6 +174,7 @@ namespace corn {
 
     void UIWidget::setOverflow(UIOverflow overflow) noexcept {
         this->overflow_ = overflow;
+        this->getScene().requestFrame();
     }
 
     const Color& UIWidget::getBackground() const noexcept {
@@ -180,10 +187,12 @@ namespace corn {
 
     void UIWidget::setBackground(Color background) noexcept {
         this->background_ = background;
+        this->getScene().requestFrame();
     }
 
     void UIWidget::setOpacity(unsigned char opacity) noexcept {
         this->opacity_ = opacity;
+        this->getScene().requestFrame();
     }
 
     bool UIWidget::isKeyboardInteractable() const noexcept {
@@ -0,0 +1,51 @@
+#include <algorithm>
+#include <thread>
+#include <corn/util/frame_limiter.h>
+
+namespace corn {
+    /// @return The duration of the given milliseconds in the clock's unit.
+    template <typename Duration>
+    static Duration toDuration(float millis) noexcept {
+        return std::chrono::duration_cast<Duration>(std::chrono::duration<float, std::milli>(millis));
+    }
+
+    FrameLimiter::FrameLimiter(float spinThreshold) noexcept
+            : spinThreshold_(toDuration<Clock::duration>(std::max(spinThreshold, 0.0f))), frameStart_(Clock::now()) {}
+
+    void FrameLimiter::wait(float frameMillis) {
+        if (frameMillis <= 0.0f) {
+            this->reset();
+            return;
+        }
+        auto frameLength = toDuration<Clock::duration>(frameMillis);
+        Clock::time_point deadline = this->frameStart_ + frameLength;
+        Clock::time_point now = Clock::now();
+
+        // Fell behind by more than a frame, so start over instead of catching up
+        if (now >= deadline + frameLength) {
+            this->frameStart_ = now;
+            return;
+        }
+
+        // Sleep for the coarse part of the wait, then spin for the rest
+        if (deadline - now > this->spinThreshold_) {
+            std::this_thread::sleep_until(deadline - this->spinThreshold_);
+        }
+        while (Clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        this->frameStart_ = deadline;
+    }
+
+    void FrameLimiter::reset() noexcept {
+        this->frameStart_ = Clock::now();
+    }
+
+    float FrameLimiter::getSpinThreshold() const noexcept {
+        return std::chrono::duration<float, std::milli>(this->spinThreshold_).count();
+    }
+
+    void FrameLimiter::setSpinThreshold(float spinThreshold) noexcept {
+        this->spinThreshold_ = toDuration<Clock::duration>(std::max(spinThreshold, 0.0f));
+    }
+}
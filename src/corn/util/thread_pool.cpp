@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <corn/util/thread_pool.h>
+
+namespace corn {
+    /// @brief The pool that owns the current thread, if the current thread is a worker thread.
+    static thread_local const ThreadPool* currentPool = nullptr;
+
+    /// @brief Index of the current worker thread in its pool.
+    static thread_local size_t currentIndex = 0;
+
+    ThreadPool::ThreadPool(size_t threadCount) : queues_(), threads_(), queued_(0), stop_(false) {
+        for (size_t i = 0; i <= threadCount; i++) {
+            this->queues_.push_back(std::make_unique<Queue>());
+        }
+        for (size_t i = 0; i < threadCount; i++) {
+            this->threads_.emplace_back(&ThreadPool::work, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+            this->stop_ = true;
+        }
+        this->jobAvailable_.notify_all();
+        for (std::thread& thread : this->threads_) {
+            thread.join();
+        }
+    }
+
+    ThreadPool& ThreadPool::instance() {
+        static ThreadPool instance(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+        return instance;
+    }
+
+    size_t ThreadPool::getThreadCount() const noexcept {
+        return this->threads_.size();
+    }
+
+    void ThreadPool::run(const std::vector<Task>& tasks) {
+        if (tasks.empty()) return;
+
+        // Run on the calling thread if parallelism is not possible
+        if (this->threads_.empty() || tasks.size() == 1) {
+            for (const Task& task : tasks) {
+                task();
+            }
+            return;
+        }
+
+        // Count the jobs before publishing them, so that workers never take a job that is not counted yet
+        {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+            this->queued_ += tasks.size();
+        }
+
+        // Distribute the jobs evenly, starting from the calling thread's own queue
+        Batch batch;
+        batch.remaining = tasks.size();
+        size_t self = this->getQueueIndex();
+        size_t queueCount = this->queues_.size();
+        for (size_t i = 0; i < queueCount; i++) {
+            Queue& queue = *this->queues_[(self + i) % queueCount];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            for (size_t j = i; j < tasks.size(); j += queueCount) {
+                queue.jobs.push_back({ &tasks[j], &batch });
+            }
+        }
+        this->jobAvailable_.notify_all();
+
+        // Help executing jobs until the batch is finished
+        while (batch.remaining > 0) {
+            if (this->runOne(self)) continue;
+            std::unique_lock<std::mutex> lock(this->mutex_);
+            this->batchFinished_.wait(lock, [&batch]() { return batch.remaining == 0; });
+        }
+
+        if (batch.error) {
+            std::rethrow_exception(batch.error);
+        }
+    }
+
+    void ThreadPool::parallelFor(
+            size_t count, size_t chunkSize, const std::function<void(size_t begin, size_t end)>& func) {
+
+        chunkSize = std::max<size_t>(chunkSize, 1);
+        std::vector<Task> tasks;
+        tasks.reserve((count + chunkSize - 1) / chunkSize);
+        for (size_t begin = 0; begin < count; begin += chunkSize) {
+            size_t end = std::min(begin + chunkSize, count);
+            tasks.emplace_back([&func, begin, end]() { func(begin, end); });
+        }
+        this->run(tasks);
+    }
+
+    void ThreadPool::work(size_t index) {
+        currentPool = this;
+        currentIndex = index;
+        while (true) {
+            if (this->runOne(index)) continue;
+            std::unique_lock<std::mutex> lock(this->mutex_);
+            this->jobAvailable_.wait(lock, [this]() { return this->stop_ || this->queued_ > 0; });
+            if (this->stop_ && this->queued_ == 0) return;
+        }
+    }
+
+    bool ThreadPool::runOne(size_t index) {
+        Job job{};
+        bool found = false;
+
+        // Take the newest job from the own queue
+        {
+            Queue& queue = *this->queues_[index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty()) {
+                job = queue.jobs.back();
+                queue.jobs.pop_back();
+                found = true;
+            }
+        }
+
+        // Steal the oldest job from other queues
+        for (size_t i = 1; !found && i < this->queues_.size(); i++) {
+            Queue& queue = *this->queues_[(index + i) % this->queues_.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty()) {
+                job = queue.jobs.front();
+                queue.jobs.pop_front();
+                found = true;
+            }
+        }
+
+        if (!found) return false;
+        --this->queued_;
+        this->execute(job);
+        return true;
+    }
+
+    void ThreadPool::execute(const Job& job) noexcept {
+        try {
+            (*job.task)();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(job.batch->errorMutex);
+            if (!job.batch->error) {
+                job.batch->error = std::current_exception();
+            }
+        }
+        // The batch may be destroyed as soon as the counter reaches 0
+        if (--job.batch->remaining == 0) {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+            this->batchFinished_.notify_all();
+        }
+    }
+
+    size_t ThreadPool::getQueueIndex() const noexcept {
+        return currentPool == this ? currentIndex : this->queues_.size() - 1;
+    }
+}
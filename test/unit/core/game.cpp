@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+#include <functional>
+#include <vector>
+#include <corn/core/game.h>
+#include <corn/core/scene.h>
+#include <corn/ecs/component.h>
+#include <corn/ecs/entity_manager.h>
+#include <corn/ecs/system.h>
+#include <corn/event/event_args.h>
+#include <corn/event/event_manager.h>
+#include <corn/event/input.h>
+#include <corn/util/config.h>
+#include <corn/util/exceptions.h>
+#include <corn/util/stopwatch.h>
+#include "dummy_scene.h"
+
+namespace corn::test::game {
+    /// @brief Records the elapsed time of every update, and emits an event after a number of updates.
+    class SCount : public System {
+    public:
+        SCount(Scene& scene, std::vector<float>& millis, size_t frames, std::function<void()> onDone)
+                : System(scene), millis_(millis), frames_(frames), onDone_(std::move(onDone)) {}
+
+        void update(float millis) override {
+            this->millis_.push_back(millis);
+            if (this->millis_.size() == this->frames_) {
+                this->onDone_();
+            }
+        }
+
+    private:
+        std::vector<float>& millis_;
+        size_t frames_;
+        std::function<void()> onDone_;
+    };
+
+    /// @brief Calls a function on every update, and exits after a number of updates.
+    class SEach : public System {
+    public:
+        SEach(Scene& scene, size_t frames, std::function<void(Scene&)> func)
+                : System(scene), frames_(frames), func_(std::move(func)) {}
+
+        void update(float) override {
+            this->func_(this->getScene());
+            if (--this->frames_ == 0) {
+                EventManager::instance().emit(EventArgsExit());
+            }
+        }
+
+    private:
+        size_t frames_;
+        std::function<void(Scene&)> func_;
+    };
+
+    Config headlessConfig() {
+        Config config;
+        config.headless = true;
+        config.virtualFrameTime = 16.0f;
+        return config;
+    }
+
+    TEST(Game, headless_virtual_clock) {
+        std::vector<float> millis;
+        auto* scene = new DummyScene();
+        scene->addSystem<SCount>(millis, 100, []() {
+            EventManager::instance().emit(EventArgsExit());
+        });
+        Game game(scene, headlessConfig());
+        EXPECT_FLOAT_EQ(game.windowSize().x, 1280.0f);
+        EXPECT_FLOAT_EQ(game.windowSize().y, 720.0f);
+        game.run();
+        EXPECT_EQ(millis, std::vector<float>(100, 16.0f));
+    }
+
+    TEST(Game, headless_scene_transition) {
+        std::vector<float> millis1, millis2;
+        auto* scene2 = new DummyScene();
+        scene2->addSystem<SCount>(millis2, 3, []() {
+            EventManager::instance().emit(EventArgsExit());
+        });
+        auto* scene1 = new DummyScene();
+        scene1->addSystem<SCount>(millis1, 2, [scene2]() {
+            EventManager::instance().emit(EventArgsScene(SceneOperation::REPLACE, scene2));
+        });
+        Game game(scene1, headlessConfig());
+        game.run();
+        EXPECT_EQ(millis1.size(), 2);
+        EXPECT_EQ(millis2.size(), 3);
+        EXPECT_EQ(game.getTopScene(), scene2);
+    }
+
+    TEST(Game, headless_simulated_input) {
+        std::vector<float> millis;
+        auto* scene = new DummyScene();
+        scene->addSystem<SCount>(millis, 2, []() {
+            EventManager::instance().emit(EventArgsExit());
+        });
+        std::vector<ButtonEvent> keys;
+        scene->getEventManager().addListener("corn::input::keyboard", [&keys](const EventArgs& args) {
+            keys.push_back(dynamic_cast<const EventArgsKeyboard&>(args).status);
+        });
+        size_t worldMoves = 0;
+        scene->getEventManager().addListener("corn::world::mousemv", [&worldMoves](const EventArgs&) {
+            worldMoves++;
+        });
+
+        Game game(scene, headlessConfig());
+        game.simulateInput(InputEvent::keyboard(Key::A, ButtonEvent::DOWN));
+        game.simulateInput(InputEvent::keyboard(Key::A, ButtonEvent::DOWN));  // Already pressed, so ignored
+        game.simulateInput(InputEvent::mouseMove(Vec2(10.0f, 20.0f)));
+        game.run();
+        EXPECT_EQ(keys, std::vector<ButtonEvent>{ ButtonEvent::DOWN });
+        EXPECT_EQ(worldMoves, 1);
+        EXPECT_TRUE(game.isPressed(Key::A));
+    }
+
+    /// @return Milliseconds taken by 10 frames of a headless game that idles at 20 fps, calling the function every frame.
+    float runIdle(const std::function<void(Scene&)>& func) {
+        auto* scene = new DummyScene();
+        scene->getEntityManager().createEntity("camera").addComponent<CCamera>(Vec2::ZERO());
+        scene->addSystem<SEach>(10, func);
+        Config config = headlessConfig();
+        config.idleFps = 20;
+        config.idleDelay = 0.0f;
+        Game game(scene, config);
+        Stopwatch stopwatch;
+        stopwatch.play();
+        game.run();
+        return stopwatch.millis();
+    }
+
+    TEST(Game, idle_without_changes) {
+        // Unchanged scenes go idle right after the first frame, which creates the camera
+        EXPECT_GE(runIdle([](Scene&) {}), 300.0f);
+
+        // Changes that do not touch the transforms, and explicit requests, keep the game awake
+        EXPECT_LT(runIdle([](Scene& scene) {
+            scene.getEntityManager().getEntityByName("camera")->getComponent<CCamera>()->setFov("50%vw", "50%vh");
+        }), 150.0f);
+        EXPECT_LT(runIdle([](Scene& scene) {
+            scene.requestFrame();
+        }), 150.0f);
+    }
+
+    /// @brief Runs a headless game that records the keyboard events, and returns them with the elapsed times.
+    std::pair<std::vector<std::string>, std::vector<float>> runRecorded(const Config& config, bool simulate) {
+        std::vector<float> millis;
+        auto* scene = new DummyScene();
+        scene->addSystem<SCount>(millis, 4, []() {
+            EventManager::instance().emit(EventArgsExit());
+        });
+        std::vector<std::string> log;
+        scene->getEventManager().addListener("corn::input::keyboard", [&log, &millis](const EventArgs& args) {
+            const auto& keyboardArgs = dynamic_cast<const EventArgsKeyboard&>(args);
+            log.push_back(std::to_string(millis.size()) + (keyboardArgs.status == ButtonEvent::DOWN ? " down" : " up"));
+        });
+
+        Game game(scene, config);
+        if (simulate) {
+            game.simulateInput(InputEvent::keyboard(Key::A, ButtonEvent::DOWN));
+            game.simulateInput(InputEvent::keyboard(Key::A, ButtonEvent::UP));
+        }
+        game.run();
+        return { log, millis };
+    }
+
+    TEST(Game, record_and_replay) {
+        std::filesystem::path path = std::filesystem::temp_directory_path() / "corn_test_record_and_replay.log";
+        Config config = headlessConfig();
+        config.recordInput = path.string();
+        auto [recordedLog, recordedMillis] = runRecorded(config, true);
+        EXPECT_EQ(recordedLog, (std::vector<std::string>{ "1 down", "1 up" }));
+
+        // The replay uses the recorded times instead of the virtual clock, and stands in for the simulated input
+        config = headlessConfig();
+        config.virtualFrameTime = 5.0f;
+        config.replayInput = path.string();
+        config.replayRealTime = false;
+        auto [replayedLog, replayedMillis] = runRecorded(config, false);
+        EXPECT_EQ(replayedLog, recordedLog);
+        EXPECT_EQ(replayedMillis, recordedMillis);
+        std::filesystem::remove(path);
+    }
+
+    TEST(Game, invalid_replay) {
+        std::filesystem::path path = std::filesystem::temp_directory_path() / "corn_test_invalid_replay.log";
+        std::filesystem::remove(path);
+        Config config = headlessConfig();
+        config.recordInput = path.string();
+        config.replayInput = (std::filesystem::temp_directory_path() / "corn_test_missing_replay.log").string();
+
+        // Nothing is recorded, and the game can still be destroyed
+        Game game(new DummyScene(), config);
+        EXPECT_THROW(game.run(), ResourceLoadFailed);
+        EXPECT_FALSE(std::filesystem::exists(path));
+    }
+}
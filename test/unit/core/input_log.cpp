@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <corn/core/input_log.h>
+#include <corn/util/exceptions.h>
+
+namespace corn::test::input_log {
+    std::filesystem::path tempLog(const std::string& name) {
+        return std::filesystem::temp_directory_path() / ("corn_test_" + name + ".log");
+    }
+
+    TEST(InputLog, round_trip) {
+        std::filesystem::path path = tempLog("round_trip");
+        std::vector<InputEvent> inputs = {
+                InputEvent::exit(),
+                InputEvent::keyboard(Key::SPACE, ButtonEvent::UP, 0b0101, Vec2(1.5f, -2.0f)),
+                InputEvent::mouseButton(Mouse::RIGHT, ButtonEvent::DOWN, Vec2(3.0f, 4.0f)),
+                InputEvent::mouseMove(Vec2(-5.0f, 6.25f)),
+                InputEvent::mouseScroll(-1.0f, Vec2(7.0f, 8.0f)),
+                InputEvent::text(0x1F33D),
+        };
+        {
+            InputRecorder recorder(path);
+            recorder.endFrame(16.5f);
+            for (const InputEvent& input : inputs) {
+                recorder.record(input);
+            }
+            recorder.endFrame(17.25f, 34.5f);
+            EXPECT_EQ(recorder.getFrameCount(), 2);
+        }
+
+        InputReplayer replayer(path);
+        EXPECT_EQ(replayer.getFrameCount(), 2);
+        const InputFrame* frame = replayer.next();
+        ASSERT_NE(frame, nullptr);
+        EXPECT_FLOAT_EQ(frame->millis, 16.5f);
+        EXPECT_FLOAT_EQ(frame->realMillis, 16.5f);
+        EXPECT_TRUE(frame->inputs.empty());
+
+        frame = replayer.next();
+        ASSERT_NE(frame, nullptr);
+        EXPECT_FLOAT_EQ(frame->millis, 17.25f);
+        EXPECT_FLOAT_EQ(frame->realMillis, 34.5f);
+        ASSERT_EQ(frame->inputs.size(), inputs.size());
+        for (size_t i = 0; i < inputs.size(); i++) {
+            const InputEvent& expected = inputs[i];
+            const InputEvent& actual = frame->inputs[i];
+            EXPECT_EQ(actual.type, expected.type);
+            EXPECT_EQ(actual.key, expected.key);
+            EXPECT_EQ(actual.mouse, expected.mouse);
+            EXPECT_EQ(actual.status, expected.status);
+            EXPECT_EQ(actual.modifiers, expected.modifiers);
+            EXPECT_FLOAT_EQ(actual.mousePos.x, expected.mousePos.x);
+            EXPECT_FLOAT_EQ(actual.mousePos.y, expected.mousePos.y);
+            EXPECT_FLOAT_EQ(actual.value, expected.value);
+            EXPECT_EQ(actual.unicode, expected.unicode);
+        }
+        EXPECT_EQ(replayer.next(), nullptr);
+        EXPECT_TRUE(replayer.isFinished());
+        std::filesystem::remove(path);
+    }
+
+    TEST(InputLog, invalid_log) {
+        EXPECT_THROW((InputReplayer(tempLog("missing"))), ResourceLoadFailed);
+
+        std::filesystem::path path = tempLog("invalid");
+        std::ofstream(path, std::ios::binary) << "not a log";
+        EXPECT_THROW((InputReplayer(path)), ResourceLoadFailed);
+
+        // Cut off in the middle of a frame
+        {
+            InputRecorder recorder(path);
+            recorder.record(InputEvent::mouseMove(Vec2(1.0f, 2.0f)));
+            recorder.endFrame(16.0f);
+        }
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+        EXPECT_THROW((InputReplayer(path)), ResourceLoadFailed);
+
+        // Key, mouse, and status bytes out of range, after the 5 bytes of header and 10 bytes of frame and type
+        auto corrupt = [&path](const InputEvent& input, size_t offset) {
+            {
+                InputRecorder recorder(path);
+                recorder.record(input);
+                recorder.endFrame(16.0f);
+            }
+            std::string data;
+            {
+                std::ifstream file(path, std::ios::binary);
+                data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            }
+            data[offset]++;
+            std::ofstream(path, std::ios::binary) << data;
+        };
+        corrupt(InputEvent::keyboard(Key::NONE, ButtonEvent::DOWN), 15);
+        EXPECT_THROW((InputReplayer(path)), ResourceLoadFailed);
+        corrupt(InputEvent::keyboard(Key::A, ButtonEvent::UP), 16);
+        EXPECT_THROW((InputReplayer(path)), ResourceLoadFailed);
+        corrupt(InputEvent::mouseButton(Mouse::NONE, ButtonEvent::DOWN, Vec2::ZERO()), 15);
+        EXPECT_THROW((InputReplayer(path)), ResourceLoadFailed);
+        corrupt(InputEvent::mouseButton(Mouse::MIDDLE, ButtonEvent::DOWN, Vec2::ZERO()), 15);
+        EXPECT_NO_THROW((InputReplayer(path)));
+        std::filesystem::remove(path);
+    }
+}
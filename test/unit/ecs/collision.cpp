@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <corn/core/scene.h>
+#include <corn/ecs/component.h>
+#include <corn/ecs/entity_manager.h>
+#include <corn/ecs/system.h>
+#include <corn/event/event_args.h>
+#include <corn/event/event_manager.h>
+#include "dummy_scene.h"
+
+namespace corn::test::collision {
+    using Pairs = std::vector<std::pair<Entity::EntityID, Entity::EntityID>>;
+
+    /// @return IDs of all pairs of colliders that overlap, computed by brute force.
+    Pairs bruteForce(EntityManager& entityManager) {
+        Pairs pairs;
+        std::vector<Entity*> entities = entityManager.getQuery<With<CTransform2D, CBBox>>().getEntities();
+        for (size_t i = 0; i < entities.size(); i++) {
+            for (size_t j = i + 1; j < entities.size(); j++) {
+                auto* bBox1 = entities[i]->getComponent<CBBox>();
+                auto* bBox2 = entities[j]->getComponent<CBBox>();
+                if (!bBox1->active || !bBox2->active || !bBox1->interactsWith(*bBox2)) continue;
+                if (!bBox1->overlapWith(*bBox2)) continue;
+                pairs.emplace_back(
+                        std::min(entities[i]->getID(), entities[j]->getID()),
+                        std::max(entities[i]->getID(), entities[j]->getID()));
+            }
+        }
+        std::sort(pairs.begin(), pairs.end());
+        return pairs;
+    }
+
+    class BroadphaseTest : public ::testing::TestWithParam<BroadphaseType> {};
+
+    TEST_P(BroadphaseTest, matches_brute_force) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        scene.addSystem<SCollisionDetection>(GetParam(), 32.0f);
+        Pairs detected;
+        scene.getEventManager().addListener("corn::game::collision", [&detected](const EventArgs& args) {
+            const auto& collision = dynamic_cast<const EventArgsCollision&>(args);
+            Entity::EntityID id1 = collision.collider1->getEntity().getID();
+            Entity::EntityID id2 = collision.collider2->getEntity().getID();
+            detected.emplace_back(std::min(id1, id2), std::max(id1, id2));
+        });
+
+        std::mt19937 random(42);
+        std::uniform_real_distribution<float> location(-300.0f, 300.0f);
+        std::uniform_real_distribution<float> size(1.0f, 40.0f);
+        std::uniform_real_distribution<float> step(-20.0f, 20.0f);
+        std::vector<Entity*> entities;
+        for (int i = 0; i < 150; i++) {
+            Entity* parent = i % 10 == 0 || entities.empty() ? nullptr : entities[i / 2];
+            Entity& entity = entityManager.createEntity("box", parent);
+            entity.addComponent<CTransform2D>(Vec2(location(random), location(random)));
+            entity.addComponent<CBBox>(Vec2::ZERO(), Vec2(size(random), size(random)));
+            entities.push_back(&entity);
+        }
+        // Colliders in three layers, some of which only collide with one another layer
+        const std::uint32_t masks[] = { ~std::uint32_t(0), 0b011, 0b100, 0 };
+        for (size_t i = 0; i < entities.size(); i++) {
+            entities[i]->getComponent<CBBox>()->layer = 1 << (i % 3);
+            entities[i]->getComponent<CBBox>()->mask = masks[i % 7 % 4];
+        }
+        // A collider spanning many cells, an inactive collider, and an invalid collider
+        entities[1]->getComponent<CBBox>()->br = Vec2(500.0f, 200.0f);
+        entities[2]->getComponent<CBBox>()->active = false;
+        entities[3]->getComponent<CBBox>()->br = Vec2(-1.0f, -1.0f);
+
+        for (int frame = 0; frame < 10; frame++) {
+            detected.clear();
+            scene.update(16.0f);
+            std::sort(detected.begin(), detected.end());
+            EXPECT_EQ(detected, bruteForce(entityManager)) << "frame " << frame;
+
+            // Move some colliders, change the layers of some, and replace others
+            entities[frame * 5 + 10]->getComponent<CBBox>()->layer = 0b110;
+            for (size_t i = 0; i < entities.size(); i += 3) {
+                entities[i]->getComponent<CTransform2D>()->addWorldLocationOffset(
+                        Vec2(step(random), step(random)));
+            }
+            entities.back()->destroy();
+            entities.pop_back();
+            Entity& entity = entityManager.createEntity("box");
+            entity.addComponent<CTransform2D>(Vec2(location(random), location(random)));
+            entity.addComponent<CBBox>(Vec2::ZERO(), Vec2(size(random), size(random)));
+            entities.push_back(&entity);
+        }
+    }
+
+    INSTANTIATE_TEST_SUITE_P(SCollisionDetection, BroadphaseTest, ::testing::Values(
+            BroadphaseType::SWEEP_AND_PRUNE, BroadphaseType::SPATIAL_HASH, BroadphaseType::AABB_TREE));
+
+    TEST(SCollisionDetection, listener_destroys_entity) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        scene.addSystem<SCollisionDetection>();
+        for (int i = 0; i < 3; i++) {
+            Entity& entity = entityManager.createEntity("box");
+            entity.addComponent<CTransform2D>(Vec2::ZERO());
+            entity.addComponent<CBBox>(Vec2::ZERO(), Vec2(10.0f, 10.0f));
+        }
+
+        // All three colliders overlap, and each listener call destroys the first collider, so the collision between the
+        // first and the third collider is skipped
+        int count = 0;
+        scene.getEventManager().addListener("corn::game::collision", [&count](const EventArgs& args) {
+            count++;
+            dynamic_cast<const EventArgsCollision&>(args).collider1->getEntity().destroy();
+        });
+        scene.update(16.0f);
+        EXPECT_EQ(count, 2);
+    }
+
+    TEST(SCollisionDetection, contact_phases) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        auto* system = scene.addSystem<SCollisionDetection>();
+        system->emitCollisionEvents = false;
+        int batches = 0;
+        scene.getEventManager().addListener("corn::game::contacts", [&batches](const EventArgs& args) {
+            batches++;
+            EXPECT_FALSE(dynamic_cast<const EventArgsContacts&>(args).contacts.empty());
+        });
+        int collisions = 0;
+        scene.getEventManager().addListener("corn::game::collision", [&collisions](const EventArgs&) {
+            collisions++;
+        });
+
+        Entity& a = entityManager.createEntity("a");
+        Entity& b = entityManager.createEntity("b");
+        auto* transformA = a.addComponent<CTransform2D>(Vec2::ZERO());
+        b.addComponent<CTransform2D>(Vec2(5.0f, 0.0f));
+        auto* bBoxA = a.addComponent<CBBox>(Vec2::ZERO(), Vec2(10.0f, 10.0f));
+        auto* bBoxB = b.addComponent<CBBox>(Vec2::ZERO(), Vec2(10.0f, 10.0f));
+        auto expectPhase = [system](ContactPhase phase) {
+            ASSERT_EQ(system->getContacts().size(), 1);
+            EXPECT_EQ(system->getContacts()[0].phase, phase);
+        };
+
+        scene.update(16.0f);
+        expectPhase(ContactPhase::BEGIN);
+        EXPECT_EQ(system->getContacts()[0].collider1, bBoxA);
+        EXPECT_EQ(system->getContacts()[0].collider2, bBoxB);
+        scene.update(16.0f);
+        expectPhase(ContactPhase::PERSIST);
+        transformA->setLocation(Vec2(100.0f, 0.0f));
+        scene.update(16.0f);
+        expectPhase(ContactPhase::END);
+        scene.update(16.0f);
+        EXPECT_TRUE(system->getContacts().empty());
+
+        // Removing a collider ends the contact
+        transformA->setLocation(Vec2::ZERO());
+        scene.update(16.0f);
+        expectPhase(ContactPhase::BEGIN);
+        b.destroy();
+        scene.update(16.0f);
+        expectPhase(ContactPhase::END);
+        EXPECT_EQ(system->getContacts()[0].collider2, nullptr);
+
+        EXPECT_EQ(batches, 5);
+        EXPECT_EQ(collisions, 0);
+    }
+
+    TEST(SCollisionDetection, layers) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        auto* system = scene.addSystem<SCollisionDetection>();
+        auto createBox = [&entityManager](std::uint32_t layer, std::uint32_t mask) {
+            Entity& entity = entityManager.createEntity("box");
+            entity.addComponent<CTransform2D>(Vec2::ZERO());
+            return entity.addComponent<CBBox>(Vec2::ZERO(), Vec2(10.0f, 10.0f), layer, mask);
+        };
+        CBBox* player = createBox(0b01, 0b10);
+        CBBox* enemy = createBox(0b10, 0b01);
+        createBox(0b10, 0b01);
+        CBBox* wall = createBox(0b100, ~std::uint32_t(0));
+
+        // Enemies do not collide with each other, and nothing collides with the wall as it is not in their masks
+        scene.update(16.0f);
+        ASSERT_EQ(system->getContacts().size(), 2);
+        EXPECT_EQ(system->getContacts()[0].collider1, player);
+        EXPECT_EQ(system->getContacts()[0].collider2, enemy);
+
+        // Changing the mask ends the contacts
+        player->mask = 0;
+        wall->mask = 0;
+        scene.update(16.0f);
+        ASSERT_EQ(system->getContacts().size(), 2);
+        EXPECT_EQ(system->getContacts()[0].phase, ContactPhase::END);
+        EXPECT_EQ(system->getContacts()[1].phase, ContactPhase::END);
+    }
+
+    TEST(SCollisionDetection, invalid_cell_size) {
+        DummyScene scene;
+        EXPECT_THROW(scene.addSystem<SCollisionDetection>(BroadphaseType::SPATIAL_HASH, 0.0f), std::invalid_argument);
+        EXPECT_THROW(scene.addSystem<SCollisionDetection>(BroadphaseType::SPATIAL_HASH, -1.0f), std::invalid_argument);
+        EXPECT_THROW(scene.addSystem<SCollisionDetection>(
+                BroadphaseType::AABB_TREE, std::numeric_limits<float>::quiet_NaN()), std::invalid_argument);
+        EXPECT_THROW(scene.addSystem<SCollisionDetection>(
+                BroadphaseType::SWEEP_AND_PRUNE, std::numeric_limits<float>::infinity()), std::invalid_argument);
+        EXPECT_EQ(scene.addSystem<SCollisionDetection>(BroadphaseType::SPATIAL_HASH, 32.0f)->getBroadphase(),
+                  BroadphaseType::SPATIAL_HASH);
+    }
+}
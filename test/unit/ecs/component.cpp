@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <corn/ecs/component.h>
+#include <corn/ecs/entity.h>
+#include <corn/ecs/entity_manager.h>
+#include <corn/geometry/operations.h>
+#include "dummy_scene.h"
+
+namespace corn::test::component {
+    void expectVec2Near(const Vec2& actual, const Vec2& expected) {
+        EXPECT_NEAR(actual.x, expected.x, 1e-3f);
+        EXPECT_NEAR(actual.y, expected.y, 1e-3f);
+    }
+
+    TEST(CTransform2D, world_transform) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        Entity& parent = entityManager.createEntity("parent");
+        Entity& middle = entityManager.createEntity("middle", &parent);
+        Entity& child = entityManager.createEntity("child", &middle);
+        auto* parentTransform = parent.addComponent<CTransform2D>(Vec2(10.0f, 0.0f), Deg(90.0f));
+        auto* childTransform = child.addComponent<CTransform2D>(Vec2(1.0f, 0.0f));
+
+        // Entities without transform are skipped
+        auto [location, rotation] = childTransform->getWorldTransform();
+        expectVec2Near(location, Vec2(10.0f, 0.0f) + rotate(Vec2(1.0f, 0.0f), Deg(90.0f)));
+        EXPECT_FLOAT_EQ(rotation.get(), 90.0f);
+
+        // Changing an ancestor updates the descendants
+        parentTransform->setLocation(Vec2(20.0f, 5.0f));
+        expectVec2Near(childTransform->getWorldTransform().first, Vec2(20.0f, 5.0f) + rotate(Vec2(1.0f, 0.0f), Deg(90.0f)));
+        parentTransform->setRotation(Deg(0.0f));
+        expectVec2Near(childTransform->getWorldTransform().first, Vec2(21.0f, 5.0f));
+
+        // Adding a transform to an ancestor updates the descendants
+        middle.addComponent<CTransform2D>(Vec2(0.0f, 3.0f));
+        expectVec2Near(childTransform->getWorldTransform().first, Vec2(21.0f, 8.0f));
+        middle.removeComponent<CTransform2D>();
+        expectVec2Near(childTransform->getWorldTransform().first, Vec2(21.0f, 5.0f));
+
+        // The result is the same after refreshing top-down
+        parentTransform->setLocation(Vec2(0.0f, 0.0f));
+        entityManager.tidy();
+        expectVec2Near(childTransform->getWorldTransform().first, Vec2(1.0f, 0.0f));
+    }
+
+    TEST(CTransform2D, set_world_location) {
+        DummyScene scene;
+        Entity& parent = scene.getEntityManager().createEntity("parent");
+        Entity& child = scene.getEntityManager().createEntity("child", &parent);
+        parent.addComponent<CTransform2D>(Vec2(5.0f, 5.0f), Deg(45.0f));
+        auto* childTransform = child.addComponent<CTransform2D>(Vec2::ZERO());
+
+        childTransform->setWorldLocation(Vec2(1.0f, 2.0f));
+        expectVec2Near(childTransform->getWorldTransform().first, Vec2(1.0f, 2.0f));
+        childTransform->addWorldLocationOffset(Vec2(3.0f, -1.0f));
+        expectVec2Near(childTransform->getWorldTransform().first, Vec2(4.0f, 1.0f));
+    }
+
+    TEST(CTransform2D, render_interpolation) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        auto* transform = entityManager.createEntity("entity").addComponent<CTransform2D>(Vec2::ZERO(), Deg(350.0f));
+
+        // Nothing to interpolate before the first snapshot
+        entityManager.setInterpolationAlpha(0.5f);
+        expectVec2Near(transform->getRenderTransform().first, Vec2::ZERO());
+
+        entityManager.snapshotTransforms();
+        transform->setTransform(Vec2(10.0f, -4.0f), Deg(10.0f));
+        auto [location, rotation] = transform->getRenderTransform();
+        expectVec2Near(location, Vec2(5.0f, -2.0f));
+        EXPECT_NEAR(rotation.get(), 0.0f, 1e-3f);  // Along the shorter arc
+
+        entityManager.setInterpolationAlpha(2.0f);
+        EXPECT_FLOAT_EQ(entityManager.getInterpolationAlpha(), 1.0f);
+        expectVec2Near(transform->getRenderTransform().first, Vec2(10.0f, -4.0f));
+
+        // Entities created after the snapshot are rendered at their current transform
+        entityManager.setInterpolationAlpha(0.0f);
+        auto* other = entityManager.createEntity("other").addComponent<CTransform2D>(Vec2(3.0f, 3.0f));
+        expectVec2Near(other->getRenderTransform().first, Vec2(3.0f, 3.0f));
+        expectVec2Near(transform->getRenderTransform().first, Vec2::ZERO());
+    }
+
+    TEST(CTransform2D, reset_interpolation) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        Entity& parent = entityManager.createEntity("parent");
+        Entity& child = entityManager.createEntity("child", &parent);
+        Entity& other = entityManager.createEntity("other");
+        auto* parentTransform = parent.addComponent<CTransform2D>(Vec2::ZERO());
+        auto* childTransform = child.addComponent<CTransform2D>(Vec2(1.0f, 0.0f));
+        auto* otherTransform = other.addComponent<CTransform2D>(Vec2::ZERO());
+        entityManager.setInterpolationAlpha(0.5f);
+
+        // Teleported entities and their descendants are not interpolated until the next snapshot
+        entityManager.snapshotTransforms();
+        parentTransform->setLocation(Vec2(100.0f, 0.0f));
+        otherTransform->setLocation(Vec2(100.0f, 0.0f));
+        entityManager.resetInterpolation(parent);
+        expectVec2Near(parentTransform->getRenderTransform().first, Vec2(100.0f, 0.0f));
+        expectVec2Near(childTransform->getRenderTransform().first, Vec2(101.0f, 0.0f));
+        expectVec2Near(otherTransform->getRenderTransform().first, Vec2(50.0f, 0.0f));
+
+        entityManager.snapshotTransforms();
+        parentTransform->setLocation(Vec2(200.0f, 0.0f));
+        expectVec2Near(parentTransform->getRenderTransform().first, Vec2(150.0f, 0.0f));
+
+        // Reactivated entities are not interpolated either
+        parent.setActive(false);
+        entityManager.snapshotTransforms();
+        parentTransform->setLocation(Vec2::ZERO());
+        parent.setActive(true);
+        expectVec2Near(parentTransform->getRenderTransform().first, Vec2::ZERO());
+        expectVec2Near(childTransform->getRenderTransform().first, Vec2(1.0f, 0.0f));
+    }
+
+    TEST(CMovement2D, world_movement) {
+        DummyScene scene;
+        Entity& parent = scene.getEntityManager().createEntity("parent");
+        Entity& child = scene.getEntityManager().createEntity("child", &parent);
+        auto* parentTransform = parent.addComponent<CTransform2D>(Vec2::ZERO(), Deg(90.0f));
+        auto* parentMovement = parent.addComponent<CMovement2D>(Vec2(1.0f, 0.0f), 10.0f);
+        auto* childMovement = child.addComponent<CMovement2D>(Vec2(0.0f, 2.0f), 5.0f);
+
+        auto [velocity, angularVelocity] = childMovement->getWorldMovement();
+        expectVec2Near(velocity, Vec2(1.0f, 0.0f) + rotate(Vec2(0.0f, 2.0f), Deg(90.0f)));
+        EXPECT_FLOAT_EQ(angularVelocity, 15.0f);
+
+        // Changing the velocity or the rotation of an ancestor updates the descendants
+        parentMovement->setVelocity(Vec2::ZERO());
+        parentTransform->setRotation(Deg(0.0f));
+        expectVec2Near(childMovement->getWorldMovement().first, Vec2(0.0f, 2.0f));
+
+        childMovement->setWorldVelocity(Vec2(3.0f, 4.0f));
+        expectVec2Near(childMovement->getWorldMovement().first, Vec2(3.0f, 4.0f));
+    }
+}
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <corn/ecs/component.h>
+#include <corn/ecs/component_registry.h>
+#include <corn/ecs/entity.h>
+#include <corn/ecs/entity_manager.h>
+#include "dummy_scene.h"
+
+namespace corn::test::entity {
+    TEST(Entity, add_get_remove_component) {
+        DummyScene scene;
+        Entity& entity = scene.getEntityManager().createEntity("entity");
+
+        // Add
+        auto* transform = entity.addComponent<CTransform2D>(Vec2(1.0f, 2.0f));
+        ASSERT_NE(transform, nullptr);
+        EXPECT_EQ(&transform->getEntity(), &entity);
+        EXPECT_EQ(entity.addComponent<CTransform2D>(Vec2::ZERO()), nullptr);
+
+        // Get
+        EXPECT_EQ(entity.getComponent<CTransform2D>(), transform);
+        EXPECT_EQ(entity.getComponent<CMovement2D>(), nullptr);
+
+        // Remove
+        EXPECT_TRUE(entity.removeComponent<CTransform2D>());
+        EXPECT_FALSE(entity.removeComponent<CTransform2D>());
+        EXPECT_EQ(entity.getComponent<CTransform2D>(), nullptr);
+    }
+
+    TEST(Entity, component_pointers_are_stable) {
+        DummyScene scene;
+        std::vector<Entity*> entities;
+        std::vector<CMovement2D*> movements;
+        for (int i = 0; i < 5000; i++) {
+            Entity& entity = scene.getEntityManager().createEntity("entity");
+            entities.push_back(&entity);
+            movements.push_back(entity.addComponent<CMovement2D>(Vec2((float)i, 0.0f)));
+        }
+
+        // Remove every other component
+        for (size_t i = 0; i < entities.size(); i += 2) {
+            entities[i]->removeComponent<CMovement2D>();
+        }
+
+        // Remaining components are not moved
+        for (size_t i = 1; i < entities.size(); i += 2) {
+            EXPECT_EQ(entities[i]->getComponent<CMovement2D>(), movements[i]);
+            EXPECT_FLOAT_EQ(movements[i]->getVelocity().x, (float)i);
+        }
+    }
+
+    TEST(Entity, destroy_releases_components) {
+        DummyScene scene;
+        Entity& entity1 = scene.getEntityManager().createEntity("entity1");
+        entity1.addComponent<CTransform2D>(Vec2(1.0f, 1.0f));
+        entity1.destroy();
+
+        // A new entity does not inherit components of a destroyed one
+        Entity& entity2 = scene.getEntityManager().createEntity("entity2");
+        EXPECT_EQ(entity2.getComponent<CTransform2D>(), nullptr);
+        auto* transform = entity2.addComponent<CTransform2D>(Vec2(2.0f, 2.0f));
+        EXPECT_EQ(entity2.getComponent<CTransform2D>(), transform);
+        EXPECT_FLOAT_EQ(transform->getLocation().x, 2.0f);
+    }
+
+    TEST(Entity, ids_of_destroyed_entities_are_stale) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        Entity& entity1 = entityManager.createEntity("entity1");
+        Entity::EntityID id1 = entity1.getID();
+        EXPECT_NE(id1, 0);
+        EXPECT_EQ(entityManager.getEntityByID(id1), &entity1);
+
+        // The slot is reused, but the old ID does not refer to the new entity
+        entity1.destroy();
+        EXPECT_EQ(entityManager.getEntityByID(id1), nullptr);
+        Entity& entity2 = entityManager.createEntity("entity2");
+        EXPECT_EQ(Entity::indexOf(entity2.getID()), Entity::indexOf(id1));
+        EXPECT_NE(entity2.getID(), id1);
+        EXPECT_EQ(entityManager.getEntityByID(id1), nullptr);
+        EXPECT_EQ(entityManager.getEntityByID(entity2.getID()), &entity2);
+
+        // Clearing the entity manager also invalidates the IDs
+        Entity::EntityID id2 = entity2.getID();
+        entityManager.clear();
+        EXPECT_EQ(entityManager.getEntityByID(id2), nullptr);
+    }
+
+    TEST(Entity, parent_and_children) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        Entity& parent = entityManager.createEntity("parent");
+        Entity& child1 = entityManager.createEntity("child1", &parent);
+        Entity& child2 = entityManager.createEntity("child2", &parent);
+        EXPECT_EQ(parent.getParent(), nullptr);
+        EXPECT_EQ(child1.getParent(), &parent);
+        EXPECT_EQ(parent.getChildren(), (std::vector<Entity*>{ &child1, &child2 }));
+
+        child1.destroy();
+        EXPECT_EQ(parent.getChildren(), (std::vector<Entity*>{ &child2 }));
+    }
+
+    TEST(Entity, component_signature) {
+        DummyScene scene;
+        Entity& entity = scene.getEntityManager().createEntity("entity");
+        size_t transformID = ComponentRegistry::id<CTransform2D>();
+        size_t movementID = ComponentRegistry::id<CMovement2D>();
+        EXPECT_NE(transformID, movementID);
+        EXPECT_EQ(ComponentRegistry::id<CTransform2D>(), transformID);
+        EXPECT_TRUE(entity.getSignature().none());
+        EXPECT_TRUE(entity.hasComponents<>());
+
+        entity.addComponent<CTransform2D>(Vec2::ZERO());
+        EXPECT_TRUE(entity.getSignature().test(transformID));
+        EXPECT_TRUE(entity.hasComponents<CTransform2D>());
+        EXPECT_FALSE((entity.hasComponents<CTransform2D, CMovement2D>()));
+
+        entity.addComponent<CMovement2D>();
+        EXPECT_TRUE((entity.hasComponents<CMovement2D, CTransform2D>()));
+        EXPECT_EQ(entity.getSignature(), (ComponentRegistry::signature<CTransform2D, CMovement2D>()));
+
+        entity.removeComponent<CTransform2D>();
+        EXPECT_FALSE(entity.getSignature().test(transformID));
+        EXPECT_TRUE(entity.hasComponents<CMovement2D>());
+        EXPECT_EQ(entity.getComponent<CTransform2D>(), nullptr);
+    }
+
+    /// @brief Component type that no entity ever has.
+    struct CUnused : public Component {
+        using Component::Component;
+    };
+
+    TEST(Entity, lookups_assign_no_ids) {
+        DummyScene scene;
+        Entity& entity = scene.getEntityManager().createEntity("entity");
+        entity.addComponent<CTransform2D>(Vec2::ZERO());
+        size_t registered = ComponentRegistry::size();
+
+        EXPECT_EQ(entity.getComponent<CUnused>(), nullptr);
+        EXPECT_EQ(entity.getComponentMut<CUnused>(), nullptr);
+        EXPECT_FALSE((entity.hasComponents<CTransform2D, CUnused>()));
+        EXPECT_FALSE(entity.removeComponent<CUnused>());
+        EXPECT_EQ(ComponentRegistry::find<CUnused>(), ComponentRegistry::NPOS);
+        EXPECT_EQ(ComponentRegistry::size(), registered);
+        EXPECT_EQ(ComponentRegistry::find<CTransform2D>(), ComponentRegistry::id<CTransform2D>());
+    }
+
+    TEST(Entity, active_in_world) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        Entity& parent = entityManager.createEntity("parent");
+        Entity& child = entityManager.createEntity("child", &parent);
+        Entity& grandchild = entityManager.createEntity("grandchild", &child);
+        EXPECT_TRUE(grandchild.isActiveInWorld());
+
+        parent.setActive(false);
+        EXPECT_FALSE(child.isActiveInWorld());
+        EXPECT_FALSE(grandchild.isActiveInWorld());
+        EXPECT_TRUE(child.isActive());
+
+        // Entities created under an inactive parent are inactive in the world
+        Entity& late = entityManager.createEntity("late", &child);
+        EXPECT_FALSE(late.isActiveInWorld());
+
+        // An inactive descendant keeps its subtree inactive when the ancestor is reactivated
+        child.setActive(false);
+        parent.setActive(true);
+        EXPECT_TRUE(parent.isActiveInWorld());
+        EXPECT_FALSE(grandchild.isActiveInWorld());
+        EXPECT_EQ(entityManager.getAllActiveEntities(), (std::vector<Entity*>{ &parent }));
+        EXPECT_TRUE(entityManager.getAllActiveEntities(&child).empty());
+        child.setActive(true);
+        EXPECT_TRUE(grandchild.isActiveInWorld());
+        EXPECT_TRUE(late.isActiveInWorld());
+        EXPECT_EQ(entityManager.getAllActiveEntities().size(), 4);
+    }
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <corn/core/scene.h>
+#include <corn/ecs/component.h>
+#include <corn/ecs/entity.h>
+#include <corn/ecs/entity_command_buffer.h>
+#include <corn/ecs/entity_manager.h>
+#include <corn/ecs/system.h>
+#include "dummy_scene.h"
+
+namespace corn::test::entity_command_buffer {
+    TEST(EntityCommandBuffer, playback) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        EntityCommandBuffer& buffer = scene.getCommandBuffer();
+        Entity& parent = entityManager.createEntity("parent");
+        Entity& entity = entityManager.createEntity("entity");
+
+        buffer.createEntity("child", &parent, [](Entity& child) {
+            child.addComponent<CTransform2D>(Vec2(1.0f, 2.0f));
+        });
+        buffer.addComponent<CTransform2D>(entity, Vec2(3.0f, 4.0f));
+        buffer.setActive(entity, false);
+        EXPECT_EQ(buffer.size(), 3);
+
+        // Nothing changes before playback
+        EXPECT_TRUE(parent.getChildren().empty());
+        EXPECT_EQ(entity.getComponent<CTransform2D>(), nullptr);
+
+        buffer.playback();
+        EXPECT_TRUE(buffer.empty());
+        ASSERT_EQ(parent.getChildren().size(), 1);
+        EXPECT_EQ(parent.getChildren()[0]->getName(), "child");
+        EXPECT_EQ(parent.getChildren()[0]->getComponent<CTransform2D>()->getLocation().x, 1.0f);
+        ASSERT_NE(entity.getComponent<CTransform2D>(), nullptr);
+        EXPECT_EQ(entity.getComponent<CTransform2D>()->getLocation().y, 4.0f);
+        EXPECT_FALSE(entity.isActive());
+
+        buffer.removeComponent<CTransform2D>(entity);
+        buffer.playback();
+        EXPECT_EQ(entity.getComponent<CTransform2D>(), nullptr);
+    }
+
+    TEST(EntityCommandBuffer, destroy) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        EntityCommandBuffer& buffer = scene.getCommandBuffer();
+        Entity& parent = entityManager.createEntity("parent");
+        Entity& child1 = entityManager.createEntity("child1", &parent);
+        Entity& child2 = entityManager.createEntity("child2", &parent);
+        Entity& child3 = entityManager.createEntity("child3", &parent);
+        Entity& grandchild = entityManager.createEntity("grandchild", &child1);
+        Entity::EntityID child1ID = child1.getID();
+        Entity::EntityID child3ID = child3.getID();
+        Entity::EntityID grandchildID = grandchild.getID();
+
+        // Destroying an entity twice, or an entity along with its ancestor, is allowed
+        buffer.destroy(grandchild);
+        buffer.destroy(child1);
+        buffer.destroy(child3);
+        buffer.destroy(child1);
+        // Commands on destroyed entities are skipped
+        buffer.addComponent<CTransform2D>(child3, Vec2::ZERO());
+        buffer.createEntity("orphan", &child3);
+        buffer.playback();
+
+        EXPECT_EQ(entityManager.getEntityByID(child1ID), nullptr);
+        EXPECT_EQ(entityManager.getEntityByID(child3ID), nullptr);
+        EXPECT_EQ(entityManager.getEntityByID(grandchildID), nullptr);
+        ASSERT_EQ(parent.getChildren().size(), 1);
+        EXPECT_EQ(parent.getChildren()[0], &child2);
+        EXPECT_EQ(entityManager.getAllEntities().size(), 2);
+    }
+
+    /// @brief Destroys all entities with a transform from a parallel system.
+    class SDestroy : public System {
+    public:
+        explicit SDestroy(Scene& scene) : System(scene) {
+            this->writes<CTransform2D>();
+        }
+
+        void update(float) override {
+            EntityCommandBuffer& buffer = this->getScene().getCommandBuffer();
+            this->getScene().getEntityManager().forEachParallel<CTransform2D>([&buffer](Entity& entity, CTransform2D&) {
+                buffer.destroy(entity);
+            });
+        }
+    };
+
+    TEST(EntityCommandBuffer, scene_sync_point) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        for (int i = 0; i < 1000; i++) {
+            entityManager.createEntity("entity").addComponent<CTransform2D>(Vec2::ZERO());
+        }
+        scene.addSystem<SDestroy>();
+        scene.update(16.0f);
+        EXPECT_TRUE(scene.getCommandBuffer().empty());
+        EXPECT_TRUE(entityManager.getAllEntities().empty());
+    }
+
+    TEST(EntityCommandBuffer, throwing_command) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        EntityCommandBuffer& buffer = scene.getCommandBuffer();
+        Entity& entity = entityManager.createEntity("entity");
+
+        buffer.createEntity("first");
+        buffer.createEntity("throws", nullptr, [](Entity&) {
+            throw std::runtime_error("init failed");
+        });
+        buffer.addComponent<CTransform2D>(entity, Vec2::ZERO());
+        buffer.createEntity("last");
+
+        // The commands after the one that threw stay in the buffer, in order
+        EXPECT_THROW(buffer.playback(), std::runtime_error);
+        EXPECT_NE(entityManager.getEntityByName("first"), nullptr);
+        EXPECT_EQ(entity.getComponent<CTransform2D>(), nullptr);
+        EXPECT_EQ(buffer.size(), 2);
+        buffer.playback();
+        EXPECT_TRUE(buffer.empty());
+        EXPECT_NE(entity.getComponent<CTransform2D>(), nullptr);
+        EXPECT_NE(entityManager.getEntityByName("last"), nullptr);
+    }
+}
@@ -0,0 +1,363 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <corn/ecs/component.h>
+#include <corn/ecs/entity.h>
+#include <corn/ecs/entity_manager.h>
+#include "dummy_scene.h"
+
+namespace corn::test::entity_manager {
+    TEST(EntityManager, for_each_parallel) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        for (int i = 0; i < 10000; i++) {
+            Entity& entity = entityManager.createEntity("entity");
+            entity.addComponent<CTransform2D>(Vec2((float)i, 0.0f));
+            if (i % 2 == 0) {
+                entity.addComponent<CMovement2D>(Vec2(0.0f, (float)i));
+            }
+        }
+
+        std::atomic<int> count = 0;
+        entityManager.forEachParallel<CTransform2D, CMovement2D>(
+                [&count](Entity&, CTransform2D& transform, CMovement2D& movement) {
+                    transform.setLocation(transform.getLocation() + movement.getVelocity());
+                    count++;
+                });
+        EXPECT_EQ(count, 5000);
+
+        // World transforms are updated after the pass
+        for (Entity* entity : entityManager.getQuery<With<CTransform2D>>()) {
+            auto [location, rotation] = entity->getComponent<CTransform2D>()->getWorldTransform();
+            EXPECT_FLOAT_EQ(location.y, entity->getComponent<CMovement2D>() ? location.x : 0.0f);
+        }
+    }
+
+    TEST(EntityManager, overlapping_parallel_passes) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        Entity& outer = entityManager.createEntity("outer");
+        outer.addComponent<CTransform2D>(Vec2::ZERO());
+        outer.addComponent<CGravity2D>();
+        Entity& inner = entityManager.createEntity("inner");
+        inner.addComponent<CTransform2D>(Vec2::ZERO());
+        inner.addComponent<CMovement2D>();
+
+        // Nest the passes so that the inner pass deterministically ends while the outer one is still running
+        entityManager.forEachParallel<CTransform2D, const CGravity2D>(
+                [&entityManager](Entity&, CTransform2D& transform, const CGravity2D&) {
+                    entityManager.forEachParallel<CTransform2D, const CMovement2D>(
+                            [](Entity&, CTransform2D& transform, const CMovement2D&) {
+                                transform.setLocation(Vec2(2.0f, 0.0f));
+                            });
+                    transform.setLocation(Vec2(1.0f, 0.0f));
+                });
+
+        // Both passes invalidate their entities
+        EXPECT_FLOAT_EQ(outer.getComponent<CTransform2D>()->getWorldTransform().first.x, 1.0f);
+        EXPECT_FLOAT_EQ(inner.getComponent<CTransform2D>()->getWorldTransform().first.x, 2.0f);
+    }
+
+    TEST(EntityManager, structure_locked_during_parallel_pass) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        Entity& entity = entityManager.createEntity("entity");
+        entity.addComponent<CTransform2D>(Vec2::ZERO());
+
+        EXPECT_FALSE(entityManager.isStructureLocked());
+        entityManager.forEachParallel<CTransform2D>([&entityManager](Entity& entity, CTransform2D&) {
+            EXPECT_TRUE(entityManager.isStructureLocked());
+            EXPECT_THROW(entityManager.createEntity("child", &entity), std::logic_error);
+            EXPECT_THROW(entity.addComponent<CMovement2D>(), std::logic_error);
+            EXPECT_THROW(entity.removeComponent<CTransform2D>(), std::logic_error);
+            EXPECT_THROW(entity.setActive(false), std::logic_error);
+            EXPECT_THROW(entity.destroy(), std::logic_error);
+        });
+        EXPECT_FALSE(entityManager.isStructureLocked());
+        EXPECT_NE(entity.getComponent<CTransform2D>(), nullptr);
+    }
+
+    TEST(EntityManager, clear_reuses_memory) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        std::vector<CTransform2D*> transforms;
+        for (int i = 0; i < 100; i++) {
+            Entity& parent = entityManager.createEntity("parent");
+            transforms.push_back(parent.addComponent<CTransform2D>(Vec2((float)i, 0.0f)));
+            entityManager.createEntity("child", &parent).addComponent<CMovement2D>();
+        }
+
+        // Components are destroyed in bulk, and their slots are reused in the same order
+        entityManager.clear();
+        EXPECT_TRUE(entityManager.getAllEntities().empty());
+        EXPECT_TRUE(entityManager.getQuery<With<CTransform2D>>().getEntities().empty());
+        for (int i = 0; i < 100; i++) {
+            Entity& entity = entityManager.createEntity("entity");
+            EXPECT_EQ(entity.addComponent<CTransform2D>(Vec2::ZERO()), transforms[i]);
+        }
+        EXPECT_EQ(entityManager.getQuery<With<CTransform2D>>().getEntities().size(), 100);
+        EXPECT_NE(entityManager.getMemoryResource(), nullptr);
+    }
+
+    TEST(EntityManager, z_order) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        Entity& parent = entityManager.createEntity("parent");
+        std::vector<Entity*> children;
+        for (int i = 0; i < 5; i++) {
+            Entity& child = entityManager.createEntity("child", &parent);
+            child.addComponent<CTransform2D>(Vec2::ZERO());
+            children.push_back(&child);
+        }
+        auto expectOrder = [&parent](const std::vector<Entity*>& expected) {
+            EXPECT_EQ(parent.getChildren(), expected);
+        };
+
+        children[0]->getComponent<CTransform2D>()->setZOrder(3);
+        children[3]->getComponent<CTransform2D>()->setZOrder(-1);
+        entityManager.tidy();
+        expectOrder({ children[3], children[1], children[2], children[4], children[0] });
+
+        // Entities without a transform have z-order 0, and sorting is stable
+        Entity& plain = entityManager.createEntity("plain", &parent);
+        entityManager.tidy();
+        expectOrder({ children[3], children[1], children[2], children[4], &plain, children[0] });
+        children[2]->getComponent<CTransform2D>()->setZOrder(1);
+        entityManager.tidy();
+        expectOrder({ children[3], children[1], children[4], &plain, children[2], children[0] });
+
+        // Removing the transform resets the z-order to 0, moving the entity in front of higher ones
+        children[0]->removeComponent<CTransform2D>();
+        entityManager.tidy();
+        expectOrder({ children[3], children[1], children[4], &plain, children[0], children[2] });
+        children[4]->getComponent<CTransform2D>()->setZOrder(1);
+        children[3]->getComponent<CTransform2D>()->setZOrder(0);
+        entityManager.tidy();
+        expectOrder({ children[3], children[1], &plain, children[0], children[4], children[2] });
+    }
+
+    TEST(EntityManager, name_and_tag_index) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        Entity& a = entityManager.createEntity("a");
+        Entity& b = entityManager.createEntity("b");
+        Entity& a1 = entityManager.createEntity("x", &a);
+        Entity& b1 = entityManager.createEntity("x", &b);
+        Entity& a2 = entityManager.createEntity("x", &a1);
+
+        // Results are in tree order, and filtered by the parent
+        EXPECT_EQ(entityManager.getEntitiesByName("x"), (std::vector<Entity*>{ &a1, &a2, &b1 }));
+        EXPECT_EQ(entityManager.getEntityByName("x"), &a1);
+        EXPECT_EQ(entityManager.getEntitiesByName("x", &a), (std::vector<Entity*>{ &a1, &a2 }));
+        EXPECT_EQ(entityManager.getEntitiesByName("x", &a, false), (std::vector<Entity*>{ &a1 }));
+        EXPECT_EQ(entityManager.getEntityByName("x", &b), &b1);
+        EXPECT_EQ(entityManager.getEntityByName("y"), nullptr);
+
+        // Renaming
+        a1.setName("y");
+        EXPECT_EQ(a1.getName(), "y");
+        EXPECT_EQ(entityManager.getEntityByName("x"), &a2);
+        EXPECT_EQ(entityManager.getEntityByName("y"), &a1);
+        EXPECT_EQ(&a2.getName(), &b1.getName());
+
+        // Tags
+        EXPECT_TRUE(a2.addTag("enemy"));
+        EXPECT_FALSE(a2.addTag("enemy"));
+        EXPECT_TRUE(b.addTag("enemy"));
+        EXPECT_TRUE(b.addTag("boss"));
+        EXPECT_TRUE(b.hasTag("boss"));
+        EXPECT_EQ(b.getTags(), (std::vector<std::string>{ "enemy", "boss" }));
+        EXPECT_EQ(entityManager.getEntitiesByTag("enemy"), (std::vector<Entity*>{ &a2, &b }));
+        EXPECT_EQ(entityManager.getEntityByTag("enemy", &a), &a2);
+        EXPECT_TRUE(b.removeTag("boss"));
+        EXPECT_FALSE(b.removeTag("boss"));
+        EXPECT_EQ(entityManager.getEntityByTag("boss"), nullptr);
+
+        // Destroyed entities leave the indices
+        a.destroy();
+        EXPECT_EQ(entityManager.getEntitiesByName("x"), (std::vector<Entity*>{ &b1 }));
+        EXPECT_EQ(entityManager.getEntityByName("y"), nullptr);
+        EXPECT_EQ(entityManager.getEntitiesByTag("enemy"), (std::vector<Entity*>{ &b }));
+        entityManager.clear();
+        EXPECT_EQ(entityManager.getEntityByTag("enemy"), nullptr);
+        EXPECT_EQ(entityManager.createEntity("x").getName(), "x");
+    }
+
+    TEST(EntityManager, index_follows_sibling_order) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        Entity& parent = entityManager.createEntity("parent");
+        std::vector<Entity*> children;
+        for (int i = 0; i < 100; i++) {
+            Entity& child = entityManager.createEntity("x", &parent);
+            child.addComponent<CTransform2D>(Vec2::ZERO());
+            children.push_back(&child);
+        }
+        Entity& grandchild = entityManager.createEntity("x", children[0]);
+
+        // Moving each child to the front exhausts the room between sibling orders, forcing renumbering
+        for (int i = 0; i < 100; i++) {
+            children[i]->getComponent<CTransform2D>()->setZOrder(-i);
+            entityManager.tidy();
+        }
+        std::vector<Entity*> expected(children.rbegin(), children.rend());
+        expected.push_back(&grandchild);
+        EXPECT_EQ(parent.getChildren(), std::vector<Entity*>(children.rbegin(), children.rend()));
+        EXPECT_EQ(entityManager.getEntitiesByName("x"), expected);
+        EXPECT_EQ(entityManager.getEntityByName("x"), children[99]);
+    }
+
+    TEST(EntityManager, hierarchy_traversal) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        Entity& a = entityManager.createEntity("a");
+        Entity& a1 = entityManager.createEntity("a1", &a);
+        Entity& a11 = entityManager.createEntity("a11", &a1);
+        Entity& a2 = entityManager.createEntity("a2", &a);
+        Entity& b = entityManager.createEntity("b");
+        EXPECT_EQ(entityManager.getAllEntities(), (std::vector<Entity*>{ &a, &a1, &a11, &a2, &b }));
+        EXPECT_EQ(entityManager.getAllEntities(&a), (std::vector<Entity*>{ &a1, &a11, &a2 }));
+        EXPECT_EQ(entityManager.getAllEntities(&a, false), (std::vector<Entity*>{ &a1, &a2 }));
+        EXPECT_EQ(entityManager.getAllEntities(&a11).size(), 0);
+
+        a1.destroy();
+        EXPECT_EQ(entityManager.getAllEntities(), (std::vector<Entity*>{ &a, &a2, &b }));
+
+        // Reversing many children falls back to a full sort
+        std::vector<Entity*> children;
+        for (int i = 0; i < 100; i++) {
+            Entity& child = entityManager.createEntity("child", &b);
+            child.addComponent<CTransform2D>(Vec2::ZERO())->setZOrder(-i);
+            children.insert(children.begin(), &child);
+        }
+        entityManager.tidy();
+        EXPECT_EQ(b.getChildren(), children);
+    }
+
+    TEST(EntityManager, view) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        Entity& a = entityManager.createEntity("a");
+        Entity& a1 = entityManager.createEntity("a1", &a);
+        Entity& a11 = entityManager.createEntity("a11", &a1);
+        Entity& b = entityManager.createEntity("b");
+        a11.addComponent<CTransform2D>(Vec2::ZERO());
+        b.addComponent<CTransform2D>(Vec2::ZERO());
+        static_assert(std::ranges::forward_range<EntityView>);
+        static_assert(std::ranges::view<EntityView>);
+
+        auto collect = [](auto&& range) {
+            std::vector<Entity*> result;
+            for (Entity* entity : range) {
+                result.push_back(entity);
+            }
+            return result;
+        };
+        EXPECT_EQ(collect(entityManager.view()), entityManager.getAllEntities());
+        EXPECT_EQ(collect(entityManager.view(&a, false)), (std::vector<Entity*>{ &a1 }));
+        EXPECT_TRUE(entityManager.view(&a11).empty());
+
+        auto withTransform = entityManager.view() | std::views::filter([](const Entity* entity) {
+            return entity->hasComponents<CTransform2D>();
+        });
+        EXPECT_EQ(collect(withTransform), (std::vector<Entity*>{ &a11, &b }));
+        EXPECT_EQ(*std::ranges::begin(withTransform), &a11);
+        EXPECT_EQ(collect(entityManager.view() | std::views::take(2)), (std::vector<Entity*>{ &a, &a1 }));
+
+        a1.setActive(false);
+        EXPECT_EQ(collect(entityManager.activeView()), (std::vector<Entity*>{ &a, &b }));
+        EXPECT_TRUE(entityManager.activeView(&a1).empty());
+    }
+
+    TEST(EntityManager, observers) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        std::vector<std::string> log;
+        entityManager.onAdd<CTransform2D>([&log](Entity& entity, CTransform2D&) {
+            log.push_back("add " + entity.getName());
+        });
+        EntityManager::ObserverID removeID = entityManager.onRemove<CTransform2D>(
+                [&log](Entity& entity, CTransform2D& transform) {
+            // Component is still alive
+            log.push_back("remove " + entity.getName() + " " + std::to_string((int)transform.getLocation().x));
+        });
+        entityManager.onSet<CTransform2D>([&log](Entity& entity, CTransform2D& transform) {
+            log.push_back("set " + entity.getName() + " " + std::to_string((int)transform.getLocation().x));
+        });
+
+        Entity& parent = entityManager.createEntity("parent");
+        Entity& child = entityManager.createEntity("child", &parent);
+        parent.addComponent<CTransform2D>(Vec2(1.0f, 0.0f));
+        child.addComponent<CTransform2D>(Vec2(2.0f, 0.0f));
+        child.addComponent<CMovement2D>();
+        EXPECT_EQ(log, (std::vector<std::string>{ "add parent", "set parent 1", "add child", "set child 2" }));
+
+        log.clear();
+        child.getComponent<CTransform2D>()->setLocation(Vec2(3.0f, 0.0f));
+        // Setters called inside a patch do not notify on their own
+        parent.patchComponent<CTransform2D>([](CTransform2D& transform) {
+            transform.setRotation(Deg(90.0f));
+            transform.setLocation(Vec2(4.0f, 0.0f));
+        });
+        EXPECT_FALSE(parent.patchComponent<CMovement2D>([](CMovement2D&) {}));
+        EXPECT_EQ(log, (std::vector<std::string>{ "set child 3", "set parent 4" }));
+
+        // Destroying an entity notifies the removal of the components of its subtree
+        log.clear();
+        parent.destroy();
+        EXPECT_EQ(log, (std::vector<std::string>{ "remove child 3", "remove parent 4" }));
+
+        log.clear();
+        EXPECT_TRUE(entityManager.removeObserver(removeID));
+        EXPECT_FALSE(entityManager.removeObserver(removeID));
+        Entity& entity = entityManager.createEntity("entity");
+        entity.addComponent<CTransform2D>(Vec2::ZERO());
+        entity.removeComponent<CTransform2D>();
+        EXPECT_EQ(log, (std::vector<std::string>{ "add entity", "set entity 0" }));
+    }
+
+    TEST(EntityManager, camera_observers) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        Entity& entity1 = entityManager.createEntity("camera1");
+        Entity& entity2 = entityManager.createEntity("camera2");
+        CCamera* camera1 = entity1.addComponent<CCamera>(Vec2::ZERO());
+        CCamera* camera2 = entity2.addComponent<CCamera>(Vec2::ZERO());
+        EXPECT_EQ(entityManager.getCameras(), (std::vector<const CCamera*>{ camera1, camera2 }));
+
+        entity1.removeComponent<CCamera>();
+        EXPECT_EQ(entityManager.getCameras(), (std::vector<const CCamera*>{ camera2 }));
+        entityManager.clear();
+        EXPECT_TRUE(entityManager.getCameras().empty());
+    }
+
+    TEST(EntityManager, last_change_tick) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        EXPECT_EQ(entityManager.getLastChangeTick(), 0);
+
+        Entity& entity = entityManager.createEntity("entity");
+        EXPECT_EQ(entityManager.getLastChangeTick(), entityManager.getTick());
+
+        // Reading does not count as a change
+        entityManager.advanceTick();
+        std::uint64_t tick = entityManager.getLastChangeTick();
+        (void)entityManager.getEntityByName("entity");
+        EXPECT_EQ(entityManager.getLastChangeTick(), tick);
+
+        auto* transform = entity.addComponent<CTransform2D>(Vec2::ZERO());
+        EXPECT_EQ(entityManager.getLastChangeTick(), entityManager.getTick());
+        entityManager.advanceTick();
+        transform->setLocation(Vec2(1.0f, 0.0f));
+        EXPECT_EQ(entityManager.getLastChangeTick(), entityManager.getTick());
+        entityManager.advanceTick();
+        entity.setActive(false);
+        EXPECT_EQ(entityManager.getLastChangeTick(), entityManager.getTick());
+        entityManager.advanceTick();
+        entity.destroy();
+        EXPECT_EQ(entityManager.getLastChangeTick(), entityManager.getTick());
+    }
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include <corn/core/scene.h>
+#include <corn/ecs/component.h>
+#include <corn/ecs/entity.h>
+#include <corn/ecs/entity_manager.h>
+#include <corn/ecs/integration.h>
+#include <corn/ecs/system.h>
+#include <corn/geometry/operations.h>
+#include "dummy_scene.h"
+
+namespace corn::test::integration {
+    /// @brief Fills the batch with random bodies.
+    MotionBatch randomBatch(size_t size) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> dist(-500.0f, 500.0f);
+        std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+        MotionBatch batch;
+        batch.resize(size);
+        for (size_t i = 0; i < size; i++) {
+            Deg parentRotation = angle(rng);
+            batch.x[i] = dist(rng);
+            batch.y[i] = dist(rng);
+            batch.rotation[i] = angle(rng);
+            batch.vx[i] = dist(rng);
+            batch.vy[i] = dist(rng);
+            batch.angularVelocity[i] = dist(rng);
+            batch.gravityScale[i] = dist(rng) / 500.0f;
+            batch.parentSin[i] = parentRotation.sin();
+            batch.parentCos[i] = parentRotation.cos();
+        }
+        return batch;
+    }
+
+    TEST(Integration, kernels_match_scalar) {
+        // Odd size, so that the vectorized kernels also leave a remainder
+        MotionBatch expected = randomBatch(1037);
+        integrateMovement(expected, 0.016f, SimdLevel::SCALAR);
+        integrateGravity(expected, 2000.0f, 0.016f, SimdLevel::SCALAR);
+
+        for (SimdLevel level : { SimdLevel::SSE2, SimdLevel::AVX2 }) {
+            MotionBatch batch = randomBatch(1037);
+            integrateMovement(batch, 0.016f, level);
+            integrateGravity(batch, 2000.0f, 0.016f, level);
+            for (size_t i = 0; i < batch.size(); i++) {
+                EXPECT_NEAR(batch.x[i], expected.x[i], 1e-3f);
+                EXPECT_NEAR(batch.y[i], expected.y[i], 1e-3f);
+                EXPECT_NEAR(batch.rotation[i], expected.rotation[i], 1e-3f);
+                EXPECT_NEAR(batch.vx[i], expected.vx[i], 1e-3f);
+                EXPECT_NEAR(batch.vy[i], expected.vy[i], 1e-3f);
+            }
+        }
+    }
+
+    TEST(Integration, systems_match_component_operations) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        Entity& parent = entityManager.createEntity("parent");
+        parent.addComponent<CTransform2D>(Vec2::ZERO(), Deg(30.0f));
+        std::vector<Entity*> bodies;
+        for (int i = 0; i < 100; i++) {
+            Entity& body = entityManager.createEntity("body", &parent);
+            body.addComponent<CTransform2D>(Vec2((float)i, 0.0f), Deg((float)i));
+            body.addComponent<CMovement2D>(Vec2(10.0f, (float)-i), 5.0f);
+            body.addComponent<CGravity2D>(i % 2 ? 1.0f : 0.5f);
+            bodies.push_back(&body);
+        }
+        bodies[0]->getComponent<CMovement2D>()->active = false;
+        scene.addSystem<SGravity>();
+        scene.addSystem<SMovement2D>();
+        scene.update(16.0f);
+
+        float seconds = 0.016f;
+        Vec2 gravityOffset[2] = { rotate(Vec2(0.0f, 2000.0f * 0.5f * seconds), Deg(-30.0f)),
+                                  rotate(Vec2(0.0f, 2000.0f * 1.0f * seconds), Deg(-30.0f)) };
+        for (int i = 0; i < 100; i++) {
+            auto* transform = bodies[i]->getComponent<CTransform2D>();
+            Vec2 velocity(10.0f, (float)-i);
+            Vec2 location((float)i, 0.0f);
+            float rotation = (float)i;
+            if (i != 0) {
+                velocity += gravityOffset[i % 2];
+                location += rotate(velocity * seconds, Deg(-30.0f));
+                rotation += 5.0f * seconds;
+            }
+            EXPECT_NEAR(bodies[i]->getComponent<CMovement2D>()->getVelocity().x, velocity.x, 1e-3f);
+            EXPECT_NEAR(bodies[i]->getComponent<CMovement2D>()->getVelocity().y, velocity.y, 1e-3f);
+            EXPECT_NEAR(transform->getLocation().x, location.x, 1e-3f);
+            EXPECT_NEAR(transform->getLocation().y, location.y, 1e-3f);
+            EXPECT_NEAR(transform->getRotation().get(), rotation, 1e-3f);
+        }
+    }
+}
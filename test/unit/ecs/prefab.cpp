@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+#include <corn/ecs/component.h>
+#include <corn/ecs/entity.h>
+#include <corn/ecs/entity_manager.h>
+#include <corn/ecs/prefab.h>
+#include "dummy_scene.h"
+
+namespace corn::test::prefab {
+    /// @brief A prefab of a root with a transform and movement, and a child with a transform.
+    Prefab createPrefab() {
+        Prefab prefab("bullet");
+        prefab.addComponent<CTransform2D>(Prefab::ROOT, Vec2(1.0f, 2.0f));
+        prefab.addComponent<CMovement2D>(Prefab::ROOT, Vec2(0.0f, -500.0f));
+        size_t trail = prefab.addChild("trail");
+        prefab.addComponent<CTransform2D>(trail, Vec2(0.0f, 10.0f));
+        return prefab;
+    }
+
+    TEST(Prefab, instantiate) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        Prefab prefab = createPrefab();
+        EXPECT_EQ(prefab.size(), 2);
+        EXPECT_THROW(prefab.addChild("invalid", 5), std::out_of_range);
+
+        std::vector<Entity*> roots = prefab.instantiate(entityManager, 100);
+        ASSERT_EQ(roots.size(), 100);
+        EXPECT_EQ(entityManager.getAllEntities().size(), 200);
+        for (Entity* root : roots) {
+            EXPECT_EQ(root->getName(), "bullet");
+            EXPECT_EQ(root->getComponent<CTransform2D>()->getLocation().x, 1.0f);
+            EXPECT_EQ(root->getComponent<CTransform2D>()->getLocation().y, 2.0f);
+            EXPECT_EQ(root->getComponent<CMovement2D>()->getVelocity().x, 0.0f);
+            EXPECT_EQ(root->getComponent<CMovement2D>()->getVelocity().y, -500.0f);
+            std::vector<Entity*> children = root->getChildren();
+            ASSERT_EQ(children.size(), 1);
+            EXPECT_EQ(children[0]->getName(), "trail");
+            EXPECT_EQ(children[0]->getComponent<CTransform2D>()->getLocation().x, 0.0f);
+            EXPECT_EQ(children[0]->getComponent<CTransform2D>()->getLocation().y, 10.0f);
+        }
+
+        Entity& single = prefab.instantiate(entityManager, roots[0]);
+        EXPECT_EQ(single.getParent(), roots[0]);
+    }
+
+    TEST(PrefabPool, recycle) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        PrefabPool pool(createPrefab(), entityManager);
+        pool.reserve(10);
+        EXPECT_EQ(pool.available(), 10);
+        EXPECT_EQ(entityManager.getAllEntities().size(), 20);
+        EXPECT_TRUE(entityManager.getAllActiveEntities().empty());
+
+        // Acquiring reuses the reserved instances
+        Entity& bullet = pool.acquire();
+        EXPECT_EQ(pool.available(), 9);
+        EXPECT_TRUE(bullet.isActiveInWorld());
+        EXPECT_EQ(entityManager.getAllEntities().size(), 20);
+
+        // Released instances are reset in place when acquired again, which observers see as setting the components
+        Entity::EntityID id = bullet.getID();
+        auto* transform = bullet.getComponent<CTransform2D>();
+        transform->setLocation(Vec2(100.0f, 100.0f));
+        bullet.getChildren()[0]->setActive(false);
+        EXPECT_TRUE(pool.release(bullet));
+        EXPECT_FALSE(pool.release(bullet));
+        EXPECT_FALSE(bullet.isActive());
+        int added = 0, removed = 0, set = 0;
+        entityManager.onAdd<CTransform2D>([&added](Entity&, CTransform2D&) { added++; });
+        entityManager.onRemove<CTransform2D>([&removed](Entity&, CTransform2D&) { removed++; });
+        entityManager.onSet<CTransform2D>([&set](Entity&, CTransform2D&) { set++; });
+        auto& query = entityManager.getQuery<With<CTransform2D, CMovement2D>>();
+        size_t matches = query.getEntities().size();
+        entityManager.snapshotTransforms();
+        Entity& reused = pool.acquire();
+        EXPECT_EQ(reused.getID(), id);
+        EXPECT_EQ(reused.getComponent<CTransform2D>(), transform);
+        EXPECT_EQ(transform->getLocation().x, 1.0f);
+        EXPECT_EQ(transform->getLocation().y, 2.0f);
+        EXPECT_EQ(transform->getWorldTransform().first.x, 1.0f);
+        entityManager.setInterpolationAlpha(0.5f);
+        EXPECT_EQ(transform->getRenderTransform().first.x, 1.0f);  // Not interpolated from the released location
+        EXPECT_TRUE(reused.getChildren()[0]->isActive());
+        EXPECT_EQ(added, 0);
+        EXPECT_EQ(removed, 0);
+        EXPECT_EQ(set, 2);
+        EXPECT_EQ(query.getEntities().size(), matches + 1);
+
+        // Components removed from an instance are added back
+        reused.removeComponent<CMovement2D>();
+        pool.release(reused);
+        EXPECT_EQ(&pool.acquire(), &reused);
+        EXPECT_EQ(reused.getComponent<CMovement2D>()->getVelocity().y, -500.0f);
+
+        // Instances destroyed by other means are replaced
+        for (int i = 0; i < 9; i++) {
+            pool.acquire();
+        }
+        EXPECT_EQ(pool.available(), 0);
+        Entity& extra = pool.acquire();
+        EXPECT_EQ(entityManager.getAllEntities().size(), 22);
+        pool.release(extra);
+        extra.destroy();
+        Entity& replacement = pool.acquire();
+        EXPECT_TRUE(replacement.isActive());
+        EXPECT_EQ(entityManager.getAllEntities().size(), 22);
+    }
+}
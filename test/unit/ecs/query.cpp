@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <vector>
+#include <corn/core/scene.h>
+#include <corn/ecs/component.h>
+#include <corn/ecs/entity.h>
+#include <corn/ecs/entity_manager.h>
+#include <corn/ecs/system.h>
+#include "dummy_scene.h"
+
+namespace corn::test::query {
+    bool contains(const QueryBase& query, const Entity* entity) {
+        return std::find(query.begin(), query.end(), entity) != query.end();
+    }
+
+    TEST(Query, tracks_components) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        auto& query = entityManager.getQuery<With<CTransform2D, CMovement2D>, Without<CGravity2D>>();
+        EXPECT_TRUE(query.empty());
+
+        Entity& entity = entityManager.createEntity("entity");
+        entity.addComponent<CTransform2D>(Vec2::ZERO());
+        EXPECT_FALSE(contains(query, &entity));
+        entity.addComponent<CMovement2D>();
+        EXPECT_TRUE(contains(query, &entity));
+        entity.addComponent<CGravity2D>();
+        EXPECT_FALSE(contains(query, &entity));
+        entity.removeComponent<CGravity2D>();
+        EXPECT_TRUE(contains(query, &entity));
+        entity.removeComponent<CTransform2D>();
+        EXPECT_FALSE(contains(query, &entity));
+        EXPECT_TRUE(query.empty());
+    }
+
+    TEST(Query, created_after_entities) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        Entity& entity1 = entityManager.createEntity("entity1");
+        Entity& entity2 = entityManager.createEntity("entity2");
+        entity1.addComponent<CTransform2D>(Vec2::ZERO());
+        entity2.addComponent<CMovement2D>();
+
+        auto& query = entityManager.getQuery<With<CTransform2D>>();
+        EXPECT_EQ(query.size(), 1);
+        EXPECT_TRUE(contains(query, &entity1));
+
+        // Same query object is returned
+        EXPECT_EQ(&entityManager.getQuery<With<CTransform2D>>(), &query);
+    }
+
+    TEST(Query, tracks_active_state) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        auto& query = entityManager.getQuery<With<CTransform2D>>();
+        Entity& parent = entityManager.createEntity("parent");
+        Entity& child = entityManager.createEntity("child", &parent);
+        parent.addComponent<CTransform2D>(Vec2::ZERO());
+        child.addComponent<CTransform2D>(Vec2::ZERO());
+        EXPECT_EQ(query.size(), 2);
+
+        // Deactivating the parent also removes the child
+        parent.setActive(false);
+        EXPECT_TRUE(query.empty());
+
+        // Child is still inactive in the world
+        child.setActive(false);
+        parent.setActive(true);
+        EXPECT_TRUE(contains(query, &parent));
+        EXPECT_FALSE(contains(query, &child));
+        child.setActive(true);
+        EXPECT_TRUE(contains(query, &child));
+    }
+
+    TEST(Query, tracks_destruction) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        auto& query = entityManager.getQuery<With<CTransform2D>>();
+        Entity& parent = entityManager.createEntity("parent");
+        Entity& child = entityManager.createEntity("child", &parent);
+        Entity& other = entityManager.createEntity("other");
+        parent.addComponent<CTransform2D>(Vec2::ZERO());
+        child.addComponent<CTransform2D>(Vec2::ZERO());
+        other.addComponent<CTransform2D>(Vec2::ZERO());
+
+        parent.destroy();
+        EXPECT_EQ(query.size(), 1);
+        EXPECT_TRUE(contains(query, &other));
+
+        entityManager.clear();
+        EXPECT_TRUE(query.empty());
+    }
+
+    /// @brief Records the entities whose transform changed since the previous update.
+    class SWatch : public System {
+    public:
+        std::vector<Entity*> changed;
+
+        explicit SWatch(Scene& scene) : System(scene) {
+            this->reads<CTransform2D>();
+        }
+
+        void update(float) override {
+            auto& query = this->getScene().getEntityManager().getQuery<With<CTransform2D>>();
+            this->changed.clear();
+            for (Entity* entity : query.changedSince<CTransform2D>(this->getLastRunTick())) {
+                this->changed.push_back(entity);
+            }
+        }
+    };
+
+    TEST(Query, change_ticks) {
+        DummyScene scene;
+        EntityManager& entityManager = scene.getEntityManager();
+        Entity& entity1 = entityManager.createEntity("entity1");
+        Entity& entity2 = entityManager.createEntity("entity2");
+        entity1.addComponent<CTransform2D>(Vec2::ZERO());
+        entity2.addComponent<CTransform2D>(Vec2::ZERO());
+        SWatch& watch = *scene.addSystem<SWatch>();
+        EXPECT_EQ(watch.getLastRunTick(), 0);
+
+        // Newly added components count as changed
+        scene.update(16.0f);
+        EXPECT_EQ(watch.changed.size(), 2);
+        EXPECT_GT(watch.getLastRunTick(), 0);
+
+        // Nothing changed since the previous update
+        scene.update(16.0f);
+        EXPECT_TRUE(watch.changed.empty());
+
+        entity2.getComponent<CTransform2D>()->setLocation(Vec2(1.0f, 0.0f));
+        scene.update(16.0f);
+        ASSERT_EQ(watch.changed.size(), 1);
+        EXPECT_EQ(watch.changed[0], &entity2);
+
+        // Writing through the mutable accessor also stamps the component
+        entity1.getComponentMut<CTransform2D>();
+        scene.update(16.0f);
+        ASSERT_EQ(watch.changed.size(), 1);
+        EXPECT_EQ(watch.changed[0], &entity1);
+        const auto* transform = entity1.getComponent<CTransform2D>();
+        EXPECT_TRUE(transform->isChangedSince(transform->getChangeTick()));
+        EXPECT_FALSE(transform->isChangedSince(watch.getLastRunTick()));
+    }
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <corn/core/scene.h>
+#include <corn/ecs/component.h>
+#include <corn/ecs/system.h>
+#include "dummy_scene.h"
+
+namespace corn::test::system {
+    struct CA : public Component {
+        using Component::Component;
+    };
+
+    struct CB : public Component {
+        using Component::Component;
+    };
+
+    /// @brief Records the order of updates.
+    class SRecord : public System {
+    public:
+        SRecord(Scene& scene, std::string name, std::vector<std::string>& log, std::mutex& mutex)
+                : System(scene), name_(std::move(name)), log_(log), mutex_(mutex) {}
+
+        template <ComponentType... T>
+        void declareReads() { this->reads<T...>(); }
+
+        template <ComponentType... T>
+        void declareWrites() { this->writes<T...>(); }
+
+        void update(float) override {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+            this->log_.push_back(this->name_);
+        }
+
+    private:
+        std::string name_;
+        std::vector<std::string>& log_;
+        std::mutex& mutex_;
+    };
+
+    TEST(System, conflicts) {
+        DummyScene scene;
+        std::vector<std::string> log;
+        std::mutex mutex;
+        auto* exclusive = scene.addSystem<SRecord>("exclusive", log, mutex);
+        auto* readA = scene.addSystem<SRecord>("readA", log, mutex);
+        auto* readA2 = scene.addSystem<SRecord>("readA2", log, mutex);
+        auto* writeA = scene.addSystem<SRecord>("writeA", log, mutex);
+        auto* writeB = scene.addSystem<SRecord>("writeB", log, mutex);
+        readA->declareReads<CA>();
+        readA2->declareReads<CA>();
+        writeA->declareWrites<CA>();
+        writeB->declareWrites<CB>();
+
+        EXPECT_TRUE(exclusive->isExclusive());
+        EXPECT_TRUE(exclusive->conflictsWith(*readA));
+        EXPECT_FALSE(readA->conflictsWith(*readA2));
+        EXPECT_TRUE(readA->conflictsWith(*writeA));
+        EXPECT_TRUE(writeA->conflictsWith(*writeA));
+        EXPECT_FALSE(writeA->conflictsWith(*writeB));
+
+        // Transforms and movements are treated as the same resource
+        auto* writeTransform = scene.addSystem<SRecord>("writeTransform", log, mutex);
+        auto* readMovement = scene.addSystem<SRecord>("readMovement", log, mutex);
+        writeTransform->declareWrites<CTransform2D>();
+        readMovement->declareReads<CMovement2D>();
+        EXPECT_TRUE(writeTransform->conflictsWith(*readMovement));
+    }
+
+    TEST(System, conflicting_systems_keep_order) {
+        DummyScene scene;
+        std::vector<std::string> log;
+        std::mutex mutex;
+        scene.addSystem<SRecord>("readA", log, mutex)->declareReads<CA>();
+        scene.addSystem<SRecord>("writeB", log, mutex)->declareWrites<CB>();
+        scene.addSystem<SRecord>("writeA", log, mutex)->declareWrites<CA>();
+        scene.addSystem<SRecord>("exclusive", log, mutex);
+        scene.addSystem<SRecord>("readB", log, mutex)->declareReads<CB>();
+
+        for (bool parallel : { false, true }) {
+            log.clear();
+            scene.setParallel(parallel);
+            scene.update(0.0f);
+            ASSERT_EQ(log.size(), 5);
+            auto position = [&log](const std::string& name) {
+                return std::find(log.begin(), log.end(), name) - log.begin();
+            };
+            EXPECT_LT(position("readA"), position("writeA"));
+            EXPECT_LT(position("writeA"), position("exclusive"));
+            EXPECT_LT(position("writeB"), position("exclusive"));
+            EXPECT_LT(position("exclusive"), position("readB"));
+        }
+    }
+
+    TEST(System, stages_follow_changes) {
+        DummyScene scene;
+        scene.setParallel(true);
+        std::vector<std::string> log;
+        std::mutex mutex;
+        auto* readA = scene.addSystem<SRecord>("readA", log, mutex);
+        auto* writeA = scene.addSystem<SRecord>("writeA", log, mutex);
+        readA->declareReads<CA>();
+        writeA->declareWrites<CA>();
+        scene.update(0.0f);
+        EXPECT_EQ(log, (std::vector<std::string>{ "readA", "writeA" }));
+
+        // The cached stages are rebuilt after the systems change
+        log.clear();
+        readA->setActive(false);
+        scene.update(0.0f);
+        EXPECT_EQ(log, (std::vector<std::string>{ "writeA" }));
+
+        log.clear();
+        readA->setActive(true);
+        auto* writeB = scene.addSystem<SRecord>("writeB", log, mutex);
+        writeB->declareWrites<CB>();
+        EXPECT_TRUE(scene.removeSystem(writeA));
+        scene.update(0.0f);
+        std::sort(log.begin(), log.end());
+        EXPECT_EQ(log, (std::vector<std::string>{ "readA", "writeB" }));
+
+        // Declaring an access later moves the system into a later stage
+        log.clear();
+        writeB->declareReads<CA>();
+        writeB->declareWrites<CA>();
+        scene.update(0.0f);
+        EXPECT_EQ(log, (std::vector<std::string>{ "readA", "writeB" }));
+    }
+}
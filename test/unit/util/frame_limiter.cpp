@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include <corn/util/frame_limiter.h>
+#include <corn/util/stopwatch.h>
+
+namespace corn::test::frame_limiter {
+    TEST(FrameLimiter, paces_frames) {
+        FrameLimiter limiter;
+        Stopwatch stopwatch;
+        limiter.reset();
+        stopwatch.play();
+        for (int i = 0; i < 10; i++) {
+            limiter.wait(10.0f);
+        }
+        // Deadlines do not drift, so 10 frames take 100ms give or take the first frame
+        EXPECT_GE(stopwatch.millis(), 90.0f);
+        EXPECT_LT(stopwatch.millis(), 300.0f);
+    }
+
+    TEST(FrameLimiter, restarts_when_behind) {
+        FrameLimiter limiter(0.0f);
+        EXPECT_FLOAT_EQ(limiter.getSpinThreshold(), 0.0f);
+        limiter.reset();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        // Behind by several frames, so the missed frames are skipped instead of rushed through
+        Stopwatch stopwatch;
+        stopwatch.play();
+        limiter.wait(10.0f);
+        EXPECT_LT(stopwatch.millis(), 5.0f);
+        limiter.wait(10.0f);
+        EXPECT_GE(stopwatch.millis(), 9.0f);
+    }
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include <corn/util/thread_pool.h>
+
+namespace corn::test::thread_pool {
+    TEST(ThreadPool, run) {
+        ThreadPool threadPool(3);
+        std::atomic<int> sum = 0;
+        std::vector<ThreadPool::Task> tasks;
+        for (int i = 1; i <= 100; i++) {
+            tasks.emplace_back([&sum, i]() { sum += i; });
+        }
+        threadPool.run(tasks);
+        EXPECT_EQ(sum, 5050);
+    }
+
+    TEST(ThreadPool, parallel_for) {
+        ThreadPool threadPool(3);
+        std::vector<int> values(1000, 0);
+        threadPool.parallelFor(values.size(), 64, [&values](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                values[i] += (int)i;
+            }
+        });
+        for (size_t i = 0; i < values.size(); i++) {
+            EXPECT_EQ(values[i], (int)i);
+        }
+    }
+
+    TEST(ThreadPool, nested) {
+        ThreadPool threadPool(2);
+        std::atomic<int> count = 0;
+        threadPool.parallelFor(8, 1, [&threadPool, &count](size_t, size_t) {
+            threadPool.parallelFor(8, 1, [&count](size_t, size_t) { count++; });
+        });
+        EXPECT_EQ(count, 64);
+    }
+
+    TEST(ThreadPool, exception) {
+        ThreadPool threadPool(2);
+        std::atomic<int> count = 0;
+        EXPECT_THROW(threadPool.parallelFor(10, 1, [&count](size_t begin, size_t) {
+            count++;
+            if (begin == 5) throw std::runtime_error("error");
+        }), std::runtime_error);
+        // Other chunks are still executed
+        EXPECT_EQ(count, 10);
+    }
+}